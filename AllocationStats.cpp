@@ -0,0 +1,225 @@
+// AllocationStats.cpp
+
+#include "AllocationStats.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+   const char* const typeNames[] = {"CityTour", "SkiTour"};
+
+   static_assert(sizeof(typeNames) / sizeof(typeNames[0])
+         == static_cast<std::size_t>(TrackedType::Count),
+      "Кожен тип повинен мати назву");
+}
+
+const char* AllocationStats::name(TrackedType type)
+{
+   const std::size_t index = static_cast<std::size_t>(type);
+   return index < static_cast<std::size_t>(TrackedType::Count)
+      ? typeNames[index]
+      : "unknown";
+}
+
+#if TOUR_METRICS
+
+namespace
+{
+   thread_local AllocationCounts counts;
+
+   LifecycleCounts& lifecycleOf(TrackedType type)
+   {
+      return counts.lifecycle[static_cast<std::size_t>(type)];
+   }
+
+   void* allocate(std::size_t size)
+   {
+      ++counts.allocations;
+      counts.bytes += size;
+
+      // malloc(0) може повернути nullptr, а operator new — ні.
+      return std::malloc(size == 0 ? 1 : size);
+   }
+
+   void* allocateAligned(std::size_t size, std::size_t alignment)
+   {
+      ++counts.allocations;
+      counts.bytes += size;
+
+#ifdef _WIN32
+      return ::_aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+      void* memory = nullptr;
+      if (::posix_memalign(&memory,
+             alignment < sizeof(void*) ? sizeof(void*) : alignment,
+             size == 0 ? 1 : size) != 0)
+      {
+         return nullptr;
+      }
+      return memory;
+#endif
+   }
+
+   void releaseAligned(void* memory)
+   {
+#ifdef _WIN32
+      ::_aligned_free(memory);
+#else
+      std::free(memory);
+#endif
+   }
+}
+
+AllocationCounts AllocationStats::thisThread()
+{
+   return counts;
+}
+
+void AllocationStats::copied(TrackedType type)
+{
+   ++lifecycleOf(type).copies;
+}
+
+void AllocationStats::moved(TrackedType type)
+{
+   ++lifecycleOf(type).moves;
+}
+
+void AllocationStats::destroyed(TrackedType type)
+{
+   ++lifecycleOf(type).destroyed;
+}
+
+void* operator new(std::size_t size)
+{
+   if (void* memory = allocate(size))
+   {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+   if (void* memory = allocate(size))
+   {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+   return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+   return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+   if (void* memory = allocateAligned(size, static_cast<std::size_t>(alignment)))
+   {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+   if (void* memory = allocateAligned(size, static_cast<std::size_t>(alignment)))
+   {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+   const std::nothrow_t&) noexcept
+{
+   return allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+   const std::nothrow_t&) noexcept
+{
+   return allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+   std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+   releaseAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+   releaseAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+   releaseAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+   releaseAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t,
+   const std::nothrow_t&) noexcept
+{
+   releaseAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t,
+   const std::nothrow_t&) noexcept
+{
+   releaseAligned(memory);
+}
+
+#else
+
+AllocationCounts AllocationStats::thisThread()
+{
+   return {};
+}
+
+#endif
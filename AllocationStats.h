@@ -0,0 +1,83 @@
+// AllocationStats.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// \file AllocationStats.h
+/// \brief Лічильники динамічних виділень пам'яті та життєвого циклу турів.
+///
+/// Облік вмикається тим самим макросом TOUR_METRICS, що й Metrics.h.
+/// З `-DTOUR_METRICS=0` глобальні operator new не замінюються, а хуки
+/// копіювання, переміщення й знищення стають порожніми inline-функціями.
+
+#ifndef TOUR_METRICS
+#define TOUR_METRICS 1
+#endif
+
+/// \brief Типи, для яких рахуються копіювання, переміщення й знищення.
+enum class TrackedType
+{
+   CityTour,
+   SkiTour,
+   Count ///< Кількість типів; не тип.
+};
+
+/// \brief Події життєвого циклу одного типу.
+struct LifecycleCounts
+{
+   std::uint64_t copies = 0;    ///< Копіювальних конструювань.
+   std::uint64_t moves = 0;     ///< Переміщувальних конструювань.
+   std::uint64_t destroyed = 0; ///< Знищених об'єктів.
+};
+
+/// \brief Кількість і загальний розмір виділень та події життєвого циклу.
+struct AllocationCounts
+{
+   std::uint64_t allocations = 0; ///< Викликів operator new.
+   std::uint64_t bytes = 0;       ///< Запитано байтів.
+
+   /// \brief Події за типами, індекс — TrackedType.
+   LifecycleCounts lifecycle[static_cast<std::size_t>(TrackedType::Count)];
+};
+
+/// \class AllocationStats
+/// \brief Лічильники виділень і життєвого циклу поточного потоку.
+/// \details Глобальні operator new замінено в AllocationStats.cpp: кожне
+/// виділення збільшує thread_local лічильники без атомарних операцій.
+/// Конструктори копіювання й переміщення та деструктори турів викликають
+/// хуки copied()/moved()/destroyed(). Різниця двох знімків дає кількість
+/// подій на ділянці коду; Metrics::Scope так приписує їх операціям.
+class AllocationStats
+{
+public:
+   /// \brief Повертає лічильники поточного потоку від його старту.
+   /// \details Без TOUR_METRICS завжди повертає нулі.
+   static AllocationCounts thisThread();
+
+   /// \brief Повертає назву типу для звітів.
+   static const char* name(TrackedType type);
+
+#if TOUR_METRICS
+   /// \brief Фіксує копіювання об'єкта типу.
+   static void copied(TrackedType type);
+
+   /// \brief Фіксує переміщення об'єкта типу.
+   static void moved(TrackedType type);
+
+   /// \brief Фіксує знищення об'єкта типу.
+   static void destroyed(TrackedType type);
+#else
+   static void copied(TrackedType)
+   {
+   }
+
+   static void moved(TrackedType)
+   {
+   }
+
+   static void destroyed(TrackedType)
+   {
+   }
+#endif
+};
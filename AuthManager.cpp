@@ -2,15 +2,163 @@
 
 #include "AuthManager.h"
 #include "FileException.h"
+#include "ThreadPool.h"
+#include "TicketStore.h"
 #include "ValidationException.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <iterator>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+   /// \brief Мінімальна кількість мертвих записів для фонового стиснення.
+   constexpr std::size_t compactMinDead = 256;
+
+   /// \brief Мінімальна пауза між фоновими стисненнями.
+   /// \details Під час зливи входів із міграцією паролів запити стиснення
+   /// накопичуються і виконуються одним проходом.
+   constexpr std::chrono::seconds compactPause(1);
+
+   /// \brief Ім'я має вміщатися в запис квитка без обрізання, інакше
+   /// квитки користувачів зі спільним початком імені змішалися б.
+   bool isValidUsername(const std::string& username)
+   {
+      return !username.empty() && username[0] != '-'
+         && username.size() <= TicketStore::maxUsernameLength
+         && username.find_first_of(":\r\n") == std::string::npos;
+   }
+
+   bool isValidPassword(const std::string& password)
+   {
+      return !password.empty()
+         && password.find_first_of("\r\n") == std::string::npos;
+   }
+
+   /// \brief Скидає буфери файлу на диск.
+   bool syncFile(std::FILE* file)
+   {
+#ifdef _WIN32
+      return ::_commit(::_fileno(file)) == 0;
+#else
+      return ::fdatasync(::fileno(file)) == 0;
+#endif
+   }
+
+   /// \brief Блокування журналу користувачів: fileMutex для потоків цього
+   /// процесу і flock на файлі `<журнал>.lock` для інших процесів.
+   /// \details Блокується окремий файл, а не сам журнал: стиснення підміняє
+   /// журнал через rename, і блокування старого файлу нічого б не захищало.
+   /// Якщо файл блокування не вдається відкрити (каталог лише для читання),
+   /// лишається тільки fileMutex, і compact() тоді журнал не переписує. На
+   /// Windows flock немає: там стиснення покладається на перевірку відбитка
+   /// файлу перед підміною.
+   class JournalLock
+   {
+   public:
+      JournalLock(std::mutex& mutex, const std::string& usersFile)
+         : lock(mutex)
+      {
+#ifndef _WIN32
+         const std::string path = usersFile + ".lock";
+         fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+         if (fd >= 0)
+         {
+            int rc = 0;
+            do
+            {
+               rc = ::flock(fd, LOCK_EX);
+            } while (rc != 0 && errno == EINTR);
+
+            if (rc != 0)
+            {
+               ::close(fd);
+               fd = -1;
+            }
+         }
+#else
+         (void)usersFile;
+#endif
+      }
 
-AuthManager::AuthManager(const std::string& usersFile)
-   : usersFile(usersFile)
+      ~JournalLock()
+      {
+#ifndef _WIN32
+         if (fd >= 0)
+         {
+            // Закриття дескриптора знімає flock.
+            ::close(fd);
+         }
+#endif
+      }
+
+      JournalLock(const JournalLock&) = delete;
+      JournalLock& operator=(const JournalLock&) = delete;
+
+      /// \brief Чи утримується блокування між процесами.
+      bool crossProcess() const
+      {
+         return fd >= 0;
+      }
+
+   private:
+      std::lock_guard<std::mutex> lock;
+      int                         fd = -1;
+   };
+
+   /// \brief Ім'я тимчасового файлу стиснення, окреме для кожного процесу.
+   std::string compactTempPath(const std::string& usersFile)
+   {
+#ifdef _WIN32
+      const long pid = ::_getpid();
+#else
+      const long pid = static_cast<long>(::getpid());
+#endif
+      return usersFile + ".tmp." + std::to_string(pid);
+   }
+}
+
+
+AuthManager::AuthManager(const std::string& usersFile, AuthOptions options)
+   : usersFile(usersFile),
+     hasher(options.hashIterations),
+     tokenSecret(PasswordHasher::randomBytes(32)),
+     verified(options.cacheCapacity, options.cacheTtl),
+     verifyThreads(options.verifyThreads)
+{
+}
+
+AuthManager::~AuthManager()
 {
+   // Перевірки в пулі можуть ще дописати оновлені хеші й запросити стиснення.
+   verifyPool.reset();
+
+   {
+      std::lock_guard<std::mutex> lock(compactMutex);
+      stopping = true;
+   }
+
+   compactWake.notify_all();
+
+   if (compactor.joinable())
+   {
+      compactor.join();
+   }
 }
 
 bool AuthManager::login()
@@ -48,6 +196,51 @@ bool AuthManager::login()
    }
 }
 
+bool AuthManager::authenticate(const std::string& username,
+   const std::string& password) const
+{
+   return authenticateAsync(username, password).get();
+}
+
+std::future<bool> AuthManager::authenticateAsync(const std::string& username,
+   const std::string& password) const
+{
+   std::promise<bool> ready;
+
+   // Невідомий логін і нещодавно перевірений вхід не потребують хешування,
+   // тож відповідь на них готова без черги пулу.
+   try
+   {
+      std::string stored;
+      if (!storedPassword(username, stored))
+      {
+         ready.set_value(false);
+         return ready.get_future();
+      }
+
+      if (verified.contains(credentialToken(username, password), stored))
+      {
+         ready.set_value(true);
+         return ready.get_future();
+      }
+   }
+   catch (...)
+   {
+      ready.set_exception(std::current_exception());
+      return ready.get_future();
+   }
+
+   auto task = std::make_shared<std::packaged_task<bool()>>(
+      [this, username, password]
+      {
+         return validateCredentials(username, password);
+      });
+
+   std::future<bool> result = task->get_future();
+   verifier().submit([task] { (*task)(); });
+   return result;
+}
+
 std::string AuthManager::getCurrentUser() const
 {
    return currentUser;
@@ -58,91 +251,387 @@ bool AuthManager::isAdmin() const
    return currentUser == "admin";
 }
 
-bool AuthManager::validateCredentials(const std::string& login,
-   const std::string& password) const
+AuthManager::FileStamp AuthManager::currentStamp() const
+{
+   FileStamp result;
+   std::error_code ec;
+
+   result.size = std::filesystem::file_size(usersFile, ec);
+   if (ec)
+   {
+      return result;
+   }
+
+   result.modified = std::filesystem::last_write_time(usersFile, ec);
+   result.exists = !ec;
+   return result;
+}
+
+void AuthManager::refreshIndex() const
+{
+   const FileStamp now = currentStamp();
+
+   {
+      std::shared_lock<std::shared_mutex> lock(indexMutex);
+      if (indexed && now == stamp)
+      {
+         return;
+      }
+   }
+
+   std::unique_lock<std::shared_mutex> lock(indexMutex);
+
+   // Поки чекали на блокування, індекс міг перечитати інший потік.
+   if (indexed && currentStamp() == stamp)
+   {
+      return;
+   }
+
+   reloadLocked();
+}
+
+void AuthManager::reloadLocked() const
 {
-   std::ifstream file(usersFile);
+   // Відбиток знімається до читання: зміна під час читання спричинить
+   // повторне перечитування при наступному зверненні.
+   const FileStamp before = currentStamp();
+
+   std::ifstream file(usersFile, std::ios::binary);
    if (!file)
    {
+      indexed = false;
       throw FileException(
          "Не вдалося відкрити файл користувачів: " + usersFile);
    }
 
-   std::string line;
-   while (std::getline(file, line))
+   const std::string content((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+
+   users.clear();
+   records = 0;
+   nextSequence = 0;
+   staleSecrets = 0;
+
+   std::size_t start = 0;
+   while (start < content.size())
    {
+      std::size_t end = content.find('\n', start);
+      const bool terminated = end != std::string::npos;
+      if (!terminated)
+      {
+         end = content.size();
+      }
+
+      std::string line = content.substr(start, end - start);
+      start = end + 1;
+
       if (line.empty())
       {
          continue;
       }
 
-      std::istringstream iss(line);
-      std::string u;
-      std::string p;
+      // Недописаний останній рядок може бути обірваним записом після збою.
+      // Його приймаємо лише як нового користувача (так виглядають файли,
+      // створені вручну), але не як видалення чи зміну пароля.
+      if (!terminated)
+      {
+         const std::size_t pos = line.find(':');
+         if (line[0] == '-' || pos == std::string::npos
+             || users.count(line.substr(0, pos)) != 0)
+         {
+            continue;
+         }
+      }
 
-      if (std::getline(iss, u, ':') && std::getline(iss, p))
+      applyLocked(line);
+   }
+
+   tornTail = !content.empty() && content.back() != '\n';
+   stamp = before;
+   indexed = true;
+}
+
+void AuthManager::applyLocked(const std::string& line) const
+{
+   if (line[0] == '-')
+   {
+      auto removed = users.find(line.substr(1));
+      if (removed != users.end())
       {
-         if (u == login && p == password)
+         if (!PasswordHasher::isHashed(removed->second.password))
          {
-            return true;
+            ++staleSecrets;
          }
+         users.erase(removed);
       }
+
+      ++records;
+      return;
+   }
+
+   auto pos = line.find(':');
+   if (pos == std::string::npos)
+   {
+      return;
    }
 
-   return false;
+   std::string u = line.substr(0, pos);
+   std::string p = line.substr(pos + 1);
+
+   auto it = users.find(u);
+   if (it != users.end())
+   {
+      if (!PasswordHasher::isHashed(it->second.password))
+      {
+         ++staleSecrets;
+      }
+      it->second.password = std::move(p);
+   }
+   else
+   {
+      users.emplace(std::move(u), UserEntry{std::move(p), nextSequence++});
+   }
+
+   ++records;
 }
 
-std::vector<std::string> AuthManager::listUsers() const
+bool AuthManager::storedPassword(const std::string& login,
+   std::string& stored) const
 {
-   std::vector<std::string> out;
+   refreshIndex();
 
-   std::ifstream file(usersFile);
-   if (!file)
+   std::shared_lock<std::shared_mutex> lock(indexMutex);
+   auto it = users.find(login);
+
+   // Порожній пароль ніколи не збігався з введеним, тому такий запис
+   // лише займає логін.
+   if (it == users.end() || it->second.password.empty())
    {
-      throw FileException(
-         "Не вдалося відкрити файл користувачів: " + usersFile);
+      return false;
    }
 
-   std::string line;
-   while (std::getline(file, line))
+   stored = it->second.password;
+   return true;
+}
+
+std::string AuthManager::credentialToken(const std::string& login,
+   const std::string& password) const
+{
+   return PasswordHasher::hmac(tokenSecret,
+      std::to_string(login.size()) + ':' + login + password);
+}
+
+bool AuthManager::validateCredentials(const std::string& login,
+   const std::string& password) const
+{
+   std::string stored;
+   if (!storedPassword(login, stored))
    {
-      if (line.empty())
+      return false;
+   }
+
+   const std::string token = credentialToken(login, password);
+   if (verified.contains(token, stored))
+   {
+      return true;
+   }
+
+   const bool ok = PasswordHasher::isHashed(stored)
+      ? PasswordHasher::verify(stored, password)
+      : PasswordHasher::equalConstantTime(stored, password);
+   if (!ok)
+   {
+      return false;
+   }
+
+   // Відкритий пароль або хеш зі застарілою вартістю оновлюється при
+   // першому успішному вході.
+   if (hasher.needsRehash(stored))
+   {
+      stored = upgradeHash(login, stored, password);
+   }
+
+   verified.remember(token, stored);
+   return true;
+}
+
+std::string AuthManager::upgradeHash(const std::string& login,
+   const std::string& previous,
+   const std::string& password) const
+{
+   const std::string hashed = hasher.hash(password);
+
+   {
+      const JournalLock lock(fileMutex, usersFile);
+
+      try
       {
-         continue;
+         std::string current;
+         if (!storedPassword(login, current) || current != previous)
+         {
+            return previous;
+         }
+
+         appendRecords({login + ':' + hashed});
+      }
+      catch (const FileException& ex)
+      {
+         // Вхід уже перевірено; запис лишиться старим до наступної спроби.
+         std::cerr << ex.what() << "\n";
+         return previous;
       }
+   }
+
+   scheduleCompaction();
+   return hashed;
+}
 
-      auto pos = line.find(':');
-      if (pos != std::string::npos)
+ThreadPool& AuthManager::verifier() const
+{
+   std::call_once(verifyPoolOnce, [this]
+   {
+      std::size_t threads = verifyThreads;
+      if (threads == 0)
       {
-         out.push_back(line.substr(0, pos));
+         threads = std::max(1u, std::thread::hardware_concurrency());
       }
+
+      verifyPool.reset(new ThreadPool(threads));
+   });
+
+   return *verifyPool;
+}
+
+std::vector<std::string> AuthManager::listUsers() const
+{
+   refreshIndex();
+
+   std::vector<std::pair<std::uint64_t, std::string>> ordered;
+
+   {
+      std::shared_lock<std::shared_mutex> lock(indexMutex);
+      ordered.reserve(users.size());
+      for (const auto& user : users)
+      {
+         ordered.emplace_back(user.second.sequence, user.first);
+      }
+   }
+
+   std::sort(ordered.begin(), ordered.end());
+
+   std::vector<std::string> out;
+   out.reserve(ordered.size());
+   for (auto& item : ordered)
+   {
+      out.push_back(std::move(item.second));
    }
 
    return out;
 }
 
+void AuthManager::appendRecords(const std::vector<std::string>& lines) const
+{
+   std::string text;
+
+   {
+      std::shared_lock<std::shared_mutex> lock(indexMutex);
+      if (tornTail)
+      {
+         text += '\n';
+      }
+   }
+
+   for (const auto& line : lines)
+   {
+      text += line;
+      text += '\n';
+   }
+
+   std::FILE* file = std::fopen(usersFile.c_str(), "ab");
+   if (file == nullptr)
+   {
+      throw FileException(
+         "Не вдалося відкрити файл користувачів для запису: " + usersFile);
+   }
+
+   bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size()
+      && std::fflush(file) == 0 && syncFile(file);
+   ok = std::fclose(file) == 0 && ok;
+
+   std::unique_lock<std::shared_mutex> lock(indexMutex);
+
+   if (!ok)
+   {
+      // Невідомо, яка частина дійшла до файлу, тож індекс перечитується.
+      indexed = false;
+      throw FileException(
+         "Не вдалося записати файл користувачів: " + usersFile);
+   }
+
+   for (const auto& line : lines)
+   {
+      applyLocked(line);
+   }
+
+   tornTail = false;
+   stamp = currentStamp();
+}
+
 bool AuthManager::addUser(const std::string& username,
    const std::string& password)
 {
-   auto users = listUsers();
+   if (!isValidUsername(username) || !isValidPassword(password))
+   {
+      std::cout << "Некоректний логін або пароль.\n";
+      return false;
+   }
+
+   const std::string hashed = hasher.hash(password);
+
+   const JournalLock lock(fileMutex, usersFile);
+   refreshIndex();
 
-   for (const auto& u : users)
    {
-      if (u == username)
+      std::shared_lock<std::shared_mutex> indexLock(indexMutex);
+      if (users.count(username) != 0)
       {
          std::cout << "Користувач з таким логіном вже існує.\n";
          return false;
       }
    }
 
-   std::ofstream file(usersFile, std::ios::app);
-   if (!file)
+   appendRecords({username + ':' + hashed});
+   return true;
+}
+
+bool AuthManager::changePassword(const std::string& username,
+   const std::string& password)
+{
+   if (!isValidPassword(password))
    {
-      throw FileException(
-         "Не вдалося відкрити файл користувачів для запису: " + usersFile);
+      std::cout << "Некоректний пароль.\n";
+      return false;
    }
 
-   file << username << ':' << password << '\n';
+   const std::string hashed = hasher.hash(password);
+
+   {
+      const JournalLock lock(fileMutex, usersFile);
+      refreshIndex();
+
+      {
+         std::shared_lock<std::shared_mutex> indexLock(indexMutex);
+         if (users.count(username) == 0)
+         {
+            std::cout << "Користувача не знайдено.\n";
+            return false;
+         }
+      }
+
+      appendRecords({username + ':' + hashed});
+   }
+
+   scheduleCompaction();
    return true;
 }
 
@@ -154,57 +643,186 @@ bool AuthManager::deleteUser(const std::string& username)
       return false;
    }
 
-   std::ifstream file(usersFile);
-   if (!file)
+   if (deleteUsers({username}) == 0)
    {
-      throw FileException(
-         "Не вдалося відкрити файл користувачів: " + usersFile);
+      std::cout << "Користувача не знайдено.\n";
+      return false;
    }
 
+   return true;
+}
+
+std::size_t AuthManager::deleteUsers(const std::vector<std::string>& usernames)
+{
    std::vector<std::string> lines;
-   std::string line;
-   bool found = false;
 
-   while (std::getline(file, line))
    {
-      if (line.empty())
-      {
-         continue;
-      }
+      const JournalLock lock(fileMutex, usersFile);
+      refreshIndex();
 
-      auto pos = line.find(':');
-      if (pos != std::string::npos)
       {
-         std::string u = line.substr(0, pos);
-         if (u == username)
+         std::shared_lock<std::shared_mutex> indexLock(indexMutex);
+         std::unordered_set<std::string> seen;
+
+         for (const auto& username : usernames)
          {
-            found = true;
-            continue;
+            if (username == "admin" || users.count(username) == 0
+                || !seen.insert(username).second)
+            {
+               continue;
+            }
+
+            lines.push_back('-' + username);
          }
       }
 
-      lines.push_back(line);
+      if (lines.empty())
+      {
+         return 0;
+      }
+
+      appendRecords(lines);
    }
 
-   file.close();
+   scheduleCompaction();
+   return lines.size();
+}
+
+bool AuthManager::compact() const
+{
+   const JournalLock lock(fileMutex, usersFile);
 
-   if (!found)
+#ifndef _WIN32
+   // Без блокування між процесами чужий дописаний запис міг би зникнути
+   // під час підміни файлу.
+   if (!lock.crossProcess())
    {
-      std::cout << "Користувача не знайдено.\n";
       return false;
    }
+#endif
 
-   std::ofstream out(usersFile, std::ios::trunc);
-   if (!out)
+   try
    {
-      throw FileException(
-         "Не вдалося відкрити файл користувачів для запису: " + usersFile);
+      refreshIndex();
+   }
+   catch (const FileException&)
+   {
+      return false;
+   }
+
+   std::vector<std::pair<std::uint64_t, std::string>> ordered;
+   FileStamp source;
+
+   {
+      std::shared_lock<std::shared_mutex> indexLock(indexMutex);
+      source = stamp;
+      ordered.reserve(users.size());
+      for (const auto& user : users)
+      {
+         ordered.emplace_back(user.second.sequence,
+            user.first + ':' + user.second.password + '\n');
+      }
+   }
+
+   std::sort(ordered.begin(), ordered.end());
+
+   const std::string tempPath = compactTempPath(usersFile);
+   std::FILE* out = std::fopen(tempPath.c_str(), "wb");
+   if (out == nullptr)
+   {
+      return false;
+   }
+
+   bool ok = true;
+   for (const auto& item : ordered)
+   {
+      const std::string& line = item.second;
+      ok = ok && std::fwrite(line.data(), 1, line.size(), out) == line.size();
+   }
+
+   ok = ok && std::fflush(out) == 0 && syncFile(out);
+   ok = std::fclose(out) == 0 && ok;
+
+   // Процес, що не бере блокування (скажімо, ручне редагування), міг
+   // змінити журнал після читання: тоді стиснення відкладається.
+   ok = ok && currentStamp() == source;
+
+   std::error_code ec;
+   if (ok)
+   {
+      std::filesystem::rename(tempPath, usersFile, ec);
    }
 
-   for (const auto& l : lines)
+   if (!ok || ec)
    {
-      out << l << '\n';
+      std::remove(tempPath.c_str());
+      return false;
    }
 
+   std::unique_lock<std::shared_mutex> indexLock(indexMutex);
+   records = users.size();
+   staleSecrets = 0;
+   tornTail = false;
+   stamp = currentStamp();
    return true;
 }
+
+void AuthManager::scheduleCompaction() const
+{
+   {
+      std::shared_lock<std::shared_mutex> indexLock(indexMutex);
+      const std::size_t live = users.size();
+      const std::size_t dead = records - std::min(records, live);
+
+      // Витіснений відкритий пароль не повинен лишатися у файлі, тож такий
+      // журнал стискається незалежно від кількості мертвих записів.
+      if (staleSecrets == 0 && (dead < compactMinDead || dead < live))
+      {
+         return;
+      }
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(compactMutex);
+      if (stopping)
+      {
+         return;
+      }
+
+      compactRequested = true;
+      if (!compactor.joinable())
+      {
+         compactor = std::thread(&AuthManager::compactorLoop, this);
+      }
+   }
+
+   compactWake.notify_one();
+}
+
+void AuthManager::compactorLoop() const
+{
+   std::unique_lock<std::mutex> lock(compactMutex);
+
+   while (true)
+   {
+      compactWake.wait(lock, [this] { return stopping || compactRequested; });
+
+      // Запит, поставлений до зупинки, ще виконується.
+      if (!compactRequested)
+      {
+         return;
+      }
+
+      compactRequested = false;
+      lock.unlock();
+
+      if (!compact())
+      {
+         std::cerr << "Не вдалося стиснути файл користувачів: "
+                   << usersFile << "\n";
+      }
+
+      lock.lock();
+      compactWake.wait_for(lock, compactPause, [this] { return stopping; });
+   }
+}
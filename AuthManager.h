@@ -1,21 +1,88 @@
 #pragma once
 
+#include "PasswordHasher.h"
+#include "VerificationCache.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+class ThreadPool;
+
+/// \brief Параметри перевірки паролів.
+struct AuthOptions
+{
+ unsigned             hashIterations = PasswordHasher::defaultIterations; ///< Вартість PBKDF2 для нових хешів.
+ std::size_t          cacheCapacity = 4096;          ///< Скільки перевірених входів пам'ятати.
+ std::chrono::seconds cacheTtl = std::chrono::minutes(10); ///< Скільки довіряти перевіреному входу.
+ std::size_t          verifyThreads = 0;             ///< Потоки перевірки; 0 — за кількістю ядер.
+};
+
 /// \brief Клас для авторизації та керування користувачами.
+/// \details Користувачі тримаються в хеш-індексі в пам'яті, тож вхід і
+/// перевірка дублікатів виконуються за O(1). Перед кожним зверненням індекс
+/// звіряє розмір і час зміни файлу та перечитує його лише тоді, коли файл
+/// змінили ззовні. Методи безпечні для одночасного виклику з кількох потоків.
+///
+/// Файл користувачів — журнал: рядок `логін:пароль` додає користувача або
+/// змінює його пароль, рядок `-логін` видаляє користувача. Зміни лише
+/// дописуються в кінець, а коли мертвих записів стає більше, ніж живих,
+/// фоновий потік переписує журнал у новий файл і атомарно підміняє старий.
+///
+/// Паролі зберігаються як солені хеші PBKDF2 (див. PasswordHasher). Записи
+/// з відкритим паролем залишаються дійсними і переписуються хешем під час
+/// першого успішного входу. Щоб злива входів не впиралася в обчислення
+/// хешів, успішні перевірки кешуються (VerificationCache), а самі обчислення
+/// виконує окремий пул потоків обмеженого розміру.
 class AuthManager
 {
 public:
  /// \brief Створює менеджер з файлом користувачів.
  /// \param usersFile Шлях до файлу з користувачами.
- explicit AuthManager(const std::string& usersFile = "data/users.txt");
+ /// \param options Параметри перевірки паролів.
+ explicit AuthManager(const std::string& usersFile = "data/users.txt",
+     AuthOptions options = {});
+
+ /// \brief Дочікується завершення перевірок і фонового стиснення журналу.
+ ~AuthManager();
+
+ AuthManager(const AuthManager&) = delete;
+ AuthManager& operator=(const AuthManager&) = delete;
 
  /// \brief Виконує вхід користувача.
  /// \return true, якщо автентифікація успішна, інакше false.
  /// \throws ValidationException У разі некоректного введення облікових даних.
  bool login();
 
+ /// \brief Перевіряє облікові дані без консольного введення.
+ /// \details Не змінює поточного користувача; використовується пакетним
+ /// режимом та іншими неінтерактивними клієнтами.
+ /// \param username Логін користувача.
+ /// \param password Пароль користувача.
+ /// \return true, якщо облікові дані коректні, інакше false.
+ /// \throws FileException Якщо файл користувачів не вдається відкрити.
+ bool authenticate(const std::string& username,
+     const std::string& password) const;
+
+ /// \brief Перевіряє облікові дані в пулі потоків перевірки.
+ /// \details Викликач не блокується на обчисленні хешу; нещодавно
+ /// перевірені облікові дані повертають готовий результат одразу.
+ /// \param username Логін користувача.
+ /// \param password Пароль користувача.
+ /// \return Майбутній результат; get() кидає FileException, якщо файл недоступний.
+ std::future<bool> authenticateAsync(const std::string& username,
+     const std::string& password) const;
+
  /// \brief Повертає логін поточного користувача.
  /// \return Логін поточного користувача або порожній рядок, якщо вхід не виконано.
  std::string getCurrentUser() const;
@@ -29,6 +96,8 @@ public:
  std::vector<std::string> listUsers() const;
 
  /// \brief Додає нового користувача.
+ /// \details Логін не може бути порожнім, починатися з '-', містити ':'
+ /// чи бути довшим за TicketStore::maxUsernameLength байтів.
  /// \param username Логін нового користувача.
  /// \param password Пароль нового користувача.
  /// \return true, якщо користувача додано, інакше false (логін уже існує).
@@ -39,9 +108,122 @@ public:
  /// \return true, якщо користувача видалено, інакше false (не знайдено або admin).
  bool deleteUser(const std::string& username);
 
+ /// \brief Видаляє кількох користувачів одним записом у журнал.
+ /// \details Відсутні логіни та admin пропускаються.
+ /// \param usernames Логіни користувачів, яких потрібно видалити.
+ /// \return Кількість видалених користувачів.
+ std::size_t deleteUsers(const std::vector<std::string>& usernames);
+
+ /// \brief Змінює пароль існуючого користувача.
+ /// \param username Логін користувача.
+ /// \param password Новий пароль.
+ /// \return true, якщо пароль змінено, інакше false (не знайдено або некоректний пароль).
+ bool changePassword(const std::string& username, const std::string& password);
+
+ /// \brief Переписує журнал користувачів без мертвих записів.
+ /// \details Новий файл пишеться поруч і підміняє старий через rename, тож
+ /// збій під час стиснення не втрачає облікових записів. Дописування і
+ /// стиснення з різних процесів впорядковуються блокуванням файлу
+ /// `<журнал>.lock`; якщо журнал змінився в обхід блокування, стиснення
+ /// скасовується.
+ /// \return true, якщо журнал успішно переписано.
+ bool compact() const;
+
 private:
- std::string usersFile;
- std::string currentUser;
+ /// \brief Відбиток стану файлу користувачів на момент читання.
+ struct FileStamp
+ {
+  bool                            exists = false;
+  std::uintmax_t                  size = 0;
+  std::filesystem::file_time_type modified{};
+
+  bool operator==(const FileStamp& other) const
+  {
+   return exists == other.exists && size == other.size
+    && modified == other.modified;
+  }
+ };
+
+ /// \brief Живий запис користувача в індексі.
+ struct UserEntry
+ {
+  std::string   password;
+  std::uint64_t sequence = 0; ///< Порядок додавання; задає порядок у списку.
+ };
+
+ std::string    usersFile;
+ std::string    currentUser;
+ PasswordHasher hasher;
+ std::string    tokenSecret; ///< Випадковий секрет процесу для токенів кешу.
+
+ mutable VerificationCache verified;
+
+ mutable std::shared_mutex                          indexMutex;
+ mutable std::unordered_map<std::string, UserEntry> users;
+ mutable FileStamp                                  stamp;
+ mutable bool                                       indexed = false;
+ mutable std::size_t                                records = 0;   ///< Записів у журналі.
+ mutable std::uint64_t                              nextSequence = 0;
+ mutable std::size_t                                staleSecrets = 0; ///< Мертвих записів з відкритим паролем.
+ mutable bool                                       tornTail = false; ///< Файл не закінчується '\n'.
+
+ mutable std::mutex fileMutex; ///< Впорядковує дописування і стиснення журналу в процесі.
+
+ mutable std::thread             compactor;
+ mutable std::mutex              compactMutex;
+ mutable std::condition_variable compactWake;
+ mutable bool                    compactRequested = false;
+ bool                            stopping = false;
+
+ std::size_t                         verifyThreads;
+ mutable std::once_flag              verifyPoolOnce;
+ mutable std::unique_ptr<ThreadPool> verifyPool;
+
+ /// \brief Знімає відбиток поточного стану файлу користувачів.
+ FileStamp currentStamp() const;
+
+ /// \brief Перечитує файл у індекс, якщо той змінився з останнього читання.
+ /// \throws FileException Якщо файл користувачів не вдається відкрити.
+ void refreshIndex() const;
+
+ /// \brief Перечитує файл у індекс; викликається під ексклюзивним блокуванням.
+ /// \throws FileException Якщо файл користувачів не вдається відкрити.
+ void reloadLocked() const;
+
+ /// \brief Застосовує один запис журналу до індексу.
+ /// \param line Рядок журналу без символу кінця рядка.
+ void applyLocked(const std::string& line) const;
+
+ /// \brief Дописує готові рядки журналу і застосовує їх до індексу.
+ /// \details Викликається під fileMutex і блокуванням файлу журналу.
+ /// \throws FileException Якщо файл не вдається відкрити або записати.
+ void appendRecords(const std::vector<std::string>& lines) const;
+
+ /// \brief Будить фоновий потік стиснення, якщо мертвих записів забагато.
+ void scheduleCompaction() const;
+
+ /// \brief Цикл фонового потоку стиснення.
+ void compactorLoop() const;
+
+ /// \brief Обчислює токен облікових даних для кешу перевірок.
+ std::string credentialToken(const std::string& login,
+     const std::string& password) const;
+
+ /// \brief Повертає поле пароля користувача або false, якщо його немає.
+ bool storedPassword(const std::string& login, std::string& stored) const;
+
+ /// \brief Переписує поле пароля хешем з поточною вартістю.
+ /// \details Виконується лише якщо поле не змінилося після перевірки.
+ /// \param login Логін користувача.
+ /// \param previous Поле пароля, проти якого виконано перевірку.
+ /// \param password Перевірений пароль.
+ /// \return Нове поле пароля або previous, якщо запис не оновлено.
+ std::string upgradeHash(const std::string& login,
+     const std::string& previous,
+     const std::string& password) const;
+
+ /// \brief Повертає пул потоків перевірки, створюючи його при першому виклику.
+ ThreadPool& verifier() const;
 
  /// \brief Перевіряє коректність облікових даних користувача.
  /// \param login Логін користувача.
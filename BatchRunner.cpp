@@ -0,0 +1,960 @@
+// BatchRunner.cpp
+
+#include "BatchRunner.h"
+#include "CityTour.h"
+#include "SkiTour.h"
+#include "FileException.h"
+#include "Metrics.h"
+#include "ReportFormat.h"
+
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> tokenize(const std::string& line)
+{
+   std::vector<std::string> tokens;
+   std::string current;
+   bool hasToken = false;
+   bool quoted = false;
+
+   for (std::size_t i = 0; i < line.size(); ++i)
+   {
+      const char ch = line[i];
+
+      if (quoted)
+      {
+         if (ch == '\\' && i + 1 < line.size())
+         {
+            current += line[++i];
+         }
+         else if (ch == '"')
+         {
+            quoted = false;
+         }
+         else
+         {
+            current += ch;
+         }
+         continue;
+      }
+
+      if (ch == '"')
+      {
+         quoted = true;
+         hasToken = true;
+      }
+      else if (ch == ' ' || ch == '\t' || ch == '\r')
+      {
+         if (hasToken)
+         {
+            tokens.push_back(current);
+            current.clear();
+            hasToken = false;
+         }
+      }
+      else if (ch == '#' && !hasToken)
+      {
+         break;
+      }
+      else
+      {
+         current += ch;
+         hasToken = true;
+      }
+   }
+
+   if (hasToken)
+   {
+      tokens.push_back(current);
+   }
+
+   return tokens;
+}
+
+void writeJsonNumber(std::ostream& out, double value)
+{
+   char buffer[32];
+   std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+   out << buffer;
+}
+
+void beginResponse(std::ostream& out, std::size_t lineNumber,
+   const std::string& op, bool ok)
+{
+   out << "{\"n\":" << lineNumber << ",\"op\":";
+   writeJsonString(out, op);
+   out << ",\"ok\":" << (ok ? "true" : "false");
+}
+
+bool fail(std::ostream& out, std::size_t lineNumber, const std::string& op,
+   const char* error, const std::string& message)
+{
+   beginResponse(out, lineNumber, op, false);
+   out << ",\"error\":\"" << error << "\",\"message\":";
+   writeJsonString(out, message);
+   out << "}\n";
+   return false;
+}
+
+bool fail(std::ostream& out, std::size_t lineNumber, const std::string& op,
+   const Error& error)
+{
+   const char* code = "invalid_argument";
+
+   if (error.code == ErrorCode::NotFound)
+   {
+      code = "not_found";
+   }
+   else if (error.code == ErrorCode::IoError)
+   {
+      code = "io_error";
+   }
+   else if (error.code == ErrorCode::SoldOut)
+   {
+      code = "sold_out";
+   }
+   else if (error.code == ErrorCode::Conflict)
+   {
+      code = "conflict";
+   }
+
+   return fail(out, lineNumber, op, code, error.message);
+}
+
+bool parseId(const std::string& text, TourId& id)
+{
+   if (text.empty())
+   {
+      return false;
+   }
+
+   for (unsigned char ch : text)
+   {
+      if (ch < '0' || ch > '9')
+      {
+         return false;
+      }
+   }
+
+   try
+   {
+      id = static_cast<TourId>(std::stoull(text));
+   }
+   catch (...)
+   {
+      return false;
+   }
+
+   return true;
+}
+
+bool parseDouble(const std::string& text, double& value)
+{
+   try
+   {
+      std::size_t pos = 0;
+      value = std::stod(text, &pos);
+      return pos == text.size();
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool parseInt(const std::string& text, int& value)
+{
+   try
+   {
+      std::size_t pos = 0;
+      value = std::stoi(text, &pos);
+      return pos == text.size();
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool parseBool(const std::string& text, bool& value)
+{
+   if (text == "1" || text == "true")
+   {
+      value = true;
+      return true;
+   }
+
+   if (text == "0" || text == "false")
+   {
+      value = false;
+      return true;
+   }
+
+   return false;
+}
+
+bool parsePatch(const std::vector<std::string>& tokens, std::size_t start,
+   TourPatch& patch, std::string& error)
+{
+   for (std::size_t i = start; i < tokens.size(); ++i)
+   {
+      const std::string& token = tokens[i];
+      const auto eq = token.find('=');
+
+      if (eq == std::string::npos)
+      {
+         error = "Очікувалося поле у форматі key=value: " + token;
+         return false;
+      }
+
+      const std::string key = token.substr(0, eq);
+      const std::string value = token.substr(eq + 1);
+
+      if (key == "country")
+      {
+         patch.country = value;
+      }
+      else if (key == "city" || key == "resort")
+      {
+         patch.city = value;
+      }
+      else if (key == "departureDate")
+      {
+         patch.departureDate = value;
+      }
+      else if (key == "returnDate")
+      {
+         patch.returnDate = value;
+      }
+      else if (key == "hotelLevel" || key == "difficulty")
+      {
+         patch.hotelLevel = value;
+      }
+      else if (key == "accommodation")
+      {
+         patch.accommodation = value;
+      }
+      else if (key == "transport")
+      {
+         patch.transport = value;
+      }
+      else if (key == "food")
+      {
+         patch.food = value;
+      }
+      else if (key == "extras")
+      {
+         patch.extras = value;
+      }
+      else if (key == "price")
+      {
+         double price = 0.0;
+         if (!parseDouble(value, price))
+         {
+            error = "Некоректна ціна: " + value;
+            return false;
+         }
+         patch.price = price;
+      }
+      else if (key == "capacity")
+      {
+         int capacity = 0;
+         if (!parseInt(value, capacity) || capacity < 0)
+         {
+            error = "Некоректна кількість місць: " + value;
+            return false;
+         }
+         patch.capacity = capacity;
+      }
+      else if (key == "equipment" || key == "insurance")
+      {
+         bool flag = false;
+         if (!parseBool(value, flag))
+         {
+            error = "Очікувалося 1/0 або true/false: " + token;
+            return false;
+         }
+
+         if (key == "equipment")
+         {
+            patch.equipmentIncluded = flag;
+         }
+         else
+         {
+            patch.insuranceIncluded = flag;
+         }
+      }
+      else
+      {
+         error = "Невідоме поле туру: " + key;
+         return false;
+      }
+   }
+
+   return true;
+}
+
+bool parseQuery(const std::vector<std::string>& tokens, TourQuery& query)
+{
+   if (tokens.size() < 2)
+   {
+      return false;
+   }
+
+   const std::string& kind = tokens[1];
+
+   if (kind == "all" && tokens.size() == 2)
+   {
+      query = TourQuery::all();
+   }
+   else if (kind == "country" && tokens.size() == 3)
+   {
+      query = TourQuery::byCountry(tokens[2]);
+   }
+   else if (kind == "city" && tokens.size() == 3)
+   {
+      query = TourQuery::byCity(tokens[2]);
+   }
+   else if (kind == "dates" && tokens.size() == 4)
+   {
+      query = TourQuery::byDateRange(tokens[2], tokens[3]);
+   }
+   else if (kind == "level" && tokens.size() == 3)
+   {
+      query = TourQuery::byHotelLevel(tokens[2]);
+   }
+   else if (kind == "maxprice" && tokens.size() == 3)
+   {
+      double maxPrice = 0.0;
+      if (!parseDouble(tokens[2], maxPrice))
+      {
+         return false;
+      }
+      query = TourQuery::byMaxPrice(maxPrice);
+   }
+   else
+   {
+      return false;
+   }
+
+   return true;
+}
+
+void writeTour(std::ostream& out, TourId id, const Tour& tour,
+   const SeatInventory::Counts& seats)
+{
+   out << "{\"id\":" << id << ",\"type\":"
+       << (dynamic_cast<const SkiTour*>(&tour) != nullptr
+              ? "\"ski\"" : "\"city\"")
+       << ",\"country\":";
+   writeJsonString(out, tour.getCountry());
+   out << ",\"city\":";
+   writeJsonString(out, tour.getCity());
+   out << ",\"departureDate\":";
+   writeJsonString(out, tour.getDepartureDate());
+   out << ",\"returnDate\":";
+   writeJsonString(out, tour.getReturnDate());
+   out << ",\"hotelLevel\":";
+   writeJsonString(out, tour.getHotelLevel());
+   out << ",\"price\":";
+   writeJsonNumber(out, tour.getPrice());
+   out << ",\"capacity\":" << seats.capacity
+       << ",\"available\":" << seats.available;
+   out << ",\"csv\":";
+   writeJsonString(out, tour.toCSV());
+   out << '}';
+}
+}
+
+BatchRunner::BatchRunner(TourManager& tourManager, const AuthManager& auth)
+   : tourManager(tourManager),
+     auth(auth)
+{
+}
+
+std::size_t BatchRunner::run(std::istream& in, std::ostream& out)
+{
+   std::size_t failures = 0;
+   std::string line;
+
+   while (std::getline(in, line))
+   {
+      if (!execute(line, out))
+      {
+         ++failures;
+      }
+   }
+
+   out.flush();
+   return failures;
+}
+
+bool BatchRunner::execute(const std::string& line, std::ostream& out)
+{
+   ++lineNumber;
+
+   const std::vector<std::string> tokens = tokenize(line);
+   if (tokens.empty())
+   {
+      return true;
+   }
+
+   try
+   {
+      return executeTokens(tokens, out);
+   }
+   catch (const std::exception& ex)
+   {
+      return fail(out, lineNumber, tokens[0], "internal", ex.what());
+   }
+}
+
+bool BatchRunner::executeTokens(const std::vector<std::string>& tokens,
+   std::ostream& out)
+{
+   const std::string& op = tokens[0];
+
+   if (op == "login")
+   {
+      if (tokens.size() != 3)
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: login <user> <password>");
+      }
+
+      try
+      {
+         if (!auth.authenticate(tokens[1], tokens[2]))
+         {
+            currentUser.clear();
+            return fail(out, lineNumber, op, "unauthorized",
+               "Невірний логін або пароль.");
+         }
+      }
+      catch (const FileException& ex)
+      {
+         return fail(out, lineNumber, op, "io_error", ex.what());
+      }
+
+      currentUser = tokens[1];
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"user\":";
+      writeJsonString(out, currentUser);
+      out << "}\n";
+      return true;
+   }
+
+   if (currentUser.empty())
+   {
+      return fail(out, lineNumber, op, "unauthorized",
+         "Спочатку виконайте login.");
+   }
+
+   const bool isAdmin = currentUser == "admin";
+   const bool adminOnly =
+      op == "load" || op == "save" || op == "add"
+      || op == "edit" || op == "delete" || op == "import"
+      || op == "metrics" || op == "memory"
+      || (op == "tickets" && tokens.size() > 1);
+
+   if (adminOnly && !isAdmin)
+   {
+      return fail(out, lineNumber, op, "forbidden",
+         "Команда доступна лише адміністратору.");
+   }
+
+   if (op == "load" || op == "save")
+   {
+      try
+      {
+         if (op == "load")
+         {
+            tourManager.load();
+         }
+         else
+         {
+            tourManager.save();
+         }
+      }
+      catch (const FileException& ex)
+      {
+         return fail(out, lineNumber, op, "io_error", ex.what());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"count\":" << tourManager.size() << "}\n";
+      return true;
+   }
+
+   if (op == "memory")
+   {
+      const MemoryReport report = tourManager.memoryReport();
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"totalBytes\":" << report.totalBytes() << ",\"components\":{";
+      for (std::size_t i = 0; i < report.components.size(); ++i)
+      {
+         const MemoryComponent& component = report.components[i];
+         out << (i == 0 ? "" : ",");
+         writeJsonString(out, component.name);
+         out << ":{\"items\":" << component.items
+             << ",\"bytes\":" << component.bytes << '}';
+      }
+
+      // Поля, які займають набагато більше за свої дані, перелічуються
+      // окремо: це перші кандидати на компактніше представлення.
+      std::vector<std::string> flagged;
+
+      out << "},\"types\":{";
+      for (std::size_t i = 0; i < report.types.size(); ++i)
+      {
+         const TypeMemory& type = report.types[i];
+         out << (i == 0 ? "" : ",");
+         writeJsonString(out, type.name);
+         out << ":{\"objects\":" << type.objects
+             << ",\"objectBytes\":" << type.objectBytes
+             << ",\"controlBlockBytes\":" << type.controlBlockBytes
+             << ",\"heapBytes\":" << type.heapBytes()
+             << ",\"fields\":{";
+
+         for (std::size_t j = 0; j < type.fields.size(); ++j)
+         {
+            const FieldMemory& field = type.fields[j];
+            out << (j == 0 ? "" : ",");
+            writeJsonString(out, field.name);
+            out << ":{\"payloadBytes\":" << field.payloadBytes
+                << ",\"inlineBytes\":" << field.inlineBytes
+                << ",\"heapBytes\":" << field.heapBytes
+                << ",\"heapBlocks\":" << field.heapBlocks
+                << ",\"highOverhead\":"
+                << (field.highOverhead() ? "true" : "false") << '}';
+
+            if (field.highOverhead())
+            {
+               flagged.push_back(type.name + '.' + field.name);
+            }
+         }
+         out << "}}";
+      }
+
+      out << "},\"highOverhead\":[";
+      for (std::size_t i = 0; i < flagged.size(); ++i)
+      {
+         out << (i == 0 ? "" : ",");
+         writeJsonString(out, flagged[i]);
+      }
+      out << "]}\n";
+      return true;
+   }
+
+   if (op == "metrics")
+   {
+      if (tokens.size() > 2 || (tokens.size() == 2 && tokens[1] != "reset"))
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: metrics [reset]");
+      }
+
+      // Звіт знімається до скидання, тож `metrics reset` повертає
+      // статистику за інтервал, що завершився.
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"metrics\":";
+      Metrics::writeJson(out);
+      out << "}\n";
+
+      if (tokens.size() == 2)
+      {
+         Metrics::reset();
+      }
+      return true;
+   }
+
+   if (op == "query")
+   {
+      TourQuery query;
+      if (!parseQuery(tokens, query))
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: query all|country <x>|city <x>|"
+            "dates <from> <to>|level <x>|maxprice <n>");
+      }
+
+      const std::vector<TourId> ids = tourManager.findTours(query);
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"count\":" << ids.size() << ",\"ids\":[";
+      for (std::size_t i = 0; i < ids.size(); ++i)
+      {
+         if (i != 0)
+         {
+            out << ',';
+         }
+         out << ids[i];
+      }
+      out << "]}\n";
+      return true;
+   }
+
+   if (op == "sort")
+   {
+      if (tokens.size() != 2 || (tokens[1] != "price" && tokens[1] != "date"))
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: sort price|date");
+      }
+
+      Result<void> sorted = tourManager.sortTours(
+         tokens[1] == "price" ? SortKey::Price : SortKey::DepartureDate);
+      if (!sorted.ok())
+      {
+         return fail(out, lineNumber, op, sorted.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << "}\n";
+      return true;
+   }
+
+   if (op == "add")
+   {
+      if (tokens.size() < 2 || (tokens[1] != "city" && tokens[1] != "ski"))
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: add city|ski key=value ...");
+      }
+
+      TourPatch fields;
+      std::string error;
+      if (!parsePatch(tokens, 2, fields, error))
+      {
+         return fail(out, lineNumber, op, "invalid_argument", error);
+      }
+
+      Result<TourId> created = tourManager.createTour(
+         tokens[1] == "city" ? TourKind::City : TourKind::Ski, fields);
+      if (!created.ok())
+      {
+         return fail(out, lineNumber, op, created.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << created.value() << "}\n";
+      return true;
+   }
+
+   if (op == "import")
+   {
+      if (tokens.size() != 2)
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: import <tickets.txt>");
+      }
+
+      Result<std::size_t> imported = tourManager.importTickets(tokens[1]);
+      if (!imported.ok())
+      {
+         return fail(out, lineNumber, op, imported.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"count\":" << imported.value() << "}\n";
+      return true;
+   }
+
+   if (op == "group")
+   {
+      std::vector<BookingItem> items;
+
+      for (std::size_t i = 1; i < tokens.size(); ++i)
+      {
+         const std::string& token = tokens[i];
+         const auto times = token.find('x');
+
+         BookingItem item;
+         int seats = 1;
+         if (!parseId(token.substr(0, times), item.tourId)
+             || (times != std::string::npos
+                 && (!parseInt(token.substr(times + 1), seats) || seats <= 0)))
+         {
+            return fail(out, lineNumber, op, "invalid_argument",
+               "Очікувалося <id> або <id>x<місць>: " + token);
+         }
+
+         item.seats = static_cast<std::uint32_t>(seats);
+         items.push_back(item);
+      }
+
+      if (items.empty())
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: group <id>[x<місць>] ...");
+      }
+
+      Result<std::vector<Ticket>> booked =
+         tourManager.bookGroup(currentUser, std::move(items));
+      if (!booked.ok())
+      {
+         return fail(out, lineNumber, op, booked.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"count\":" << booked.value().size() << ",\"tickets\":[";
+      for (std::size_t i = 0; i < booked.value().size(); ++i)
+      {
+         const Ticket& ticket = booked.value()[i];
+         out << (i != 0 ? ",{\"id\":" : "{\"id\":") << ticket.tourId
+             << ",\"seats\":" << ticket.seats << ",\"price\":";
+         writeJsonNumber(out, ticket.price);
+         out << '}';
+      }
+      out << "]}\n";
+      return true;
+   }
+
+   if (op == "tickets")
+   {
+      if (tokens.size() == 1)
+      {
+         const std::vector<Ticket> booked =
+            tourManager.userTickets(currentUser);
+
+         beginResponse(out, lineNumber, op, true);
+         out << ",\"count\":" << booked.size() << ",\"tickets\":[";
+         for (std::size_t i = 0; i < booked.size(); ++i)
+         {
+            out << (i != 0 ? ",{\"id\":" : "{\"id\":") << booked[i].tourId
+                << ",\"price\":";
+            writeJsonNumber(out, booked[i].price);
+            out << ",\"bookedAt\":" << booked[i].bookedAt << '}';
+         }
+         out << "]}\n";
+         return true;
+      }
+
+      TourId tourId = 0;
+      if (tokens.size() != 2 || !parseId(tokens[1], tourId))
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: tickets [<id>]");
+      }
+
+      const std::vector<Ticket> booked = tourManager.tourTickets(tourId);
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << tourId
+          << ",\"seatsSold\":" << tourManager.seatsSold(tourId)
+          << ",\"count\":" << booked.size() << ",\"users\":[";
+      for (std::size_t i = 0; i < booked.size(); ++i)
+      {
+         if (i != 0)
+         {
+            out << ',';
+         }
+         writeJsonString(out, booked[i].username);
+      }
+      out << "]}\n";
+      return true;
+   }
+
+   TourId id = 0;
+   if (op == "get" || op == "edit" || op == "delete" || op == "book"
+       || op == "cancel" || op == "wait" || op == "unwait" || op == "waitlist")
+   {
+      if (tokens.size() < 2 || !parseId(tokens[1], id))
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Очікувався ID туру.");
+      }
+   }
+
+   if (op == "get")
+   {
+      Result<std::shared_ptr<const Tour>> tour = tourManager.getTour(id);
+      Result<SeatInventory::Counts> seats = tourManager.getSeats(id);
+      if (!tour.ok() || !seats.ok())
+      {
+         return fail(out, lineNumber, op,
+            tour.ok() ? seats.error() : tour.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"tour\":";
+      writeTour(out, id, *tour.value(), seats.value());
+      out << "}\n";
+      return true;
+   }
+
+   if (op == "edit")
+   {
+      TourPatch patch;
+      std::string error;
+      if (!parsePatch(tokens, 2, patch, error))
+      {
+         return fail(out, lineNumber, op, "invalid_argument", error);
+      }
+
+      Result<void> updated = tourManager.updateTour(id, patch);
+      if (!updated.ok())
+      {
+         return fail(out, lineNumber, op, updated.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << id << "}\n";
+      return true;
+   }
+
+   if (op == "delete")
+   {
+      Result<void> removed = tourManager.removeTour(id);
+      if (!removed.ok())
+      {
+         return fail(out, lineNumber, op, removed.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << id << "}\n";
+      return true;
+   }
+
+   if (op == "book")
+   {
+      std::string key;
+      if (tokens.size() == 3 && tokens[2].rfind("key=", 0) == 0)
+      {
+         key = tokens[2].substr(4);
+      }
+      else if (tokens.size() != 2)
+      {
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: book <id> [key=<ключ>]");
+      }
+
+      bool replayed = false;
+      Result<Ticket> booked =
+         tourManager.bookTour(currentUser, id, key, &replayed);
+      if (!booked.ok())
+      {
+         return fail(out, lineNumber, op, booked.error());
+      }
+
+      const Ticket& ticket = booked.value();
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << ticket.tourId << ",\"user\":";
+      writeJsonString(out, ticket.username);
+      out << ",\"price\":";
+      writeJsonNumber(out, ticket.price);
+      out << ",\"bookedAt\":" << ticket.bookedAt;
+      if (replayed)
+      {
+         out << ",\"replayed\":true";
+      }
+      out << "}\n";
+      return true;
+   }
+
+   if (op == "cancel")
+   {
+      Result<Ticket> cancelled = tourManager.cancelBooking(currentUser, id);
+      if (!cancelled.ok())
+      {
+         return fail(out, lineNumber, op, cancelled.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << id << ",\"seats\":" << cancelled.value().seats
+          << "}\n";
+      return true;
+   }
+
+   if (op == "wait")
+   {
+      int seats = 1;
+      int priority = 0;
+
+      for (std::size_t i = 2; i < tokens.size(); ++i)
+      {
+         const std::string& token = tokens[i];
+
+         if (token.rfind("seats=", 0) == 0
+             && parseInt(token.substr(6), seats) && seats > 0)
+         {
+            continue;
+         }
+
+         if (token.rfind("priority=", 0) == 0
+             && parseInt(token.substr(9), priority))
+         {
+            if (!isAdmin)
+            {
+               return fail(out, lineNumber, op, "forbidden",
+                  "Пріоритет у черзі задає лише адміністратор.");
+            }
+            continue;
+         }
+
+         return fail(out, lineNumber, op, "invalid_argument",
+            "Використання: wait <id> [seats=<n>] [priority=<n>]");
+      }
+
+      Result<WaitlistEntry> joined = tourManager.joinWaitlist(currentUser, id,
+         static_cast<std::uint32_t>(seats), priority);
+      if (!joined.ok())
+      {
+         return fail(out, lineNumber, op, joined.error());
+      }
+
+      // Позиція 0 означає, що заявку вже обслуговано з вільних місць.
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << id << ",\"position\":"
+          << tourManager.waitlistPosition(currentUser, id) << "}\n";
+      return true;
+   }
+
+   if (op == "unwait")
+   {
+      Result<void> left = tourManager.leaveWaitlist(currentUser, id);
+      if (!left.ok())
+      {
+         return fail(out, lineNumber, op, left.error());
+      }
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << id << "}\n";
+      return true;
+   }
+
+   if (op == "waitlist")
+   {
+      const std::vector<WaitlistEntry> queue = tourManager.waitlistFor(id);
+
+      beginResponse(out, lineNumber, op, true);
+      out << ",\"id\":" << id << ",\"count\":" << queue.size()
+          << ",\"position\":" << tourManager.waitlistPosition(currentUser, id);
+
+      if (isAdmin)
+      {
+         out << ",\"users\":[";
+         for (std::size_t i = 0; i < queue.size(); ++i)
+         {
+            if (i != 0)
+            {
+               out << ',';
+            }
+            writeJsonString(out, queue[i].username);
+         }
+         out << ']';
+      }
+      out << "}\n";
+      return true;
+   }
+
+   return fail(out, lineNumber, op, "unknown_command",
+      "Невідома команда: " + op);
+}
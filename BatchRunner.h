@@ -0,0 +1,75 @@
+// BatchRunner.h
+#pragma once
+
+#include "AuthManager.h"
+#include "TourManager.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// \file BatchRunner.h
+/// \brief Неінтерактивний пакетний режим виконання команд над каталогом.
+
+/// \class BatchRunner
+/// \brief Виконує сценарій команд без меню та виводить результати у JSON Lines.
+/// \details Кожен непорожній рядок сценарію — одна команда; `#` починає коментар.
+/// Значення з пробілами беруться в подвійні лапки. Підтримувані команди:
+/// - `login <user> <password>`
+/// - `load`, `save` (лише admin)
+/// - `query all|country <x>|city <x>|dates <from> <to>|level <x>|maxprice <n>`
+/// - `get <id>`
+/// - `sort price|date`
+/// - `add city|ski key=value ...` (лише admin; `capacity=N` задає кількість місць)
+/// - `edit <id> key=value ...` (лише admin)
+/// - `delete <id>` (лише admin)
+/// - `book <id> [key=<ключ>]` — з ключем повторний запит не дублює квиток
+/// - `group <id>[x<місць>] ...` — бронювання кількох турів як одне ціле
+/// - `cancel <id>` — скасувати власний квиток на тур
+/// - `wait <id> [seats=<n>] [priority=<n>]`, `unwait <id>`, `waitlist <id>` —
+///   черга очікування (пріоритет задає лише admin)
+/// - `tickets` — власні квитки; `tickets <id>` — квитки туру (лише admin)
+/// - `import <tickets.txt>` — імпорт текстових квитків (лише admin)
+/// - `metrics [reset]` — лічильники й гістограми затримок операцій,
+///   з `reset` статистика після звіту обнуляється (лише admin)
+/// - `memory` — оцінка пам'яті каталогу за складовими, типами турів і
+///   полями; поля з великими накладними витратами позначаються (лише admin)
+///
+/// На кожну команду виводиться рівно один рядок JSON з полями
+/// `n` (номер рядка), `op`, `ok` та результатом або `error`/`message`.
+class BatchRunner
+{
+public:
+   /// \brief Створює виконавця над спільним каталогом.
+   /// \param tourManager Каталог турів.
+   /// \param auth Менеджер користувачів для перевірки облікових даних.
+   BatchRunner(TourManager& tourManager, const AuthManager& auth);
+
+   /// \brief Виконує всі команди з потоку.
+   /// \param in Потік команд.
+   /// \param out Потік для результатів.
+   /// \return Кількість команд, що завершилися помилкою.
+   std::size_t run(std::istream& in, std::ostream& out);
+
+   /// \brief Виконує одну команду.
+   /// \param line Рядок команди.
+   /// \param out Потік для результату.
+   /// \return false, якщо команда завершилася помилкою.
+   bool execute(const std::string& line, std::ostream& out);
+
+   /// \brief Повертає ім'я користувача, під яким виконується сценарій.
+   const std::string& user() const
+   {
+      return currentUser;
+   }
+
+private:
+   TourManager&       tourManager;
+   const AuthManager& auth;
+   std::string        currentUser;
+   std::size_t        lineNumber = 0;
+
+   bool executeTokens(const std::vector<std::string>& tokens,
+      std::ostream& out);
+};
@@ -0,0 +1,516 @@
+// Benchmark.cpp
+
+#include "Benchmark.h"
+#include "AllocationStats.h"
+#include "AuthManager.h"
+#include "CityTour.h"
+#include "CsvScanner.h"
+#include "DataGenerator.h"
+#include "FileException.h"
+#include "Metrics.h"
+#include "ReportFormat.h"
+#include "SkiTour.h"
+#include "TourManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <utility>
+
+namespace
+{
+   using Clock = std::chrono::steady_clock;
+
+   /// \brief Верхня межа вимірювань, щоб швидкі випадки не росли без кінця.
+   constexpr std::size_t maxSamples = 1000;
+
+   /// \brief Скільки рядків брати для розбору й серіалізації CSV.
+   constexpr std::size_t parseSample = 10000;
+
+   /// \brief Приймач результатів, які інакше ніде не використовуються:
+   /// запис у volatile не дає оптимізатору викинути виміряну роботу.
+   volatile std::size_t sink = 0;
+
+   std::string compilerName()
+   {
+#if defined(__clang__)
+      return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+      return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+      return "msvc " + std::to_string(_MSC_VER);
+#else
+      return "unknown";
+#endif
+   }
+
+   /// \brief Виконує випадки й записує результати у JSON-масив.
+   class Runner
+   {
+   public:
+      Runner(const BenchOptions& options, std::ostream& out)
+         : options(options),
+           out(out)
+      {
+      }
+
+      /// \brief Вимірює один випадок.
+      /// \param name Назва випадку.
+      /// \param rows Розмір каталогу.
+      /// \param opsPerSample Скільки операцій виконує одне вимірювання.
+      /// \param setup Підготовка перед кожним вимірюванням (не вимірюється).
+      /// \param body Вимірювана дія.
+      template <typename Setup, typename Body>
+      void measure(const std::string& name, std::size_t rows,
+         std::size_t opsPerSample, Setup setup, Body body)
+      {
+         if (!options.filter.empty()
+             && name.find(options.filter) == std::string::npos)
+         {
+            return;
+         }
+
+         std::cerr << "Бенчмарк " << name << " (" << rows << " рядків)...\n";
+
+         failed = 0;
+         std::vector<double> perOp;
+         AllocationCounts allocated;
+         std::uint64_t copies = 0;
+         std::uint64_t moves = 0;
+         double totalNs = 0.0;
+
+         const Clock::time_point deadline = Clock::now()
+            + std::chrono::duration_cast<Clock::duration>(
+                 std::chrono::duration<double>(options.secondsPerCase));
+
+         while (perOp.size() < options.minSamples
+                || (perOp.size() < maxSamples && Clock::now() < deadline))
+         {
+            setup();
+
+            const AllocationCounts before = AllocationStats::thisThread();
+            const Clock::time_point start = Clock::now();
+            body();
+            const Clock::time_point finish = Clock::now();
+            const AllocationCounts after = AllocationStats::thisThread();
+
+            allocated.allocations += after.allocations - before.allocations;
+            allocated.bytes += after.bytes - before.bytes;
+
+            for (std::size_t type = 0;
+                 type < static_cast<std::size_t>(TrackedType::Count); ++type)
+            {
+               copies += after.lifecycle[type].copies
+                  - before.lifecycle[type].copies;
+               moves += after.lifecycle[type].moves
+                  - before.lifecycle[type].moves;
+            }
+
+            const double ns =
+               std::chrono::duration<double, std::nano>(finish - start).count();
+            totalNs += ns;
+            perOp.push_back(ns / static_cast<double>(opsPerSample));
+         }
+
+         std::sort(perOp.begin(), perOp.end());
+         const double ops =
+            static_cast<double>(perOp.size() * opsPerSample);
+
+         out << (first ? "\n    " : ",\n    ") << "{\"name\":";
+         writeJsonString(out, name);
+         out << ",\"rows\":" << rows
+             << ",\"samples\":" << perOp.size()
+             << ",\"opsPerSample\":" << opsPerSample
+             << ",\"opsPerSecond\":" << (totalNs > 0.0 ? ops * 1e9 / totalNs : 0.0)
+             << ",\"nsPerOp\":{\"min\":" << perOp.front()
+             << ",\"p50\":" << percentile(perOp, 0.50)
+             << ",\"p90\":" << percentile(perOp, 0.90)
+             << ",\"p99\":" << percentile(perOp, 0.99)
+             << ",\"max\":" << perOp.back()
+             << "},\"allocationsPerOp\":"
+             << static_cast<double>(allocated.allocations) / ops
+             << ",\"bytesPerOp\":"
+             << static_cast<double>(allocated.bytes) / ops
+             << ",\"tourCopiesPerOp\":" << static_cast<double>(copies) / ops
+             << ",\"tourMovesPerOp\":" << static_cast<double>(moves) / ops
+             << ",\"failedOps\":" << failed
+             << '}';
+         out.flush();
+
+         first = false;
+      }
+
+      template <typename Body>
+      void measure(const std::string& name, std::size_t rows,
+         std::size_t opsPerSample, Body body)
+      {
+         measure(name, rows, opsPerSample, [] {}, std::move(body));
+      }
+
+      /// \brief Рахує операцію поточного випадку, що повернула помилку.
+      /// \details Випадок, у якому операції не вдаються, міряє інший шлях
+      /// коду, ніж заявлено; звіт показує це полем failedOps.
+      void fail()
+      {
+         ++failed;
+      }
+
+   private:
+      const BenchOptions& options;
+      std::ostream&       out;
+      bool                first = true;
+      std::uint64_t       failed = 0;
+   };
+
+   /// \brief Рядки tours.csv, розділені на тип і поле data.
+   struct CsvRows
+   {
+      std::vector<std::string> city;
+      std::vector<std::string> ski;
+   };
+
+   CsvRows readRows(const std::string& path, std::size_t limit)
+   {
+      std::ifstream file(path);
+      if (!file)
+      {
+         throw FileException("Не вдалося відкрити файл турів: " + path);
+      }
+
+      CsvRows rows;
+      std::string line;
+      std::getline(file, line);
+
+      while (std::getline(file, line)
+             && (rows.city.size() < limit || rows.ski.size() < limit))
+      {
+         // type,id,capacity,sold,data
+         std::size_t pos = 0;
+         for (int i = 0; i < 4 && pos != std::string::npos; ++i)
+         {
+            pos = line.find(',', pos == 0 ? 0 : pos + 1);
+         }
+
+         if (pos == std::string::npos)
+         {
+            continue;
+         }
+
+         std::vector<std::string>& target =
+            line.compare(0, 4, "ski,") == 0 ? rows.ski : rows.city;
+         if (target.size() < limit)
+         {
+            target.push_back(line.substr(pos + 1));
+         }
+      }
+
+      return rows;
+   }
+}
+
+Benchmark::Benchmark(BenchOptions options)
+   : options(std::move(options))
+{
+}
+
+std::string Benchmark::prepare(std::size_t rows) const
+{
+   const std::string directory =
+      options.directory + "/rows-" + std::to_string(rows);
+   const std::string marker = directory + "/generated.txt";
+   const std::string expected =
+      std::to_string(rows) + ' ' + std::to_string(options.seed);
+
+   {
+      std::ifstream existing(marker);
+      std::string content;
+      if (existing && std::getline(existing, content) && content == expected)
+      {
+         return directory;
+      }
+   }
+
+   std::error_code ec;
+   std::filesystem::create_directories(directory, ec);
+   if (ec)
+   {
+      throw FileException("Не вдалося створити каталог: " + directory);
+   }
+
+   std::cerr << "Генерація каталогу на " << rows << " рядків...\n";
+
+   GeneratorOptions generator;
+   generator.directory = directory;
+   generator.tours = rows;
+   generator.users = 1000;
+   generator.tickets = 0;
+   generator.sessions = 0;
+   generator.seed = options.seed;
+   DataGenerator(generator).run();
+
+   std::ofstream(marker) << expected << '\n';
+   return directory;
+}
+
+void Benchmark::run(std::ostream& out)
+{
+   out << "{\n  \"seed\":" << options.seed << ",\n  \"build\":{\"compiler\":";
+   writeJsonString(out, compilerName());
+#ifdef NDEBUG
+   out << ",\"ndebug\":true";
+#else
+   out << ",\"ndebug\":false";
+#endif
+#ifdef __OPTIMIZE__
+   out << ",\"optimize\":true";
+#else
+   out << ",\"optimize\":false";
+#endif
+   out << ",\"metrics\":" << (Metrics::enabled ? "true" : "false");
+   out << ",\"csvScanner\":\"" << CsvScanner::implementation() << '"';
+   out << "},\n  \"results\":[";
+
+   Runner runner(options, out);
+
+   for (std::size_t rows : options.sizes)
+   {
+      const std::string directory = prepare(rows);
+      const std::string toursPath = directory + "/tours.csv";
+
+      std::unique_ptr<TourManager> loading;
+      runner.measure("load", rows, 1,
+         [&]
+         {
+            loading.reset();
+            loading.reset(new TourManager(toursPath,
+               directory + "/load-tickets.bin",
+               directory + "/load-waitlist.log"));
+         },
+         [&] { loading->load(); });
+      loading.reset();
+
+      // Збереження переписує власну копію, щоб не чіпати згенерований файл.
+      const std::string savePath = directory + "/save.csv";
+      std::filesystem::copy_file(toursPath, savePath,
+         std::filesystem::copy_options::overwrite_existing);
+
+      // Квитки попередніх запусків зайняли б місця, і бронювання міряло б
+      // відмову SoldOut замість запису квитка.
+      const std::string ticketsPath = directory + "/bench-tickets.bin";
+      const std::string waitlistPath = directory + "/bench-waitlist.log";
+      std::error_code ec;
+      std::filesystem::remove(ticketsPath, ec);
+      std::filesystem::remove(waitlistPath, ec);
+
+      TourManager catalog(savePath, ticketsPath, waitlistPath);
+      catalog.load();
+
+      runner.measure("save", rows, 1, [&] { catalog.save(); });
+
+      const std::pair<const char*, TourQuery> queries[] =
+      {
+         {"search_country", TourQuery::byCountry("Italy")},
+         {"search_city", TourQuery::byCity("Rome")},
+         {"search_dates", TourQuery::byDateRange("2025-07-01", "2025-07-31")},
+         {"filter_level", TourQuery::byHotelLevel("4*")},
+         {"filter_maxprice", TourQuery::byMaxPrice(500.0)}
+      };
+
+      for (const auto& query : queries)
+      {
+         runner.measure(query.first, rows, 1,
+            [&] { catalog.findTours(query.second); });
+      }
+
+      runner.measure("sort_price", rows, 1,
+         [&] { catalog.sortTours(SortKey::DepartureDate); },
+         [&] { catalog.sortTours(SortKey::Price); });
+
+      runner.measure("sort_date", rows, 1,
+         [&] { catalog.sortTours(SortKey::Price); },
+         [&] { catalog.sortTours(SortKey::DepartureDate); });
+
+      // Бронювання йде через журнал квитків із fsync на кожну групу,
+      // тож вимірює повний шлях до диска. Квитки вимірювання скасовуються
+      // перед наступним (поза виміром), щоб місця не закінчувалися.
+      const std::vector<TourId> ids = catalog.findTours(TourQuery::all());
+      constexpr std::size_t bookings = 100;
+      std::size_t nextBooking = 0;
+      std::vector<TourId> booked;
+
+      runner.measure("book", rows, bookings,
+         [&]
+         {
+            for (TourId id : booked)
+            {
+               catalog.cancelBooking("bench", id);
+            }
+            booked.clear();
+         },
+         [&]
+         {
+            for (std::size_t i = 0; i < bookings; ++i)
+            {
+               if (ids.empty())
+               {
+                  runner.fail();
+                  continue;
+               }
+
+               const std::size_t index =
+                  (nextBooking++ * 2654435761ULL) % ids.size();
+               if (catalog.bookTour("bench", ids[index]).ok())
+               {
+                  booked.push_back(ids[index]);
+               }
+               else
+               {
+                  runner.fail();
+               }
+            }
+         });
+
+      // Одна «операція» — один байт файлу: opsPerSecond тут — байти за
+      // секунду розбиття на рядки й поля без побудови турів.
+      {
+         std::ifstream file(toursPath, std::ios::binary);
+         const std::string content((std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>());
+         std::size_t fields = 0;
+
+         runner.measure("scan_csv", rows,
+            std::max<std::size_t>(content.size(), 1),
+            [&]
+            {
+               CsvScanner scanner(content.data(), content.size());
+               CsvRow row;
+               while (scanner.next(row))
+               {
+                  fields += row.size();
+               }
+            });
+
+         sink = fields;
+      }
+
+      const CsvRows csv = readRows(toursPath, parseSample);
+
+      if (!csv.city.empty())
+      {
+         runner.measure("parse_city", rows, csv.city.size(),
+            [&]
+            {
+               for (const std::string& line : csv.city)
+               {
+                  CityTour tour(line);
+               }
+            });
+      }
+
+      if (!csv.ski.empty())
+      {
+         runner.measure("parse_ski", rows, csv.ski.size(),
+            [&]
+            {
+               for (const std::string& line : csv.ski)
+               {
+                  SkiTour tour(line);
+               }
+            });
+      }
+
+      std::vector<std::shared_ptr<const CityTour>> cityTours;
+      std::vector<std::shared_ptr<const SkiTour>> skiTours;
+
+      {
+         const std::shared_ptr<const CatalogSnapshot> snapshot =
+            catalog.snapshot();
+         for (const CatalogEntry& entry : snapshot->tours().values())
+         {
+            if (auto city =
+                   std::dynamic_pointer_cast<const CityTour>(entry.tour))
+            {
+               if (cityTours.size() < parseSample)
+               {
+                  cityTours.push_back(std::move(city));
+               }
+            }
+            else if (auto ski =
+                        std::dynamic_pointer_cast<const SkiTour>(entry.tour))
+            {
+               if (skiTours.size() < parseSample)
+               {
+                  skiTours.push_back(std::move(ski));
+               }
+            }
+         }
+      }
+
+      std::size_t written = 0;
+
+      if (!cityTours.empty())
+      {
+         runner.measure("tocsv_city", rows, cityTours.size(),
+            [&]
+            {
+               for (const auto& tour : cityTours)
+               {
+                  written += tour->toCSV().size();
+               }
+            });
+      }
+
+      if (!skiTours.empty())
+      {
+         runner.measure("tocsv_ski", rows, skiTours.size(),
+            [&]
+            {
+               for (const auto& tour : skiTours)
+               {
+                  written += tour->toCSV().size();
+               }
+            });
+      }
+
+      // Перевірка паролів іде по копії файлу користувачів: перший вхід
+      // переписує відкритий пароль хешем.
+      const std::string usersPath = directory + "/bench-users.txt";
+      std::filesystem::copy_file(directory + "/users.txt", usersPath,
+         std::filesystem::copy_options::overwrite_existing);
+
+      {
+         AuthManager cached(usersPath);
+         cached.authenticate("user1", "pw1");
+
+         constexpr std::size_t logins = 1000;
+         runner.measure("auth_cached", rows, logins,
+            [&]
+            {
+               for (std::size_t i = 0; i < logins; ++i)
+               {
+                  cached.authenticate("user1", "pw1");
+               }
+            });
+      }
+
+      {
+         AuthOptions uncached;
+         uncached.cacheCapacity = 0;
+         AuthManager hashing(usersPath, uncached);
+         hashing.authenticate("user1", "pw1");
+
+         runner.measure("auth_hash", rows, 1,
+            [&] { hashing.authenticate("user1", "pw1"); });
+      }
+
+      sink = written;
+   }
+
+   out << "\n  ]\n}\n";
+   out.flush();
+}
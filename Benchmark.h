@@ -0,0 +1,55 @@
+// Benchmark.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// \file Benchmark.h
+/// \brief Мікробенчмарки основних операцій каталогу.
+
+/// \brief Параметри запуску бенчмарків.
+struct BenchOptions
+{
+   std::string              directory = "bench"; ///< Каталог для згенерованих даних.
+   std::vector<std::size_t> sizes{10000};         ///< Розміри каталогів у рядках.
+   std::uint64_t            seed = 1;             ///< Зерно генератора даних.
+   double                   secondsPerCase = 1.0; ///< Бюджет часу на один випадок.
+   std::size_t              minSamples = 5;       ///< Мінімум вимірювань на випадок.
+   std::string              filter;               ///< Запускати лише випадки з цим підрядком.
+};
+
+/// \class Benchmark
+/// \brief Вимірює швидкодію load/save, пошуку, фільтрів, сортування,
+/// бронювання, розбиття CSV на поля (у байтах за секунду), розбору й
+/// серіалізації CSV та перевірки паролів.
+/// \details Для кожного розміру каталог генерується через DataGenerator
+/// (і повторно використовується, якщо вже згенерований з тим самим зерном).
+/// Кожен випадок виконується щонайменше minSamples разів і доки не вичерпано
+/// бюджет часу. Результат — JSON з пропускною здатністю, перцентилями часу
+/// однієї операції, кількістю виділень пам'яті та копіювань і переміщень
+/// турів на операцію (рахуються на потоці вимірювання, див. AllocationStats;
+/// у збірці з `-DTOUR_METRICS=0` — нулі) і кількістю операцій, що повернули
+/// помилку (failedOps). Бронювання щоразу починає з порожнього журналу
+/// квитків, а квитки кожного вимірювання скасовуються перед наступним.
+class Benchmark
+{
+public:
+   /// \brief Створює набір бенчмарків.
+   /// \param options Параметри запуску.
+   explicit Benchmark(BenchOptions options);
+
+   /// \brief Виконує всі випадки.
+   /// \param out Потік для JSON-звіту; результати дописуються в міру готовності.
+   /// \throws FileException Якщо дані не вдається згенерувати чи прочитати.
+   void run(std::ostream& out);
+
+private:
+   BenchOptions options;
+
+   /// \brief Генерує каталог потрібного розміру, якщо його ще немає.
+   /// \return Каталог із файлами даних.
+   std::string prepare(std::size_t rows) const;
+};
@@ -0,0 +1,311 @@
+// BookingLedger.cpp
+
+#include "BookingLedger.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+BookingLedger::BookingLedger(std::string path, LedgerOptions options)
+   : filePath(std::move(path)),
+     options(options),
+     lastSync(std::chrono::steady_clock::now())
+{
+   if (this->options.maxBatch == 0)
+   {
+      this->options.maxBatch = 1;
+   }
+
+   writer = std::thread(&BookingLedger::writerLoop, this);
+}
+
+BookingLedger::~BookingLedger()
+{
+   {
+      std::lock_guard<std::mutex> lock(wakeMutex);
+      stopping = true;
+   }
+
+   writerWake.notify_one();
+   writer.join();
+}
+
+Result<void> BookingLedger::append(const TicketRecord& record)
+{
+   return append(&record, 1);
+}
+
+Result<void> BookingLedger::append(const TicketRecord* records,
+   std::size_t count)
+{
+   Request request;
+   request.bytes.assign(reinterpret_cast<const char*>(records),
+      count * sizeof(TicketRecord));
+
+   Result<void> written = submit(request);
+   if (written.ok())
+   {
+      Metrics::bytesWritten(request.bytes.size());
+   }
+
+   return written;
+}
+
+Result<void> BookingLedger::submit(Request& request)
+{
+   Request* previous = head.load(std::memory_order_relaxed);
+   do
+   {
+      request.next = previous;
+   }
+   while (!head.compare_exchange_weak(previous, &request,
+             std::memory_order_release, std::memory_order_relaxed));
+
+   // Будити потік журналу потрібно лише тому, хто поклав перший запис
+   // у порожню чергу; решта потрапить у ту саму групу.
+   if (previous == nullptr)
+   {
+      std::lock_guard<std::mutex> lock(wakeMutex);
+      writerWake.notify_one();
+   }
+
+   std::unique_lock<std::mutex> lock(wakeMutex);
+   doneWake.wait(lock,
+      [&request] { return request.done.load(std::memory_order_acquire); });
+
+   if (request.failed)
+   {
+      return Error{ErrorCode::IoError,
+         "Помилка запису у файл " + filePath + "."};
+   }
+
+   return {};
+}
+
+void BookingLedger::writerLoop()
+{
+   while (true)
+   {
+      Request* batch = head.exchange(nullptr, std::memory_order_acquire);
+      if (batch != nullptr)
+      {
+         writeBatch(batch);
+         continue;
+      }
+
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      const auto hasWork = [this]
+      {
+         return stopping || head.load(std::memory_order_relaxed) != nullptr;
+      };
+
+      if (stopping && head.load(std::memory_order_relaxed) == nullptr)
+      {
+         break;
+      }
+
+      if (unsynced)
+      {
+         const auto due = lastSync + options.syncInterval;
+         if (!writerWake.wait_until(lock, due, hasWork))
+         {
+            lock.unlock();
+            syncFile();
+         }
+         continue;
+      }
+
+      writerWake.wait(lock, hasWork);
+   }
+
+   if (file != nullptr)
+   {
+      if (unsynced)
+      {
+         syncFile();
+      }
+      std::fclose(file);
+      file = nullptr;
+   }
+}
+
+void BookingLedger::writeBatch(Request* batch)
+{
+   // Черга — стек, тому розвертаємо її, щоб записати в порядку надходження.
+   std::vector<Request*> requests;
+   for (Request* request = batch; request != nullptr; request = request->next)
+   {
+      requests.push_back(request);
+   }
+
+   for (std::size_t end = requests.size(); end > 0;)
+   {
+      const std::size_t begin =
+         end > options.maxBatch ? end - options.maxBatch : 0;
+
+      buffer.clear();
+      for (std::size_t i = end; i > begin; --i)
+      {
+         buffer += requests[i - 1]->bytes;
+      }
+
+      bool ok = file != nullptr || openFile();
+      if (ok)
+      {
+         ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size()
+            && std::fflush(file) == 0;
+      }
+
+      if (ok)
+      {
+         unsynced = true;
+
+         const auto now = std::chrono::steady_clock::now();
+         if (options.syncPolicy == SyncPolicy::EveryBatch
+             || (options.syncPolicy == SyncPolicy::Interval
+                 && now - lastSync >= options.syncInterval))
+         {
+            ok = syncFile();
+         }
+         else if (options.syncPolicy == SyncPolicy::Never)
+         {
+            unsynced = false;
+         }
+      }
+
+      if (ok)
+      {
+         *committedSize += buffer.size();
+      }
+      else
+      {
+         rollBack();
+      }
+
+      batches.fetch_add(1, std::memory_order_relaxed);
+
+      {
+         std::lock_guard<std::mutex> lock(wakeMutex);
+         for (std::size_t i = end; i > begin; --i)
+         {
+            requests[i - 1]->failed = !ok;
+            requests[i - 1]->done.store(true, std::memory_order_release);
+         }
+      }
+      doneWake.notify_all();
+
+      end = begin;
+   }
+}
+
+void BookingLedger::rollBack()
+{
+   // Частина групи могла потрапити у файл. fclose() дописує залишок
+   // буфера stdio, тому файл обрізається вже після закриття; наступна
+   // група відкриє його знову. Якщо обрізати не вдалося, openFile()
+   // повторить спробу перед записом.
+   if (file != nullptr)
+   {
+      std::fclose(file);
+      file = nullptr;
+   }
+
+   if (committedSize)
+   {
+      std::error_code error;
+      std::filesystem::resize_file(filePath, *committedSize, error);
+   }
+   unsynced = false;
+}
+
+bool BookingLedger::openFile()
+{
+   constexpr std::uintmax_t headerSize = sizeof(TicketFileHeader);
+   constexpr std::uintmax_t recordSize = sizeof(TicketRecord);
+
+   // Хвіст, що не є цілою вдалою групою (обірваний під час збою запис
+   // або невдала група), відрізається: інакше нові записи зсунулися б
+   // відносно меж записів або відродили квитки, про невдачу яких уже
+   // повідомлено.
+   std::error_code error;
+   const std::uintmax_t size = std::filesystem::file_size(filePath, error);
+   if (!error)
+   {
+      std::uintmax_t valid = size < headerSize
+         ? 0
+         : headerSize + (size - headerSize) / recordSize * recordSize;
+      if (committedSize)
+      {
+         valid = std::min(valid, *committedSize);
+      }
+
+      if (valid != size)
+      {
+         std::filesystem::resize_file(filePath, valid, error);
+         if (error)
+         {
+            return false;
+         }
+      }
+   }
+
+   file = std::fopen(filePath.c_str(), "ab");
+   if (file == nullptr)
+   {
+      return false;
+   }
+
+   std::fseek(file, 0, SEEK_END);
+   const long end = std::ftell(file);
+   if (end == 0)
+   {
+      TicketFileHeader header{};
+      std::memcpy(header.magic, ticketFileMagic, sizeof(header.magic));
+      header.recordSize = sizeof(TicketRecord);
+
+      if (std::fwrite(&header, sizeof(header), 1, file) != 1
+          || std::fflush(file) != 0)
+      {
+         std::fclose(file);
+         file = nullptr;
+
+         std::filesystem::resize_file(filePath, 0, error);
+         return false;
+      }
+
+      committedSize = headerSize;
+   }
+   else
+   {
+      committedSize = static_cast<std::uintmax_t>(end);
+   }
+
+   return true;
+}
+
+bool BookingLedger::syncFile()
+{
+   lastSync = std::chrono::steady_clock::now();
+   unsynced = false;
+
+   if (file == nullptr)
+   {
+      return true;
+   }
+
+#ifdef _WIN32
+   return ::_commit(::_fileno(file)) == 0;
+#else
+   return ::fdatasync(::fileno(file)) == 0;
+#endif
+}
@@ -0,0 +1,125 @@
+// BookingLedger.h
+#pragma once
+
+#include "Result.h"
+#include "TicketRecord.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+/// \file BookingLedger.h
+/// \brief Журнал квитків з груповою фіксацією записів.
+
+/// \brief Коли журнал викликає fsync для записаних квитків.
+enum class SyncPolicy
+{
+   Never,      ///< Лише передати дані ОС (як звичайний запис у файл).
+   EveryBatch, ///< fsync після кожної групи; виклик повертається після нього.
+   Interval    ///< fsync не частіше ніж раз на syncInterval.
+};
+
+/// \brief Параметри журналу квитків.
+struct LedgerOptions
+{
+   SyncPolicy                syncPolicy = SyncPolicy::EveryBatch;
+   std::chrono::milliseconds syncInterval{50}; ///< Для SyncPolicy::Interval.
+   std::size_t               maxBatch = 4096;   ///< Максимум записів в одній групі.
+};
+
+/// \class BookingLedger
+/// \brief Записує квитки у двійковий файл квитків одним фоновим потоком.
+/// \details Файл (формат див. у TicketRecord.h) відкривається один раз. Потоки, що бронюють, додають
+/// запис у безблокувальну чергу (багато виробників, один споживач) і
+/// чекають. Потік журналу забирає всю накопичену чергу, записує її одним
+/// викликом і, відповідно до SyncPolicy, робить fsync — поки він це робить,
+/// у черзі збирається наступна група. Кожен виклик повертається, щойно
+/// його група записана.
+///
+/// Група або записується повністю, або не залишає слідів: якщо запис чи
+/// fsync не вдався, файл обрізається до кінця останньої вдалої групи, а
+/// всі запити групи отримують IoError. Тому квиток, про невдачу якого
+/// повідомлено, не з'явиться у сховищі після перезапуску.
+class BookingLedger
+{
+public:
+   /// \brief Створює журнал і запускає потік запису.
+   /// \details Файл відкривається під час першого запису.
+   /// \param path Шлях до файлу квитків.
+   /// \param options Параметри групової фіксації.
+   explicit BookingLedger(std::string path, LedgerOptions options = {});
+
+   /// \brief Дописує всі записи з черги та закриває файл.
+   ~BookingLedger();
+
+   BookingLedger(const BookingLedger&) = delete;
+   BookingLedger& operator=(const BookingLedger&) = delete;
+
+   /// \brief Записує квиток і чекає завершення його групи.
+   /// \param record Запис квитка.
+   /// \return Порожній результат або IoError.
+   Result<void> append(const TicketRecord& record);
+
+   /// \brief Записує кілька квитків одним неподільним записом.
+   /// \details Усі квитки потрапляють в одну групу і в один виклик запису.
+   /// \param records Записи квитків.
+   /// \param count Кількість записів.
+   /// \return Порожній результат або IoError.
+   Result<void> append(const TicketRecord* records, std::size_t count);
+
+   /// \brief Повертає шлях до файлу квитків.
+   const std::string& path() const
+   {
+      return filePath;
+   }
+
+   /// \brief Повертає кількість виконаних групових фіксацій.
+   std::uint64_t batchCount() const
+   {
+      return batches.load(std::memory_order_relaxed);
+   }
+
+private:
+   /// \brief Запит на запис; живе в стеку потоку, що чекає на результат.
+   struct Request
+   {
+      std::string       bytes;      ///< Закодовані записи TicketRecord.
+      Request*          next = nullptr;
+      std::atomic<bool> done{false};
+      bool              failed = false;
+   };
+
+   std::string   filePath;
+   LedgerOptions options;
+   std::FILE*    file = nullptr;
+   std::string   buffer;
+
+   /// \brief Довжина файлу після останньої вдалої групи; порожня, доки
+   /// файл не відкривався.
+   std::optional<std::uintmax_t> committedSize;
+
+   std::atomic<Request*>      head{nullptr};
+   std::atomic<std::uint64_t> batches{0};
+
+   std::mutex              wakeMutex;
+   std::condition_variable writerWake;
+   std::condition_variable doneWake;
+   bool                    stopping = false;
+
+   std::chrono::steady_clock::time_point lastSync;
+   bool                                  unsynced = false;
+   std::thread                           writer;
+
+   Result<void> submit(Request& request);
+   void writerLoop();
+   void writeBatch(Request* batch);
+   void rollBack();
+   bool openFile();
+   bool syncFile();
+};
@@ -0,0 +1,51 @@
+// CatalogSnapshot.cpp
+
+#include "CatalogSnapshot.h"
+
+#include <utility>
+
+CatalogSnapshot::CatalogSnapshot(Tours tours, std::uint64_t version)
+   : table(std::move(tours)),
+     catalogVersion(version)
+{
+}
+
+const Tour* CatalogSnapshot::find(SlotId id) const
+{
+   const auto* entry = table.find(id);
+   return entry == nullptr ? nullptr : entry->tour.get();
+}
+
+SeatInventory* CatalogSnapshot::seats(SlotId id) const
+{
+   const auto* entry = table.find(id);
+   return entry == nullptr ? nullptr : entry->seats.get();
+}
+
+std::size_t CatalogSnapshot::scan(const TourQuery& query,
+   std::size_t position,
+   std::size_t limit,
+   std::vector<SlotId>& out) const
+{
+   const auto& values = table.values();
+   std::size_t taken = 0;
+
+   // Перебір іде ділянками блоків таблиці, а не через індекс на кожному
+   // елементі.
+   while (position < values.size() && taken < limit)
+   {
+      std::size_t length = 0;
+      const CatalogEntry* entries = values.run(position, length);
+
+      for (std::size_t i = 0; i < length && taken < limit; ++i, ++position)
+      {
+         if (query.matches(*entries[i].tour))
+         {
+            out.push_back(table.idAt(position));
+            ++taken;
+         }
+      }
+   }
+
+   return position;
+}
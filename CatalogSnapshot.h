@@ -0,0 +1,82 @@
+// CatalogSnapshot.h
+#pragma once
+
+#include "SeatInventory.h"
+#include "SlotMap.h"
+#include "Tour.h"
+#include "TourQuery.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// \file CatalogSnapshot.h
+/// \brief Незмінна версія каталогу турів для конкурентних читачів.
+
+/// \brief Запис каталогу: незмінні дані туру та його лічильник місць.
+struct CatalogEntry
+{
+   std::shared_ptr<const Tour>    tour;
+   std::shared_ptr<SeatInventory> seats; ///< Спільний для всіх версій каталогу.
+};
+
+/// \class CatalogSnapshot
+/// \brief Одна опублікована версія каталогу.
+/// \details Після публікації знімок ніколи не змінюється, тому читачі
+/// працюють з ним без блокувань. Письменник копіює таблицю і публікує
+/// змінену копію як нову версію. Таблиця складається з блоків (див.
+/// ChunkedVector), тож копія ділить з попередньою версією всі незмінені
+/// блоки: зміна одного туру коштує n / ChunkedVector::chunkSize вказівників
+/// і кілька скопійованих блоків, а не копію всього каталогу. Самі об'єкти
+/// турів теж спільні між версіями, а змінений тур замінюється новим
+/// об'єктом. Лічильники місць спільні між версіями і змінюються атомарно.
+class CatalogSnapshot
+{
+public:
+   /// \brief Таблиця турів знімка.
+   using Tours = SlotMap<CatalogEntry>;
+
+   /// \brief Створює порожній знімок нульової версії.
+   CatalogSnapshot() = default;
+
+   /// \brief Створює знімок з готової таблиці турів.
+   /// \param tours Таблиця турів.
+   /// \param version Номер версії каталогу.
+   CatalogSnapshot(Tours tours, std::uint64_t version);
+
+   /// \brief Повертає таблицю турів знімка.
+   const Tours& tours() const
+   {
+      return table;
+   }
+
+   /// \brief Повертає номер версії каталогу.
+   std::uint64_t version() const
+   {
+      return catalogVersion;
+   }
+
+   /// \brief Шукає тур за ідентифікатором.
+   /// \return Тур або nullptr, якщо у цій версії його немає.
+   const Tour* find(SlotId id) const;
+
+   /// \brief Шукає лічильник місць туру.
+   /// \return Лічильник або nullptr, якщо у цій версії туру немає.
+   SeatInventory* seats(SlotId id) const;
+
+   /// \brief Сканує знімок з указаної позиції до накопичення limit збігів.
+   /// \param query Критерій відбору.
+   /// \param position Позиція в порядку знімка, з якої почати.
+   /// \param limit Максимальна кількість знайдених турів.
+   /// \param out Вектор, до якого дописуються ідентифікатори.
+   /// \return Позиція, з якої слід продовжити сканування.
+   std::size_t scan(const TourQuery& query,
+      std::size_t position,
+      std::size_t limit,
+      std::vector<SlotId>& out) const;
+
+private:
+   Tours         table;
+   std::uint64_t catalogVersion = 0;
+};
@@ -0,0 +1,253 @@
+// ChunkedVector.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// \file ChunkedVector.h
+/// \brief Вектор з блоків, спільних між копіями до першої зміни.
+
+/// \class ChunkedVector
+/// \brief Послідовність елементів у блоках по chunkSize з копіюванням блоку
+/// під час запису.
+/// \details Копія вектора копіює лише таблицю вказівників на блоки; самі
+/// блоки лишаються спільними, доки одна з копій не змінить елемент, і тоді
+/// ця копія отримує власний екземпляр лише зміненого блоку. Нова версія
+/// великої таблиці коштує n / chunkSize вказівників плюс змінені блоки, а
+/// не n елементів.
+///
+/// Читати спільні блоки можна з будь-яких потоків. Змінювати конкретну
+/// копію вектора може лише один потік, а нові копії створює лише він.
+/// \tparam T Тип елемента; має копіюватися.
+template <typename T>
+class ChunkedVector
+{
+   using Chunk = std::vector<T>;
+
+public:
+   /// \brief Двійковий логарифм розміру блоку.
+   static constexpr std::size_t chunkShift = 10;
+
+   /// \brief Кількість елементів у повному блоці.
+   static constexpr std::size_t chunkSize = std::size_t{1} << chunkShift;
+
+   /// \brief Ітератор для читання елементів по порядку.
+   class const_iterator
+   {
+   public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T*;
+      using reference = const T&;
+
+      const_iterator() = default;
+
+      const_iterator(const ChunkedVector* owner, std::size_t index)
+         : owner(owner),
+           index(index)
+      {
+      }
+
+      const T& operator*() const
+      {
+         return (*owner)[index];
+      }
+
+      const T* operator->() const
+      {
+         return &(*owner)[index];
+      }
+
+      const_iterator& operator++()
+      {
+         ++index;
+         return *this;
+      }
+
+      const_iterator operator++(int)
+      {
+         const_iterator previous = *this;
+         ++index;
+         return previous;
+      }
+
+      bool operator==(const const_iterator& other) const
+      {
+         return index == other.index;
+      }
+
+      bool operator!=(const const_iterator& other) const
+      {
+         return index != other.index;
+      }
+
+   private:
+      const ChunkedVector* owner = nullptr;
+      std::size_t          index = 0;
+   };
+
+   /// \brief Повертає кількість елементів.
+   std::size_t size() const
+   {
+      return count;
+   }
+
+   /// \brief Перевіряє, чи вектор порожній.
+   bool empty() const
+   {
+      return count == 0;
+   }
+
+   /// \brief Повертає елемент для читання.
+   const T& operator[](std::size_t index) const
+   {
+      return (*chunks[index >> chunkShift])[index & (chunkSize - 1)];
+   }
+
+   /// \brief Повертає неперервну ділянку, що починається з елемента index.
+   /// \details Ділянка закінчується разом із блоком елемента; для
+   /// послідовного перебору без обчислення блоку на кожному елементі.
+   /// \param index Номер першого елемента, менший за size().
+   /// \param length Отримує кількість елементів ділянки.
+   /// \return Вказівник на перший елемент ділянки.
+   const T* run(std::size_t index, std::size_t& length) const
+   {
+      const Chunk& chunk = *chunks[index >> chunkShift];
+      const std::size_t offset = index & (chunkSize - 1);
+      length = chunk.size() - offset;
+      return chunk.data() + offset;
+   }
+
+   /// \brief Повертає елемент для зміни.
+   /// \details Якщо блок елемента спільний з іншою копією, спершу
+   /// копіюється блок.
+   T& mutableAt(std::size_t index)
+   {
+      return own(index >> chunkShift)[index & (chunkSize - 1)];
+   }
+
+   /// \brief Повертає останній елемент.
+   const T& back() const
+   {
+      return (*this)[count - 1];
+   }
+
+   /// \brief Додає елемент у кінець.
+   void push_back(T value)
+   {
+      if ((count & (chunkSize - 1)) == 0)
+      {
+         chunks.push_back(std::make_shared<Chunk>());
+         chunks.back()->reserve(chunkSize);
+      }
+
+      own(count >> chunkShift).push_back(std::move(value));
+      ++count;
+   }
+
+   /// \brief Видаляє останній елемент.
+   void pop_back()
+   {
+      own((count - 1) >> chunkShift).pop_back();
+      --count;
+
+      if ((count & (chunkSize - 1)) == 0)
+      {
+         chunks.pop_back();
+      }
+   }
+
+   /// \brief Змінює кількість елементів; нові елементи створюються за
+   /// замовчуванням.
+   void resize(std::size_t size)
+   {
+      while (count < size)
+      {
+         push_back(T{});
+      }
+
+      while (count > size)
+      {
+         pop_back();
+      }
+   }
+
+   /// \brief Резервує таблицю вказівників під вказану кількість елементів.
+   void reserve(std::size_t size)
+   {
+      chunks.reserve((size + chunkSize - 1) >> chunkShift);
+   }
+
+   /// \brief Видаляє всі елементи.
+   void clear()
+   {
+      chunks.clear();
+      count = 0;
+   }
+
+   /// \brief Обмінює вміст з іншим вектором.
+   void swap(ChunkedVector& other) noexcept
+   {
+      chunks.swap(other.chunks);
+      std::swap(count, other.count);
+   }
+
+   const_iterator begin() const
+   {
+      return const_iterator(this, 0);
+   }
+
+   const_iterator end() const
+   {
+      return const_iterator(this, count);
+   }
+
+   /// \brief Повертає байти таблиці вказівників і всіх блоків.
+   /// \details Спільні з іншими копіями блоки теж враховуються.
+   std::size_t memoryBytes() const
+   {
+      std::size_t bytes = chunks.capacity() * sizeof(std::shared_ptr<Chunk>);
+      for (const std::shared_ptr<Chunk>& chunk : chunks)
+      {
+         bytes += chunk->capacity() * sizeof(T);
+      }
+      return bytes;
+   }
+
+   /// \brief Повертає кількість окремих виділень пам'яті.
+   std::size_t allocations() const
+   {
+      return chunks.size() + 1;
+   }
+
+private:
+   std::vector<std::shared_ptr<Chunk>> chunks;
+   std::size_t                         count = 0;
+
+   /// \brief Повертає блок, яким володіє лише ця копія.
+   Chunk& own(std::size_t chunk)
+   {
+      std::shared_ptr<Chunk>& shared = chunks[chunk];
+
+      if (shared.use_count() != 1)
+      {
+         auto copy = std::make_shared<Chunk>();
+         copy->reserve(chunkSize);
+         copy->assign(shared->begin(), shared->end());
+         shared = std::move(copy);
+      }
+      else
+      {
+         // Інша копія могла щойно відпустити блок: її читання мають
+         // завершитися до запису в нього.
+         std::atomic_thread_fence(std::memory_order_acquire);
+      }
+
+      return *shared;
+   }
+};
@@ -1,15 +1,26 @@
 // CityTour.cpp
 
 #include "CityTour.h"
+#include "CsvScanner.h"
 #include "FileException.h"
+#include "AllocationStats.h"
+#include "MemoryReport.h"
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <cctype>
 #include <string>
 
 namespace
 {
+/// \brief Поля CSV-рядка міського туру в порядку запису.
+const char* const fieldNames[] =
+{
+   "country", "city", "accommodation", "transport", "departureDate",
+   "returnDate", "hotelLevel", "food", "extras", "price"
+};
+
 bool isValidDate(const std::string& date)
 {
    if (date.size() != 10)
@@ -161,7 +172,7 @@ CityTour::CityTour(const CityTour& other)
      extras(other.extras),
      price(other.price)
 {
-   std::cout << "[Copy] CityTour скопійовано\n";
+   AllocationStats::copied(TrackedType::CityTour);
 }
 
 CityTour::CityTour(CityTour&& other) noexcept
@@ -176,72 +187,44 @@ CityTour::CityTour(CityTour&& other) noexcept
      extras(std::move(other.extras)),
      price(other.price)
 {
-   std::cout << "[Move] CityTour переміщено\n";
+   AllocationStats::moved(TrackedType::CityTour);
 }
 
 CityTour::~CityTour()
 {
-   std::cout << "[Destructor] CityTour видалено\n";
+   AllocationStats::destroyed(TrackedType::CityTour);
 }
 
 CityTour::CityTour(const std::string& csvLine)
+   : CityTour(CsvRow(csvLine), 0)
 {
-   std::istringstream iss(csvLine);
-   std::string token;
-
-   if (!std::getline(iss, country, ','))
-   {
-      throw FileException("Немає поля country у CityTour.");
-   }
-
-   if (!std::getline(iss, city, ','))
-   {
-      throw FileException("Немає поля city у CityTour.");
-   }
-
-   if (!std::getline(iss, accommodation, ','))
-   {
-      throw FileException("Немає поля accommodation у CityTour.");
-   }
-
-   if (!std::getline(iss, transport, ','))
-   {
-      throw FileException("Немає поля transport у CityTour.");
-   }
-
-   if (!std::getline(iss, departureDate, ','))
-   {
-      throw FileException("Немає поля departureDate у CityTour.");
-   }
-
-   if (!std::getline(iss, returnDate, ','))
-   {
-      throw FileException("Немає поля returnDate у CityTour.");
-   }
-
-   if (!std::getline(iss, hotelLevel, ','))
-   {
-      throw FileException("Немає поля hotelLevel у CityTour.");
-   }
+}
 
-   if (!std::getline(iss, food, ','))
-   {
-      throw FileException("Немає поля food у CityTour.");
-   }
+CityTour::CityTour(const CsvRow& row, std::size_t first)
+{
+   constexpr std::size_t fieldCount =
+      sizeof(fieldNames) / sizeof(fieldNames[0]);
 
-   if (!std::getline(iss, extras, ','))
+   if (row.size() < first + fieldCount)
    {
-      throw FileException("Немає поля extras у CityTour.");
+      const std::size_t present = row.size() > first ? row.size() - first : 0;
+      throw FileException(std::string("Немає поля ") + fieldNames[present]
+         + " у CityTour.");
    }
 
-   if (!std::getline(iss, token))
-   {
-      throw FileException("Немає поля price у CityTour.");
-   }
+   row.copyField(first, country);
+   row.copyField(first + 1, city);
+   row.copyField(first + 2, accommodation);
+   row.copyField(first + 3, transport);
+   row.copyField(first + 4, departureDate);
+   row.copyField(first + 5, returnDate);
+   row.copyField(first + 6, hotelLevel);
+   row.copyField(first + 7, food);
+   row.copyField(first + 8, extras);
 
    try
    {
-      price = std::stod(token);
+      price = std::stod(row.field(first + 9));
    }
    catch (...)
    {
@@ -358,16 +341,16 @@ std::string CityTour::toCSV() const
 {
    std::ostringstream oss;
 
-   oss << country << ','
-       << city << ','
-       << accommodation << ','
-       << transport << ','
-       << departureDate << ','
-       << returnDate << ','
-       << hotelLevel << ','
-       << food << ','
-       << extras << ','
-       << price;
+   // Текстові поля беруться в лапки, лише якщо містять кому, лапку чи
+   // перенос; ціна записується як і раніше.
+   for (const std::string* field : {&country, &city, &accommodation,
+           &transport, &departureDate, &returnDate, &hotelLevel, &food,
+           &extras})
+   {
+      CsvScanner::writeField(oss, *field);
+      oss << ',';
+   }
+   oss << price;
 
    return oss.str();
 }
@@ -497,3 +480,111 @@ void CityTour::editInteractive()
       }
    }
 }
+
+std::shared_ptr<Tour> CityTour::clone() const
+{
+   return std::make_shared<CityTour>(*this);
+}
+
+Result<void> CityTour::applyPatch(const TourPatch& patch)
+{
+   if (patch.equipmentIncluded || patch.insuranceIncluded)
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Міський тур не має полів спорядження та страхування."};
+   }
+
+   const std::string newDeparture =
+      patch.departureDate.value_or(departureDate);
+   const std::string newReturn = patch.returnDate.value_or(returnDate);
+
+   if (patch.departureDate && !isValidDate(newDeparture))
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Некоректна дата відправлення: " + newDeparture};
+   }
+
+   if (patch.returnDate && !isValidDate(newReturn))
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Некоректна дата повернення: " + newReturn};
+   }
+
+   if (!newDeparture.empty() && !newReturn.empty()
+       && newReturn < newDeparture)
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Дата повернення не може бути раніше дати відправлення."};
+   }
+
+   if (patch.hotelLevel && !isValidHotelLevel(*patch.hotelLevel))
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Некоректний рівень готелю: " + *patch.hotelLevel};
+   }
+
+   if (patch.price && !(*patch.price >= 0.0))
+   {
+      return Error{ErrorCode::InvalidArgument, "Некоректна ціна."};
+   }
+
+   if (patch.country)
+   {
+      country = *patch.country;
+   }
+
+   if (patch.city)
+   {
+      city = *patch.city;
+   }
+
+   if (patch.accommodation)
+   {
+      accommodation = *patch.accommodation;
+   }
+
+   if (patch.transport)
+   {
+      transport = *patch.transport;
+   }
+
+   if (patch.food)
+   {
+      food = *patch.food;
+   }
+
+   if (patch.extras)
+   {
+      extras = *patch.extras;
+   }
+
+   if (patch.hotelLevel)
+   {
+      hotelLevel = *patch.hotelLevel;
+   }
+
+   if (patch.price)
+   {
+      price = *patch.price;
+   }
+
+   departureDate = newDeparture;
+   returnDate = newReturn;
+
+   return {};
+}
+
+void CityTour::accountMemory(MemoryReport& report) const
+{
+   TypeMemory& usage = report.type("CityTour");
+   usage.addObject(sizeof(*this));
+   usage.addString("country", country);
+   usage.addString("city", city);
+   usage.addString("accommodation", accommodation);
+   usage.addString("transport", transport);
+   usage.addString("departureDate", departureDate);
+   usage.addString("returnDate", returnDate);
+   usage.addString("hotelLevel", hotelLevel);
+   usage.addString("food", food);
+   usage.addString("extras", extras);
+}
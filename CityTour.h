@@ -4,9 +4,12 @@
 #include "Tour.h"
 #include "ISerializable.h"
 
+#include <cstddef>
 #include <iostream>
 #include <string>
 
+struct CsvRow;
+
 /// \class CityTour
 /// \brief Представляє міський тур.
 class CityTour : public Tour, public ISerializable
@@ -31,6 +34,12 @@ public:
    /// \param csvLine Рядок з даними туру у форматі CSV.
    explicit CityTour(const std::string& csvLine);
 
+   /// \brief Створює міський тур з уже розбитого CSV-рядка.
+   /// \param row Поля рядка (див. CsvScanner).
+   /// \param first Номер першого поля туру; попередні поля — службові.
+   /// \throws FileException Якщо полів не вистачає або ціна некоректна.
+   CityTour(const CsvRow& row, std::size_t first);
+
    /// \brief Створює копію міського туру.
    /// \param other Інший об’єкт CityTour для копіювання.
    CityTour(const CityTour& other);
@@ -49,6 +58,8 @@ public:
    void display() const override;
 
    /// \brief Серіалізує міський тур у CSV-рядок.
+   /// \details Поля з комою, лапкою чи переносом беруться в лапки за
+   /// RFC 4180 (див. CsvScanner::writeField).
    /// \return Рядок з даними туру у форматі CSV.
    std::string toCSV() const override;
 
@@ -97,6 +108,19 @@ public:
    /// \brief Дозволяє змінити параметри туру у інтерактивному режимі.
    void editInteractive() override;
 
+   /// \brief Створює незалежну копію туру.
+   /// \return Копія туру.
+   std::shared_ptr<Tour> clone() const override;
+
+   /// \brief Застосовує набір змін без консольного введення.
+   /// \param patch Поля, які потрібно змінити.
+   /// \return Порожній результат або опис помилки валідації.
+   Result<void> applyPatch(const TourPatch& patch) override;
+
+   /// \brief Додає розмір туру і його рядкових полів до звіту про пам'ять.
+   /// \param report Звіт, у якому накопичується облік.
+   void accountMemory(MemoryReport& report) const override;
+
    /// \brief Повертає назву туру для відображення.
    /// \return Назва туру (місто).
    std::string getName() const
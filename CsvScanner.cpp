@@ -0,0 +1,432 @@
+// CsvScanner.cpp
+
+#include "CsvScanner.h"
+
+#include <cstring>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CSV_SCANNER_X86 1
+#include <immintrin.h>
+#else
+#define CSV_SCANNER_X86 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+   /// \brief Позиції ком, переносів і лапок у 64-байтовому блоці, по біту
+   /// на байт.
+   struct BlockMasks
+   {
+      std::uint64_t commas;
+      std::uint64_t newlines;
+      std::uint64_t quotes;
+   };
+
+   using Classifier = BlockMasks (*)(const char* block);
+
+#if CSV_SCANNER_X86
+   BlockMasks classifySse2(const char* block)
+   {
+      const __m128i comma = _mm_set1_epi8(',');
+      const __m128i newline = _mm_set1_epi8('\n');
+      const __m128i quote = _mm_set1_epi8('"');
+
+      BlockMasks masks{0, 0, 0};
+      for (unsigned i = 0; i < 4; ++i)
+      {
+         const __m128i bytes = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(block + 16 * i));
+         const unsigned commaBits = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)));
+         const unsigned newlineBits = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)));
+         const unsigned quoteBits = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)));
+
+         masks.commas |= std::uint64_t(commaBits) << (16 * i);
+         masks.newlines |= std::uint64_t(newlineBits) << (16 * i);
+         masks.quotes |= std::uint64_t(quoteBits) << (16 * i);
+      }
+      return masks;
+   }
+
+#if defined(__GNUC__)
+   __attribute__((target("avx2")))
+#endif
+   BlockMasks classifyAvx2(const char* block)
+   {
+      const __m256i comma = _mm256_set1_epi8(',');
+      const __m256i newline = _mm256_set1_epi8('\n');
+      const __m256i quote = _mm256_set1_epi8('"');
+
+      const __m256i low =
+         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+      const __m256i high =
+         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+      const std::uint64_t lowCommas = static_cast<std::uint32_t>(
+         _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, comma)));
+      const std::uint64_t highCommas = static_cast<std::uint32_t>(
+         _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, comma)));
+      const std::uint64_t lowNewlines = static_cast<std::uint32_t>(
+         _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline)));
+      const std::uint64_t highNewlines = static_cast<std::uint32_t>(
+         _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)));
+      const std::uint64_t lowQuotes = static_cast<std::uint32_t>(
+         _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, quote)));
+      const std::uint64_t highQuotes = static_cast<std::uint32_t>(
+         _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, quote)));
+
+      return BlockMasks{lowCommas | highCommas << 32,
+         lowNewlines | highNewlines << 32,
+         lowQuotes | highQuotes << 32};
+   }
+#else
+   BlockMasks classifyScalar(const char* block)
+   {
+      BlockMasks masks{0, 0, 0};
+      for (unsigned i = 0; i < 64; ++i)
+      {
+         masks.commas |= std::uint64_t(block[i] == ',') << i;
+         masks.newlines |= std::uint64_t(block[i] == '\n') << i;
+         masks.quotes |= std::uint64_t(block[i] == '"') << i;
+      }
+      return masks;
+   }
+#endif
+
+   Classifier selectClassifier()
+   {
+#if CSV_SCANNER_X86 && defined(__GNUC__)
+      // Виклик може статися до конструкторів libgcc, що заповнюють дані CPU.
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? classifyAvx2 : classifySse2;
+#elif CSV_SCANNER_X86 && defined(__AVX2__)
+      return classifyAvx2;
+#elif CSV_SCANNER_X86
+      return classifySse2;
+#else
+      return classifyScalar;
+#endif
+   }
+
+   const Classifier classifier = selectClassifier();
+
+   unsigned lowestBit(std::uint64_t bits)
+   {
+#if defined(__GNUC__)
+      return static_cast<unsigned>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+      unsigned long index = 0;
+      _BitScanForward64(&index, bits);
+      return static_cast<unsigned>(index);
+#else
+      unsigned index = 0;
+      while ((bits & 1) == 0)
+      {
+         bits >>= 1;
+         ++index;
+      }
+      return index;
+#endif
+   }
+}
+
+CsvRow::CsvRow(std::string_view line)
+{
+   CsvScanner scanner(line.data(), line.size());
+   scanner.next(*this);
+}
+
+CsvScanner::CsvScanner(const char* data, std::size_t size)
+   : data(data),
+     size(size)
+{
+   if (size != 0)
+   {
+      classify();
+   }
+}
+
+void CsvScanner::classify()
+{
+   BlockMasks masks;
+   if (size - block >= 64)
+   {
+      masks = classifier(data + block);
+   }
+   else
+   {
+      // Хвіст доповнюється нулями: вони не є роздільниками.
+      char padded[64] = {};
+      std::memcpy(padded, data + block, size - block);
+      masks = classifier(padded);
+   }
+
+   commas = masks.commas;
+   newlines = masks.newlines;
+   quotes = masks.quotes;
+}
+
+bool CsvScanner::next(CsvRow& row)
+{
+   if (rowStart >= size)
+   {
+      return false;
+   }
+
+   // Стан тримається в локальних змінних: запис у row інакше змушує
+   // компілятор перечитувати поля сканера після кожного поля рядка.
+   const std::size_t start = rowStart;
+   std::uint32_t* const bounds = row.bounds;
+   std::size_t count = 0;
+   std::size_t base = block;
+   std::uint64_t commaBits = commas;
+   std::uint64_t newlineBits = newlines;
+   std::uint64_t quoteBits = quotes;
+
+   row.data = data + start;
+   row.quoted = 0;
+   bounds[0] = 0;
+
+   for (;;)
+   {
+      // Коми до першого переносу блоку належать поточному рядку.
+      const std::uint64_t newline = newlineBits & (~newlineBits + 1);
+      const std::uint64_t owned = newline - 1;
+
+      // Лапки змінюють значення ком і переносів: такий рядок
+      // розбирається окремо, від початку.
+      if ((quoteBits & owned) != 0)
+      {
+         parseQuoted(row);
+         return true;
+      }
+
+      std::uint64_t fields = commaBits & owned;
+      commaBits ^= fields;
+
+      // base може бути меншим за start; обчислення за модулем 2^32 все
+      // одно дають правильні межі.
+      const auto offset = static_cast<std::uint32_t>(base - start + 1);
+      for (; fields != 0; fields &= fields - 1)
+      {
+         if (count < CsvRow::maxFields - 1)
+         {
+            bounds[++count] = offset + lowestBit(fields);
+         }
+      }
+
+      if (newline != 0)
+      {
+         const auto length =
+            static_cast<std::uint32_t>(base + lowestBit(newline) - start + 1);
+         bounds[++count] = length;
+
+         row.count = count;
+         rowStart = start + length;
+         commas = commaBits;
+         newlines = newlineBits ^ newline;
+         return true;
+      }
+
+      base += 64;
+      if (base >= size)
+      {
+         // Останній рядок без переносу.
+         bounds[++count] = static_cast<std::uint32_t>(size - start + 1);
+
+         row.count = count;
+         rowStart = size;
+         block = base;
+         commas = 0;
+         newlines = 0;
+         quotes = 0;
+         return true;
+      }
+
+      block = base;
+      classify();
+      commaBits = commas;
+      newlineBits = newlines;
+      quoteBits = quotes;
+   }
+}
+
+void CsvScanner::parseQuoted(CsvRow& row)
+{
+   const std::size_t start = rowStart;
+   std::uint32_t* const bounds = row.bounds;
+   std::size_t count = 0;
+   std::uint32_t quoted = 0;
+   bool merged = false;
+   std::size_t pos = start;
+
+   row.data = data + start;
+   bounds[0] = 0;
+
+   for (;;)
+   {
+      if (pos < size && data[pos] == '"')
+      {
+         // Закриває поле лапка, за якою не йде ще одна лапка.
+         std::size_t close = pos + 1;
+         for (;;)
+         {
+            const void* found = std::memchr(data + close, '"', size - close);
+            if (found == nullptr)
+            {
+               close = size;
+               break;
+            }
+
+            close = static_cast<std::size_t>(
+               static_cast<const char*>(found) - data);
+            if (close + 1 < size && data[close + 1] == '"')
+            {
+               close += 2;
+               continue;
+            }
+            break;
+         }
+
+         if (close < size)
+         {
+            if (!merged)
+            {
+               quoted |= std::uint32_t(1) << count;
+            }
+            pos = close + 1;
+         }
+      }
+
+      // Текст до роздільника; після закривної лапки його не повинно бути,
+      // але він зберігається, а не відкидається.
+      while (pos < size && data[pos] != ',' && data[pos] != '\n')
+      {
+         ++pos;
+      }
+
+      const auto next = static_cast<std::uint32_t>(pos - start + 1);
+      if (pos == size || data[pos] == '\n')
+      {
+         bounds[++count] = next;
+         break;
+      }
+
+      if (count < CsvRow::maxFields - 1)
+      {
+         bounds[++count] = next;
+      }
+      else
+      {
+         // Поле-залишок уже не є одним полем у лапках.
+         merged = true;
+         quoted &= ~(std::uint32_t(1) << count);
+      }
+      ++pos;
+   }
+
+   row.count = count;
+   row.quoted = quoted;
+   rowStart = pos < size ? pos + 1 : size;
+
+   // Маски наступного рядка будуються заново з його блоку.
+   block = rowStart - rowStart % 64;
+   if (rowStart < size)
+   {
+      classify();
+      const std::uint64_t keep = ~std::uint64_t(0) << (rowStart - block);
+      commas &= keep;
+      newlines &= keep;
+      quotes &= keep;
+   }
+   else
+   {
+      commas = 0;
+      newlines = 0;
+      quotes = 0;
+   }
+}
+
+std::string CsvRow::unquote(std::string_view text)
+{
+   std::string value;
+   value.reserve(text.size());
+
+   std::size_t from = 1;
+   while (from < text.size())
+   {
+      const std::size_t quote = text.find('"', from);
+      if (quote == std::string_view::npos)
+      {
+         value.append(text.substr(from));
+         break;
+      }
+
+      value.append(text.substr(from, quote - from));
+      if (quote + 1 < text.size() && text[quote + 1] == '"')
+      {
+         value.push_back('"');
+         from = quote + 2;
+         continue;
+      }
+
+      // Закривна лапка; текст після неї (якщо є) лишається як є.
+      value.append(text.substr(quote + 1));
+      break;
+   }
+
+   return value;
+}
+
+void CsvScanner::writeField(std::ostream& out, std::string_view field)
+{
+   // Перевірка без розгалужень на кожен символ.
+   unsigned special = 0;
+   for (const char ch : field)
+   {
+      special |= static_cast<unsigned>(ch == ',') | (ch == '"') | (ch == '\n')
+         | (ch == '\r');
+   }
+
+   if (special == 0)
+   {
+      out.write(field.data(), static_cast<std::streamsize>(field.size()));
+      return;
+   }
+
+   out.put('"');
+   std::size_t from = 0;
+   for (std::size_t quote = field.find('"'); quote != std::string_view::npos;
+        quote = field.find('"', from))
+   {
+      out.write(field.data() + from,
+         static_cast<std::streamsize>(quote + 1 - from));
+      out.put('"');
+      from = quote + 1;
+   }
+   out.write(field.data() + from,
+      static_cast<std::streamsize>(field.size() - from));
+   out.put('"');
+}
+
+const char* CsvScanner::implementation()
+{
+#if CSV_SCANNER_X86
+   if (classifier == classifyAvx2)
+   {
+      return "avx2";
+   }
+   if (classifier == classifySse2)
+   {
+      return "sse2";
+   }
+#endif
+   return "scalar";
+}
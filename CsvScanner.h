@@ -0,0 +1,154 @@
+// CsvScanner.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/// \file CsvScanner.h
+/// \brief Розбиття CSV-тексту на рядки й поля блоками по 64 байти та
+/// запис полів із лапками за RFC 4180.
+
+/// \struct CsvRow
+/// \brief Один рядок CSV: межі полів без копіювання тексту.
+/// \details Поле i займає [bounds[i], bounds[i + 1] - 1) відносно початку
+/// рядка; останнє поле закінчується кінцем рядка. Якщо в рядку більше
+/// maxFields полів, останнє поле містить увесь залишок рядка разом із
+/// комами. Поля вказують у буфер, з якого рядок прочитано, тож CsvRow не
+/// повинен його переживати.
+///
+/// Поле, що починається з лапок, — поле в лапках за RFC 4180: коми й
+/// переноси всередині належать йому, а `""` означає одну лапку. raw()
+/// повертає такі поля як у файлі, field() — розкодованими. Лапки
+/// всередині поля без лапок лишаються звичайними символами.
+struct CsvRow
+{
+   /// \brief Найбільша кількість окремих полів.
+   static constexpr std::size_t maxFields = 16;
+
+   CsvRow() = default;
+
+   /// \brief Розбиває один рядок без символу переносу.
+   /// \param line Текст рядка; порожній рядок не має жодного поля.
+   explicit CsvRow(std::string_view line);
+
+   /// \brief Повертає кількість полів.
+   std::size_t size() const
+   {
+      return count;
+   }
+
+   /// \brief Повертає текст поля так, як він записаний у рядку.
+   /// \param index Номер поля, менший за size().
+   std::string_view raw(std::size_t index) const
+   {
+      return std::string_view(data + bounds[index],
+         bounds[index + 1] - bounds[index] - 1);
+   }
+
+   /// \brief Повертає значення поля без лапок і з розкодованими `""`.
+   /// \param index Номер поля, менший за size().
+   std::string field(std::size_t index) const
+   {
+      if (((quoted >> index) & 1) == 0)
+      {
+         return std::string(raw(index));
+      }
+      return unquote(raw(index));
+   }
+
+   /// \brief Записує значення поля в target, як field(), але повторно
+   /// використовує пам'ять target і не створює тимчасового рядка.
+   /// \param index Номер поля, менший за size().
+   /// \param target Рядок для значення.
+   void copyField(std::size_t index, std::string& target) const
+   {
+      if (((quoted >> index) & 1) == 0)
+      {
+         target.assign(raw(index));
+      }
+      else
+      {
+         target = unquote(raw(index));
+      }
+   }
+
+   /// \brief Повертає весь текст рядка без переносу.
+   std::string_view text() const
+   {
+      return std::string_view(data, count == 0 ? 0 : bounds[count] - 1);
+   }
+
+private:
+   friend class CsvScanner;
+
+   const char*   data = nullptr;
+   std::size_t   count = 0;
+   std::uint32_t quoted = 0; ///< Біт i — поле i в лапках.
+   std::uint32_t bounds[maxFields + 1] = {};
+
+   /// \brief Розкодовує поле, що починається з лапок.
+   static std::string unquote(std::string_view text);
+};
+
+/// \class CsvScanner
+/// \brief Послідовно видає рядки CSV-буфера з межами полів.
+/// \details Коми, переноси й лапки шукаються не посимвольно, а блоками по
+/// 64 байти: для кожного блоку одразу будуються бітові маски позицій цих
+/// символів (AVX2 по 32 байти, SSE2 по 16, або скалярний цикл), після чого
+/// розбір лише перебирає встановлені біти. AVX2 вибирається під час
+/// виконання, якщо процесор його підтримує, навіть коли програму зібрано
+/// без `-mavx2`.
+///
+/// Рядок без жодної лапки розбирається лише за масками. Якщо в рядку є
+/// лапки, він повторно розбирається посимвольно з урахуванням полів у
+/// лапках (див. CsvRow), тож переноси всередині них не завершують рядок.
+/// Незакрита лапка вважається звичайним символом.
+///
+/// Роздільник рядків — `\n`; символ `\r` перед ним лишається в останньому
+/// полі, як і під час читання через std::getline. Буфер не копіюється і
+/// має жити, доки використовуються отримані рядки.
+class CsvScanner
+{
+public:
+   /// \brief Починає розбір буфера.
+   /// \param data Початок тексту.
+   /// \param size Довжина тексту в байтах.
+   CsvScanner(const char* data, std::size_t size);
+
+   /// \brief Читає наступний рядок.
+   /// \param row Отримує межі полів рядка.
+   /// \return false, якщо рядків більше немає. Порожній рядок між двома
+   /// переносами повертається з одним порожнім полем.
+   bool next(CsvRow& row);
+
+   /// \brief Записує поле, беручи його в лапки лише за потреби.
+   /// \details Лапки потрібні, якщо поле містить кому, лапку, `\r` або
+   /// `\n`; тоді лапки всередині подвоюються. Інакше поле записується як
+   /// є, без проміжної копії.
+   /// \param out Потік для запису.
+   /// \param field Значення поля.
+   static void writeField(std::ostream& out, std::string_view field);
+
+   /// \brief Назва реалізації пошуку, вибраної на цьому процесорі:
+   /// "avx2", "sse2" або "scalar".
+   static const char* implementation();
+
+private:
+   const char*   data;
+   std::size_t   size;
+   std::size_t   block = 0;     ///< Початок поточного 64-байтового блоку.
+   std::size_t   rowStart = 0;  ///< Початок наступного рядка.
+   std::uint64_t commas = 0;    ///< Ще не оброблені коми поточного блоку.
+   std::uint64_t newlines = 0;  ///< Ще не оброблені переноси поточного блоку.
+   std::uint64_t quotes = 0;    ///< Ще не оброблені лапки поточного блоку.
+
+   /// \brief Будує маски блоку, що починається з позиції block.
+   void classify();
+
+   /// \brief Посимвольно розбирає рядок, що починається з rowStart, і
+   /// переводить маски на наступний рядок.
+   void parseQuoted(CsvRow& row);
+};
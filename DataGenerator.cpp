@@ -0,0 +1,552 @@
+// DataGenerator.cpp
+
+#include "DataGenerator.h"
+#include "FileException.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace
+{
+   template <std::size_t N>
+   std::size_t pickWeighted(Random& random, const int (&weights)[N])
+   {
+      int total = 0;
+      for (int weight : weights)
+      {
+         total += weight;
+      }
+
+      int roll = static_cast<int>(random.below(static_cast<std::size_t>(total)));
+      for (std::size_t i = 0; i < N; ++i)
+      {
+         roll -= weights[i];
+         if (roll < 0)
+         {
+            return i;
+         }
+      }
+
+      return N - 1;
+   }
+
+   struct Region
+   {
+      const char*              country;
+      std::vector<const char*> places;
+   };
+
+   // Порядок задає популярність: перші країни й міста найчастіші.
+   const std::vector<Region> cityRegions =
+   {
+      {"Italy",       {"Rome", "Venice", "Florence", "Milan", "Naples", "Verona"}},
+      {"France",      {"Paris", "Nice", "Lyon", "Marseille", "Bordeaux"}},
+      {"Spain",       {"Barcelona", "Madrid", "Seville", "Valencia", "Malaga"}},
+      {"Turkey",      {"Istanbul", "Antalya", "Izmir", "Bodrum"}},
+      {"Greece",      {"Athens", "Heraklion", "Rhodes", "Thessaloniki"}},
+      {"Ukraine",     {"Kyiv", "Lviv", "Odesa", "Chernivtsi", "Kharkiv"}},
+      {"Egypt",       {"Hurghada", "Cairo", "Luxor"}},
+      {"Poland",      {"Krakow", "Warsaw", "Gdansk", "Wroclaw"}},
+      {"Czechia",     {"Prague", "Brno", "Karlovy-Vary"}},
+      {"Germany",     {"Berlin", "Munich", "Hamburg", "Dresden", "Cologne"}},
+      {"Portugal",    {"Lisbon", "Porto", "Faro"}},
+      {"Croatia",     {"Dubrovnik", "Split", "Zagreb"}},
+      {"Austria",     {"Vienna", "Salzburg", "Graz"}},
+      {"Netherlands", {"Amsterdam", "Rotterdam", "Utrecht"}},
+      {"Hungary",     {"Budapest", "Debrecen"}},
+      {"UK",          {"London", "Edinburgh", "Manchester"}},
+      {"Georgia",     {"Tbilisi", "Batumi", "Kutaisi"}},
+      {"Thailand",    {"Bangkok", "Phuket", "Chiang-Mai"}},
+      {"Japan",       {"Tokyo", "Kyoto", "Osaka"}},
+      {"USA",         {"New-York", "Miami", "Chicago", "San-Francisco"}}
+   };
+
+   const std::vector<Region> skiRegions =
+   {
+      {"Austria",     {"Ischgl", "Kitzbuhel", "Solden", "Mayrhofen", "St-Anton"}},
+      {"France",      {"Chamonix", "Courchevel", "Val-Thorens", "Tignes"}},
+      {"Ukraine",     {"Bukovel", "Dragobrat", "Slavske"}},
+      {"Switzerland", {"Zermatt", "Verbier", "St-Moritz", "Davos"}},
+      {"Italy",       {"Livigno", "Cortina", "Val-Gardena"}},
+      {"Andorra",     {"Soldeu", "Pas-de-la-Casa"}},
+      {"Poland",      {"Zakopane", "Szczyrk"}},
+      {"Georgia",     {"Gudauri", "Bakuriani"}},
+      {"Bulgaria",    {"Bansko", "Borovets"}},
+      {"Slovakia",    {"Jasna", "Tatranska-Lomnica"}}
+   };
+
+   const char* const accommodations[] = {"Hotel", "Apartment", "Hostel", "Guesthouse"};
+   const int accommodationWeights[] = {60, 20, 12, 8};
+
+   const char* const transports[] = {"Plane", "Bus", "Train"};
+   const int transportWeights[] = {55, 30, 15};
+
+   const char* const hotelLevels[] = {"1*", "2*", "3*", "4*", "5*"};
+   const int hotelLevelWeights[] = {4, 14, 40, 30, 12};
+
+   const char* const foods[] = {"Breakfast", "HalfBoard", "FullBoard", "AllInclusive", "None"};
+   const int foodWeights[] = {40, 22, 10, 18, 10};
+
+   const char* const extrasList[] = {"None", "Excursion", "Museum-pass", "Transfer", "Guide"};
+   const int extrasWeights[] = {45, 20, 10, 15, 10};
+
+   const char* const difficulties[] = {"Easy", "Medium", "Hard"};
+   const int difficultyWeights[] = {35, 45, 20};
+
+   const int capacities[] = {10, 15, 20, 30, 40, 50, 60};
+   const int capacityWeights[] = {8, 12, 20, 25, 15, 12, 8};
+
+   // Сезонність за місяцями: міські тури влітку та на свята,
+   // гірськолижні — з грудня по березень.
+   const int citySeason[] = {3, 3, 4, 5, 7, 10, 12, 12, 7, 5, 3, 6};
+   const int skiSeason[] = {20, 18, 12, 3, 0, 0, 0, 0, 0, 1, 6, 16};
+
+   /// \brief Кількість днів від 1970-01-01 (алгоритм Г. Гіннанта).
+   std::int64_t daysFromCivil(int year, int month, int day)
+   {
+      year -= month <= 2 ? 1 : 0;
+      const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+      const int yoe = static_cast<int>(year - era * 400);
+      const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+      const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+      return era * 146097 + doe - 719468;
+   }
+
+   std::string formatDate(std::int64_t days)
+   {
+      days += 719468;
+      const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+      const int doe = static_cast<int>(days - era * 146097);
+      const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+      const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+      const int mp = (5 * doy + 2) / 153;
+      const int day = doy - (153 * mp + 2) / 5 + 1;
+      const int month = mp < 10 ? mp + 3 : mp - 9;
+      const std::int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+      char text[32];
+      std::snprintf(text, sizeof(text), "%04d-%02d-%02d",
+         static_cast<int>(year), month, day);
+      return text;
+   }
+
+   /// \brief Згенерований тур; однаковий для того самого зерна й номера.
+   struct TourSpec
+   {
+      bool        ski = false;
+      int         capacity = 0;
+      std::string country;
+      std::string place;
+      std::string departure;
+      std::string returnDate;
+      std::string data; ///< Поле data рядка tours.csv.
+   };
+
+   /// \brief Розподіли, спільні для всіх файлів одного запуску.
+   struct Model
+   {
+      const GeneratorOptions& options;
+      ZipfTable               cityCountries;
+      ZipfTable               skiCountries;
+      std::vector<ZipfTable>  cityPlaces;
+      std::vector<ZipfTable>  skiPlaces;
+      ZipfTable               tourRanks;
+      ZipfTable               userRanks;
+      std::size_t             stride = 1;
+
+      explicit Model(const GeneratorOptions& options)
+         : options(options),
+           cityCountries(cityRegions.size(), options.skew),
+           skiCountries(skiRegions.size(), options.skew),
+           tourRanks(options.tours, options.skew),
+           userRanks(options.users, options.skew)
+      {
+         for (const Region& region : cityRegions)
+         {
+            cityPlaces.emplace_back(region.places.size(), options.skew);
+         }
+
+         for (const Region& region : skiRegions)
+         {
+            skiPlaces.emplace_back(region.places.size(), options.skew);
+         }
+
+         // Популярні ранги розкидаються по всьому каталогу кроком,
+         // взаємно простим із кількістю турів.
+         if (options.tours > 1)
+         {
+            stride = static_cast<std::size_t>(2654435761ULL % options.tours);
+            while (std::gcd(stride, options.tours) != 1)
+            {
+               ++stride;
+            }
+         }
+      }
+
+      std::size_t popularTour(Random& random) const
+      {
+         return tourRanks.sample(random) * stride % options.tours;
+      }
+
+      std::size_t activeUser(Random& random) const
+      {
+         return userRanks.sample(random);
+      }
+
+      TourSpec tour(std::size_t id) const
+      {
+         Random random(options.seed ^ (0xd1b54a32d192ed03ULL * (id + 1)));
+         TourSpec spec;
+
+         spec.capacity = capacities[pickWeighted(random, capacityWeights)];
+         spec.ski = random.chance(options.skiShare);
+
+         const std::vector<Region>& regions = spec.ski ? skiRegions : cityRegions;
+         const std::size_t country =
+            (spec.ski ? skiCountries : cityCountries).sample(random);
+         const std::size_t place =
+            (spec.ski ? skiPlaces : cityPlaces)[country].sample(random);
+
+         spec.country = regions[country].country;
+         spec.place = regions[country].places[place];
+
+         const int year = 2025 + static_cast<int>(random.below(2));
+         const int month = 1 + static_cast<int>(
+            spec.ski ? pickWeighted(random, skiSeason)
+                     : pickWeighted(random, citySeason));
+         const std::int64_t first = daysFromCivil(year, month, 1);
+         const std::int64_t monthDays = (month == 12
+            ? daysFromCivil(year + 1, 1, 1)
+            : daysFromCivil(year, month + 1, 1)) - first;
+         const std::int64_t departure =
+            first + static_cast<std::int64_t>(random.below(
+               static_cast<std::size_t>(monthDays)));
+         const std::int64_t nights =
+            (spec.ski ? 5 : 2) + static_cast<std::int64_t>(random.below(spec.ski ? 6 : 9));
+
+         spec.departure = formatDate(departure);
+         spec.returnDate = formatDate(departure + nights);
+
+         // Логнормальна ціна за ніч, помножена на тривалість.
+         double price = 0.0;
+         std::string& data = spec.data;
+
+         if (spec.ski)
+         {
+            const std::size_t difficulty = pickWeighted(random, difficultyWeights);
+            const bool equipment = random.chance(0.6);
+            const bool insurance = random.chance(0.7);
+
+            price = std::exp(4.6 + 0.45 * random.normal())
+               * static_cast<double>(nights)
+               * (equipment ? 1.25 : 1.0) * (insurance ? 1.05 : 1.0);
+
+            data = spec.country + ',' + spec.place + ','
+               + difficulties[difficulty] + ','
+               + (equipment ? "1" : "0") + ',' + (insurance ? "1" : "0") + ','
+               + spec.departure + ',' + spec.returnDate + ',';
+         }
+         else
+         {
+            const std::size_t level = pickWeighted(random, hotelLevelWeights);
+
+            price = std::exp(3.9 + 0.55 * random.normal())
+               * static_cast<double>(nights)
+               * (0.6 + 0.25 * static_cast<double>(level + 1));
+
+            data = spec.country + ',' + spec.place + ','
+               + accommodations[pickWeighted(random, accommodationWeights)] + ','
+               + transports[pickWeighted(random, transportWeights)] + ','
+               + spec.departure + ',' + spec.returnDate + ','
+               + hotelLevels[level] + ','
+               + foods[pickWeighted(random, foodWeights)] + ','
+               + extrasList[pickWeighted(random, extrasWeights)] + ',';
+         }
+
+         data += std::to_string(static_cast<long long>(std::llround(price)));
+         return spec;
+      }
+   };
+
+   std::ofstream openOutput(const std::string& path)
+   {
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+      if (!file)
+      {
+         throw FileException("Не вдалося створити файл: " + path);
+      }
+
+      return file;
+   }
+
+   void closeOutput(std::ofstream& file, const std::string& path)
+   {
+      file.close();
+      if (!file)
+      {
+         throw FileException("Не вдалося записати файл: " + path);
+      }
+   }
+
+   /// \brief Псує рядок туру одним із типових способів.
+   std::string corruptTour(Random& random, const std::string& type,
+      std::size_t id, const TourSpec& spec)
+   {
+      const std::string number = std::to_string(id);
+      const std::string capacity = std::to_string(spec.capacity);
+
+      switch (random.below(8))
+      {
+         case 0:
+         {
+            // Обрізаний рядок: бракує останніх полів.
+            const std::size_t comma = spec.data.find(',', spec.data.size() / 2);
+            return type + ',' + number + ',' + capacity + ",0,"
+               + spec.data.substr(0, comma);
+         }
+
+         case 1:
+         {
+            const std::size_t comma = spec.data.rfind(',');
+            return type + ',' + number + ',' + capacity + ",0,"
+               + spec.data.substr(0, comma + 1) + "free";
+         }
+
+         case 2:
+            return "cruise," + number + ',' + capacity + ",0," + spec.data;
+
+         case 3:
+            return type + ',' + number + ",many,0," + spec.data;
+
+         case 4:
+            return type + ',' + number + ',' + capacity + ','
+               + std::to_string(spec.capacity + 1 + static_cast<int>(random.below(5)))
+               + ',' + spec.data;
+
+         case 5:
+            return type + ',' + std::to_string(id == 0 ? 0 : id - 1) + ','
+               + capacity + ",0," + spec.data;
+
+         case 6:
+            return type + ",t" + number + ',' + capacity + ",0," + spec.data;
+
+         default:
+            return type + ',' + number;
+      }
+   }
+}
+
+DataGenerator::DataGenerator(GeneratorOptions options)
+   : options(std::move(options))
+{
+}
+
+GeneratorReport DataGenerator::run()
+{
+   GeneratorReport report;
+   const Model model(options);
+   const std::string directory =
+      options.directory.empty() ? std::string(".") : options.directory;
+
+   // Кожен файл має власний потік випадкових чисел, тож зміна обсягу
+   // одного файлу не зсуває вміст інших.
+   Random userRandom(options.seed * 4 + 1);
+   Random ticketRandom(options.seed * 4 + 2);
+   Random tourRandom(options.seed * 4 + 3);
+   Random workloadRandom(options.seed * 4 + 4);
+
+   const std::string usersPath = directory + "/users.txt";
+   std::ofstream users = openOutput(usersPath);
+   users << "admin:admin\n";
+   ++report.users;
+
+   for (std::size_t i = 0; i < options.users; ++i)
+   {
+      const std::string name = "user" + std::to_string(i);
+
+      if (userRandom.chance(options.dirtyRate))
+      {
+         switch (userRandom.below(3))
+         {
+            case 0:
+               users << name << '\n';
+               break;
+            case 1:
+               users << name << ":\n";
+               break;
+            default:
+               users << "user" << (i == 0 ? 0 : i - 1) << ":dup" << i << '\n';
+               break;
+         }
+         ++report.dirtyRows;
+      }
+      else
+      {
+         users << name << ":pw" << i << '\n';
+      }
+
+      ++report.users;
+   }
+
+   closeOutput(users, usersPath);
+
+   // Квитки генеруються раніше за тури, бо стовпець sold має збігатися
+   // з кількістю квитків на тур.
+   std::vector<std::uint16_t> sold(options.tours, 0);
+
+   const std::string ticketsPath = directory + "/tickets.txt";
+   std::ofstream tickets = openOutput(ticketsPath);
+
+   for (std::size_t i = 0; i < options.tickets && options.tours != 0
+        && options.users != 0; ++i)
+   {
+      const std::string user =
+         "user" + std::to_string(model.activeUser(ticketRandom));
+
+      if (ticketRandom.chance(options.dirtyRate))
+      {
+         const std::size_t id = model.popularTour(ticketRandom);
+         const TourSpec spec = model.tour(id);
+
+         switch (ticketRandom.below(3))
+         {
+            case 0:
+               tickets << user << ',' << id << ',' << spec.country << ','
+                       << spec.place << ',' << spec.departure << '\n';
+               break;
+            case 1:
+               tickets << user << ',' << options.tours + ticketRandom.below(1000)
+                       << ',' << spec.country << ',' << spec.place << ','
+                       << spec.departure << ',' << spec.returnDate << ",100\n";
+               break;
+            default:
+               tickets << user << ',' << id << ',' << spec.country << ','
+                       << spec.place << ',' << spec.departure << ','
+                       << spec.returnDate << ",n/a\n";
+               break;
+         }
+
+         ++report.tickets;
+         ++report.dirtyRows;
+         continue;
+      }
+
+      // Розпродані тури пропускаються; після кількох спроб квиток
+      // не генерується зовсім.
+      for (int attempt = 0; attempt < 8; ++attempt)
+      {
+         const std::size_t id = model.popularTour(ticketRandom);
+         const TourSpec spec = model.tour(id);
+
+         if (sold[id] >= spec.capacity)
+         {
+            continue;
+         }
+
+         ++sold[id];
+         const std::size_t comma = spec.data.rfind(',');
+         tickets << user << ',' << id << ',' << spec.country << ','
+                 << spec.place << ',' << spec.departure << ','
+                 << spec.returnDate << ',' << spec.data.substr(comma + 1) << '\n';
+         ++report.tickets;
+         break;
+      }
+   }
+
+   closeOutput(tickets, ticketsPath);
+
+   const std::string toursPath = directory + "/tours.csv";
+   std::ofstream tours = openOutput(toursPath);
+   tours << "type,id,capacity,sold,data\n";
+
+   for (std::size_t id = 0; id < options.tours; ++id)
+   {
+      const TourSpec spec = model.tour(id);
+      const std::string type = spec.ski ? "ski" : "city";
+
+      if (tourRandom.chance(options.dirtyRate))
+      {
+         tours << corruptTour(tourRandom, type, id, spec) << '\n';
+         ++report.dirtyRows;
+      }
+      else
+      {
+         tours << type << ',' << id << ',' << spec.capacity << ','
+               << sold[id] << ',' << spec.data << '\n';
+      }
+
+      ++report.tours;
+   }
+
+   closeOutput(tours, toursPath);
+
+   const std::string workloadPath = directory + "/workload.txt";
+   std::ofstream workload = openOutput(workloadPath);
+
+   const int commandWeights[] = {45, 15, 10, 10, 15, 5};
+
+   for (std::size_t session = 0; session < options.sessions
+        && options.tours != 0 && options.users != 0; ++session)
+   {
+      const std::size_t user = model.activeUser(workloadRandom);
+      workload << "login user" << user << " pw" << user << '\n';
+      ++report.commands;
+
+      for (std::size_t k = 0; k < options.sessionLength; ++k)
+      {
+         ++report.commands;
+
+         if (workloadRandom.chance(options.dirtyRate))
+         {
+            switch (workloadRandom.below(3))
+            {
+               case 0:
+                  workload << "book x" << k << '\n';
+                  break;
+               case 1:
+                  workload << "get " << options.tours + k << '\n';
+                  break;
+               default:
+                  workload << "frobnicate\n";
+                  break;
+            }
+            ++report.dirtyRows;
+            continue;
+         }
+
+         const std::size_t id = model.popularTour(workloadRandom);
+
+         switch (pickWeighted(workloadRandom, commandWeights))
+         {
+            case 0:
+               workload << "get " << id << '\n';
+               break;
+            case 1:
+               workload << "query country " << model.tour(id).country << '\n';
+               break;
+            case 2:
+               workload << "query city " << model.tour(id).place << '\n';
+               break;
+            case 3:
+               workload << "query maxprice "
+                        << 200 * (1 + workloadRandom.below(10)) << '\n';
+               break;
+            case 4:
+               workload << "book " << id << " key=w" << session << '-' << k << '\n';
+               break;
+            default:
+               workload << "tickets\n";
+               break;
+         }
+      }
+   }
+
+   closeOutput(workload, workloadPath);
+   return report;
+}
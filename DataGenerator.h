@@ -0,0 +1,69 @@
+// DataGenerator.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// \file DataGenerator.h
+/// \brief Генератор синтетичного каталогу, користувачів і навантаження.
+
+/// \brief Параметри генерації.
+struct GeneratorOptions
+{
+   std::string   directory = "data"; ///< Каталог для вихідних файлів.
+   std::size_t   tours = 10000;      ///< Кількість рядків tours.csv.
+   std::size_t   users = 1000;       ///< Кількість користувачів (крім admin).
+   std::size_t   tickets = 50000;    ///< Кількість рядків tickets.txt.
+   std::size_t   sessions = 1000;    ///< Кількість сесій у workload.txt.
+   std::size_t   sessionLength = 20; ///< Команд у сесії після входу.
+   std::uint64_t seed = 1;           ///< Зерно; однакове зерно дає однакові файли.
+   double        skew = 1.0;         ///< Показник Zipf для популярності.
+   double        skiShare = 0.3;     ///< Частка гірськолижних турів.
+   double        dirtyRate = 0.0;    ///< Частка зіпсованих рядків у кожному файлі.
+};
+
+/// \brief Підсумок генерації.
+struct GeneratorReport
+{
+   std::size_t tours = 0;     ///< Записано рядків турів.
+   std::size_t users = 0;     ///< Записано рядків користувачів.
+   std::size_t tickets = 0;   ///< Записано рядків квитків.
+   std::size_t commands = 0;  ///< Записано команд навантаження.
+   std::size_t dirtyRows = 0; ///< З них навмисно зіпсованих.
+};
+
+/// \class DataGenerator
+/// \brief Детерміновано генерує реалістичні файли даних великого розміру.
+/// \details Створює в каталозі:
+/// - `tours.csv` — тури city/ski у форматі TourManager::load();
+/// - `users.txt` — admin та користувачі `user<N>` з паролем `pw<N>`;
+/// - `tickets.txt` — квитки у форматі TicketStore::importText();
+/// - `workload.txt` — сценарій пакетного режиму з сесіями користувачів.
+///
+/// Країни, міста й тури обираються за законом Zipf, дати відправлення
+/// сезонні (літо й грудень для міських турів, грудень–березень для
+/// гірськолижних), ціни мають логнормальний розподіл. Рівні готелю та
+/// складність беруться лише з допустимих значень. Кількість проданих місць
+/// у tours.csv збігається з квитками в tickets.txt і не перевищує місткості.
+///
+/// Генератор випадкових чисел і розподіли власні, тож результат задається
+/// зерном, а не реалізацією <random> у стандартній бібліотеці. Параметр
+/// dirtyRate додає зіпсовані рядки (обрізані, з некоректними числами,
+/// невідомими типами, дублікатами ідентифікаторів), щоб навантажити гілки
+/// обробки помилок.
+class DataGenerator
+{
+public:
+   /// \brief Створює генератор.
+   /// \param options Параметри генерації.
+   explicit DataGenerator(GeneratorOptions options);
+
+   /// \brief Генерує всі файли.
+   /// \return Підсумок генерації.
+   /// \throws FileException Якщо файл не вдається створити або записати.
+   GeneratorReport run();
+
+private:
+   GeneratorOptions options;
+};
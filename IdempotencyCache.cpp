@@ -0,0 +1,149 @@
+// IdempotencyCache.cpp
+
+#include "IdempotencyCache.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+IdempotencyCache::IdempotencyCache(std::size_t capacity,
+   std::chrono::seconds retention,
+   std::size_t stripes)
+   : table(new Stripe[std::max<std::size_t>(stripes, 1)]),
+     stripeCount(std::max<std::size_t>(stripes, 1)),
+     stripeCapacity(std::max<std::size_t>(capacity / stripeCount, 1)),
+     retention(retention)
+{
+}
+
+IdempotencyCache::Stripe& IdempotencyCache::stripeFor(const std::string& key) const
+{
+   return table[std::hash<std::string>{}(key) % stripeCount];
+}
+
+IdempotencyCache::Claim IdempotencyCache::claim(const std::string& key,
+   SlotId tourId,
+   Ticket& original)
+{
+   Stripe& stripe = stripeFor(key);
+   std::unique_lock<std::mutex> lock(stripe.mutex);
+
+   while (true)
+   {
+      const Clock::time_point now = Clock::now();
+      evictLocked(stripe, now);
+
+      auto found = stripe.entries.find(key);
+      if (found == stripe.entries.end())
+      {
+         Entry& entry = stripe.entries[key];
+         entry.tourId = tourId;
+         return Claim::Acquired;
+      }
+
+      Entry& entry = found->second;
+      if (entry.pending)
+      {
+         stripe.settled.wait(lock);
+         continue;
+      }
+
+      if (entry.tourId != tourId)
+      {
+         return Claim::Mismatch;
+      }
+
+      original = entry.ticket;
+      return Claim::Replay;
+   }
+}
+
+void IdempotencyCache::complete(const std::string& key, const Ticket& ticket)
+{
+   Stripe& stripe = stripeFor(key);
+   {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+
+      auto found = stripe.entries.find(key);
+      if (found == stripe.entries.end())
+      {
+         return;
+      }
+
+      found->second.pending = false;
+      found->second.ticket = ticket;
+      found->second.completedAt = Clock::now();
+      stripe.order.push_back(key);
+      evictLocked(stripe, found->second.completedAt);
+   }
+
+   stripe.settled.notify_all();
+}
+
+IdempotencyCache::Lease::Lease(IdempotencyCache& cache, std::string key)
+   : cache(cache),
+     key(std::move(key))
+{
+}
+
+IdempotencyCache::Lease::~Lease()
+{
+   if (!completed)
+   {
+      cache.abandon(key);
+   }
+}
+
+void IdempotencyCache::Lease::complete(const Ticket& ticket)
+{
+   cache.complete(key, ticket);
+   completed = true;
+}
+
+void IdempotencyCache::abandon(const std::string& key)
+{
+   Stripe& stripe = stripeFor(key);
+   {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      stripe.entries.erase(key);
+   }
+
+   stripe.settled.notify_all();
+}
+
+std::size_t IdempotencyCache::size() const
+{
+   std::size_t total = 0;
+
+   for (std::size_t i = 0; i < stripeCount; ++i)
+   {
+      std::lock_guard<std::mutex> lock(table[i].mutex);
+      total += table[i].entries.size();
+   }
+
+   return total;
+}
+
+void IdempotencyCache::evictLocked(Stripe& stripe, Clock::time_point now)
+{
+   // У order лише завершені ключі в порядку завершення, тому досить
+   // перевіряти найстаріший.
+   while (!stripe.order.empty())
+   {
+      auto found = stripe.entries.find(stripe.order.front());
+
+      const bool stale = found == stripe.entries.end() || found->second.pending;
+      const bool expired = !stale && now - found->second.completedAt >= retention;
+
+      if (!stale && !expired && stripe.order.size() <= stripeCapacity)
+      {
+         break;
+      }
+
+      if (!stale)
+      {
+         stripe.entries.erase(found);
+      }
+      stripe.order.pop_front();
+   }
+}
@@ -0,0 +1,122 @@
+// IdempotencyCache.h
+#pragma once
+
+#include "Ticket.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// \file IdempotencyCache.h
+/// \brief Ключі ідемпотентності для повторних запитів бронювання.
+
+/// \class IdempotencyCache
+/// \brief Пам'ятає результати бронювань за ключами ідемпотентності.
+/// \details Таблиця розбита на незалежні сегменти з власними м'ютексами,
+/// тож запити з різними ключами майже ніколи не конкурують. Перевірка
+/// повтору — один пошук у хеш-таблиці сегмента.
+///
+/// Зберігання обмежене: кожен сегмент тримає не більше capacity / stripes
+/// завершених ключів (найстаріші витісняються) і забуває ключі, старші за
+/// retention. Поки бронювання з ключем виконується, інші запити з тим самим
+/// ключем чекають на його результат.
+class IdempotencyCache
+{
+public:
+   /// \brief Результат спроби зайняти ключ.
+   enum class Claim
+   {
+      Acquired, ///< Ключ новий; викликач має завершити complete() або abandon() (див. Lease).
+      Replay,   ///< Запит уже виконано; повернуто початковий квиток.
+      Mismatch  ///< Ключ уже використано для іншого туру.
+   };
+
+   /// \class Lease
+   /// \brief Ключ, зайнятий через claim(), який звільняється, якщо
+   /// бронювання не завершилося.
+   /// \details Деструктор викликає abandon() на кожному шляху, де не було
+   /// complete(), зокрема під час винятку, тож запити з тим самим ключем
+   /// не чекають вічно на незавершений ключ.
+   class Lease
+   {
+   public:
+      /// \brief Бере під контроль ключ зі статусом Claim::Acquired.
+      Lease(IdempotencyCache& cache, std::string key);
+
+      /// \brief Звільняє ключ, якщо complete() не викликано.
+      ~Lease();
+
+      Lease(const Lease&) = delete;
+      Lease& operator=(const Lease&) = delete;
+
+      /// \brief Запам'ятовує успішний результат ключа.
+      /// \param ticket Оформлений квиток.
+      void complete(const Ticket& ticket);
+
+   private:
+      IdempotencyCache& cache;
+      std::string       key;
+      bool              completed = false;
+   };
+
+   /// \brief Створює кеш.
+   /// \param capacity Загальна кількість збережених ключів.
+   /// \param retention Скільки пам'ятати завершений ключ.
+   /// \param stripes Кількість сегментів.
+   explicit IdempotencyCache(std::size_t capacity = 1 << 16,
+      std::chrono::seconds retention = std::chrono::hours(24),
+      std::size_t stripes = 64);
+
+   /// \brief Займає ключ або повертає збережений результат.
+   /// \details Якщо ключ зайнятий незавершеним запитом, чекає на нього.
+   /// \param key Ключ ідемпотентності (унікальний у межах користувача).
+   /// \param tourId Тур, який бронюється з цим ключем.
+   /// \param original Отримує початковий квиток для Claim::Replay.
+   /// \return Результат спроби.
+   Claim claim(const std::string& key, SlotId tourId, Ticket& original);
+
+   /// \brief Запам'ятовує успішний результат зайнятого ключа.
+   /// \param key Ключ, зайнятий через claim().
+   /// \param ticket Оформлений квиток.
+   void complete(const std::string& key, const Ticket& ticket);
+
+   /// \brief Звільняє ключ після невдалого бронювання.
+   /// \details Наступний запит з цим ключем виконається заново.
+   /// \param key Ключ, зайнятий через claim().
+   void abandon(const std::string& key);
+
+   /// \brief Повертає кількість ключів у кеші.
+   std::size_t size() const;
+
+private:
+   using Clock = std::chrono::steady_clock;
+
+   struct Entry
+   {
+      SlotId            tourId = 0;
+      bool              pending = true;
+      Ticket            ticket;
+      Clock::time_point completedAt;
+   };
+
+   struct alignas(64) Stripe
+   {
+      mutable std::mutex                     mutex;
+      std::condition_variable                settled;
+      std::unordered_map<std::string, Entry> entries;
+      std::deque<std::string>                order; ///< Завершені ключі від найстарішого.
+   };
+
+   std::unique_ptr<Stripe[]> table;
+   std::size_t               stripeCount;
+   std::size_t               stripeCapacity;
+   Clock::duration           retention;
+
+   Stripe& stripeFor(const std::string& key) const;
+   void evictLocked(Stripe& stripe, Clock::time_point now);
+};
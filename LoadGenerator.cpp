@@ -0,0 +1,646 @@
+// LoadGenerator.cpp
+
+#include "LoadGenerator.h"
+#include "DataGenerator.h"
+#include "FileException.h"
+#include "Metrics.h"
+#include "Random.h"
+#include "ReportFormat.h"
+#include "TourManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+   using Clock = std::chrono::steady_clock;
+
+   /// \brief Види операцій навантаження.
+   enum class LoadOperation
+   {
+      Query,
+      Filter,
+      Get,
+      Sort,
+      Edit,
+      Book,
+      Count
+   };
+
+   constexpr std::size_t operationCount =
+      static_cast<std::size_t>(LoadOperation::Count);
+
+   const char* const operationNames[] =
+   {
+      "query",
+      "filter",
+      "get",
+      "sort",
+      "edit",
+      "book"
+   };
+
+   static_assert(sizeof(operationNames) / sizeof(operationNames[0])
+         == operationCount,
+      "Кожна операція навантаження повинна мати назву");
+
+   /// \brief Скільки порушень включати у звіт дослівно.
+   constexpr std::size_t maxReportedViolations = 100;
+
+   /// \brief Скільки разів повторювати правку, яку випередив інший потік.
+   constexpr unsigned maxEditAttempts = 64;
+
+   /// \brief Поля туру, з яких будуються запити.
+   struct TourInfo
+   {
+      std::string country;
+      std::string city;
+      std::string level;
+      std::string month; ///< YYYY-MM дати відправлення.
+      double      price = 0.0;
+   };
+
+   /// \brief Незмінний стан, спільний для всіх потоків.
+   struct Shared
+   {
+      const LoadOptions&              options;
+      TourManager&                    catalog;
+      const std::vector<TourId>&      ids;
+      const std::vector<TourInfo>&    info;
+      const std::vector<std::size_t>& popular; ///< Індекси турів за спаданням популярності.
+      const ZipfTable&                zipf;
+      unsigned                        weights[operationCount];
+      unsigned                        totalWeight;
+      Clock::time_point               start;
+      Clock::time_point               deadline;
+   };
+
+   /// \brief Результати одного потоку; зводяться після завершення.
+   struct WorkerResult
+   {
+      std::vector<std::uint64_t> latencyNs[operationCount];
+      std::vector<std::uint64_t> serviceNs[operationCount];
+      std::uint64_t              errors[operationCount] = {};
+      std::uint64_t              booked = 0;
+      std::uint64_t              soldOut = 0;
+      std::uint64_t              conflicts = 0;
+      std::vector<std::uint32_t> bookings; ///< Успішні бронювання за індексом туру.
+      std::vector<std::uint32_t> edits;    ///< Успішні правки за індексом туру.
+      std::vector<std::string>   violations;
+      std::size_t                violationCount = 0;
+
+      void violation(const std::string& text)
+      {
+         if (violations.size() < maxReportedViolations)
+         {
+            violations.push_back(text);
+         }
+         ++violationCount;
+      }
+   };
+
+   void writePercentiles(std::ostream& out,
+      const std::vector<std::uint64_t>& sorted)
+   {
+      out << "{\"p50\":" << percentile(sorted, 0.50)
+          << ",\"p90\":" << percentile(sorted, 0.90)
+          << ",\"p99\":" << percentile(sorted, 0.99)
+          << ",\"p999\":" << percentile(sorted, 0.999)
+          << ",\"max\":" << (sorted.empty() ? 0 : sorted.back()) << '}';
+   }
+
+   std::uint64_t toNanoseconds(Clock::duration elapsed)
+   {
+      const auto count =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+      return count > 0 ? static_cast<std::uint64_t>(count) : 0;
+   }
+
+   LoadOperation pickOperation(const Shared& shared, Random& random)
+   {
+      std::size_t roll = random.below(shared.totalWeight);
+      for (std::size_t op = 0; op < operationCount; ++op)
+      {
+         if (roll < shared.weights[op])
+         {
+            return static_cast<LoadOperation>(op);
+         }
+         roll -= shared.weights[op];
+      }
+      return LoadOperation::Get;
+   }
+
+   /// \brief Виконує одну операцію.
+   /// \return false, якщо каталог повернув помилку.
+   bool perform(const Shared& shared, std::size_t thread, LoadOperation op,
+      Random& random, WorkerResult& result)
+   {
+      TourManager& catalog = shared.catalog;
+      const std::size_t index = shared.popular[shared.zipf.sample(random)];
+      const TourInfo& tour = shared.info[index];
+
+      switch (op)
+      {
+         case LoadOperation::Query:
+            catalog.findTours(random.chance(0.5)
+               ? TourQuery::byCountry(tour.country)
+               : TourQuery::byCity(tour.city));
+            return true;
+
+         case LoadOperation::Filter:
+         {
+            const std::size_t kind = random.below(3);
+            catalog.findTours(kind == 0 ? TourQuery::byHotelLevel(tour.level)
+               : kind == 1 ? TourQuery::byMaxPrice(tour.price)
+               : TourQuery::byDateRange(tour.month + "-01",
+                    tour.month + "-31"));
+            return true;
+         }
+
+         case LoadOperation::Get:
+            return catalog.getTour(shared.ids[index]).ok();
+
+         case LoadOperation::Sort:
+            return catalog.sortTours(random.chance(0.5)
+               ? SortKey::Price
+               : SortKey::DepartureDate).ok();
+
+         case LoadOperation::Edit:
+         {
+            // Усі потоки редагують ті самі популярні тури. Правка збільшує
+            // ціну на 1 і замінює тур, лише якщо його не змінили після
+            // прочитання (replaceTour з expected); випереджена правка
+            // повторюється. Тож кожна успішна правка мусить залишити слід
+            // у підсумковій ціні.
+            const TourId id = shared.ids[index];
+
+            for (unsigned attempt = 0; attempt < maxEditAttempts; ++attempt)
+            {
+               const Result<std::shared_ptr<const Tour>> original =
+                  catalog.getTour(id);
+               if (!original.ok())
+               {
+                  return false;
+               }
+
+               const double price = original.value()->getPrice() + 1.0;
+               TourPatch patch;
+               patch.price = price;
+
+               std::shared_ptr<Tour> edited = original.value()->clone();
+               if (!edited->applyPatch(patch).ok())
+               {
+                  return false;
+               }
+
+               const Result<void> replaced =
+                  catalog.replaceTour(id, std::move(edited), original.value());
+               if (!replaced.ok())
+               {
+                  if (replaced.error().code != ErrorCode::Conflict)
+                  {
+                     return false;
+                  }
+                  ++result.conflicts;
+                  continue;
+               }
+
+               ++result.edits[index];
+
+               // Інші потоки можуть лише збільшити ціну далі.
+               const Result<std::shared_ptr<const Tour>> reread =
+                  catalog.getTour(id);
+               if (!reread.ok() || reread.value()->getPrice() < price)
+               {
+                  std::ostringstream text;
+                  text << "потік " << thread
+                       << " не прочитав власну правку туру " << index
+                       << ": записано " << price << ", прочитано "
+                       << (reread.ok() ? reread.value()->getPrice() : -1.0);
+                  result.violation(text.str());
+               }
+               return true;
+            }
+
+            return false;
+         }
+
+         case LoadOperation::Book:
+         {
+            const Result<Ticket> booking = catalog.bookTour(
+               "load" + std::to_string(thread), shared.ids[index]);
+            if (booking.ok())
+            {
+               ++result.booked;
+               ++result.bookings[index];
+               return true;
+            }
+            if (booking.error().code == ErrorCode::SoldOut)
+            {
+               ++result.soldOut;
+               return true;
+            }
+            return false;
+         }
+
+         case LoadOperation::Count:
+            break;
+      }
+
+      return true;
+   }
+
+   void work(const Shared& shared, std::size_t thread, WorkerResult& result)
+   {
+      const LoadOptions& options = shared.options;
+      Random random(options.seed * 0x9e3779b97f4a7c15ULL + thread + 1);
+
+      const bool open = options.rate > 0.0;
+      const double perThread =
+         options.rate / static_cast<double>(options.threads);
+      Clock::time_point intended = shared.start;
+
+      std::this_thread::sleep_until(shared.start);
+
+      for (;;)
+      {
+         if (open)
+         {
+            // Пуассонівський потік: експоненційні проміжки між надходженнями.
+            intended += std::chrono::duration_cast<Clock::duration>(
+               std::chrono::duration<double>(
+                  -std::log(1.0 - random.uniform()) / perThread));
+            if (intended >= shared.deadline)
+            {
+               break;
+            }
+            std::this_thread::sleep_until(intended);
+         }
+         else
+         {
+            intended = Clock::now();
+            if (intended >= shared.deadline)
+            {
+               break;
+            }
+         }
+
+         const LoadOperation op = pickOperation(shared, random);
+         const std::size_t slot = static_cast<std::size_t>(op);
+
+         const Clock::time_point started = Clock::now();
+         const bool succeeded =
+            perform(shared, thread, op, random, result);
+         const Clock::time_point finished = Clock::now();
+
+         if (!succeeded)
+         {
+            ++result.errors[slot];
+         }
+         result.latencyNs[slot].push_back(toNanoseconds(finished - intended));
+         result.serviceNs[slot].push_back(toNanoseconds(finished - started));
+      }
+   }
+}
+
+LoadGenerator::LoadGenerator(LoadOptions options)
+   : options(std::move(options))
+{
+}
+
+std::string LoadGenerator::prepare() const
+{
+   const std::string directory =
+      options.directory + "/tours-" + std::to_string(options.tours);
+   const std::string marker = directory + "/generated.txt";
+   const std::string expected =
+      std::to_string(options.tours) + ' ' + std::to_string(options.seed);
+
+   {
+      std::ifstream existing(marker);
+      std::string content;
+      if (existing && std::getline(existing, content) && content == expected)
+      {
+         return directory;
+      }
+   }
+
+   std::error_code ec;
+   std::filesystem::create_directories(directory, ec);
+   if (ec)
+   {
+      throw FileException("Не вдалося створити каталог: " + directory);
+   }
+
+   std::cerr << "Генерація каталогу на " << options.tours << " турів...\n";
+
+   GeneratorOptions generator;
+   generator.directory = directory;
+   generator.tours = options.tours;
+   generator.users = 1;
+   generator.tickets = 0;
+   generator.sessions = 0;
+   generator.seed = options.seed;
+   DataGenerator(generator).run();
+
+   std::ofstream(marker) << expected << '\n';
+   return directory;
+}
+
+std::size_t LoadGenerator::run(std::ostream& out)
+{
+   const std::string directory = prepare();
+   const std::string ticketsPath = directory + "/load-tickets.bin";
+   const std::string waitlistPath = directory + "/load-waitlist.log";
+
+   std::error_code ec;
+   std::filesystem::remove(ticketsPath, ec);
+   std::filesystem::remove(waitlistPath, ec);
+
+   LedgerOptions ledger;
+   ledger.syncPolicy = options.sync;
+
+   TourManager catalog(directory + "/tours.csv", ticketsPath, waitlistPath,
+      ledger);
+   catalog.load();
+
+   const std::vector<TourId> ids = catalog.findTours(TourQuery::all());
+   if (ids.empty())
+   {
+      throw FileException("Каталог для навантаження порожній: " + directory);
+   }
+
+   // Стан до навантаження, з яким звіряється результат.
+   std::vector<TourInfo> info(ids.size());
+   std::vector<int> soldBefore(ids.size());
+   std::vector<std::uint64_t> ticketsBefore(ids.size());
+
+   for (std::size_t i = 0; i < ids.size(); ++i)
+   {
+      const std::shared_ptr<const Tour> tour = catalog.getTour(ids[i]).value();
+      info[i].country = tour->getCountry();
+      info[i].city = tour->getCity();
+      info[i].level = tour->getHotelLevel();
+      info[i].month = tour->getDepartureDate().substr(0, 7);
+      info[i].price = tour->getPrice();
+
+      const SeatInventory::Counts seats = catalog.getSeats(ids[i]).value();
+      soldBefore[i] = seats.capacity - seats.available;
+      ticketsBefore[i] = catalog.seatsSold(ids[i]);
+   }
+
+   // Популярність не пов'язана з порядком у файлі.
+   Random random(options.seed);
+   std::vector<std::size_t> popular(ids.size());
+   for (std::size_t i = 0; i < popular.size(); ++i)
+   {
+      popular[i] = i;
+   }
+   for (std::size_t i = popular.size(); i > 1; --i)
+   {
+      std::swap(popular[i - 1], popular[random.below(i)]);
+   }
+
+   const ZipfTable zipf(ids.size(), options.skew);
+   const std::size_t threads = std::max<std::size_t>(options.threads, 1);
+   LoadOptions effective = options;
+   effective.threads = threads;
+
+   const auto startDelay = std::chrono::milliseconds(50);
+   const Clock::time_point start = Clock::now() + startDelay;
+   Shared shared{effective, catalog, ids, info, popular, zipf,
+      {options.query, options.filter, options.get, options.sort,
+       options.edit, options.book},
+      0, start,
+      start + std::chrono::duration_cast<Clock::duration>(
+         std::chrono::duration<double>(options.seconds))};
+
+   for (unsigned weight : shared.weights)
+   {
+      shared.totalWeight += weight;
+   }
+   if (shared.totalWeight == 0)
+   {
+      shared.weights[static_cast<std::size_t>(LoadOperation::Get)] = 1;
+      shared.totalWeight = 1;
+   }
+
+   // Лічильники конкуренції мають описувати лише навантаження.
+   Metrics::reset();
+
+   std::vector<WorkerResult> results(threads);
+   std::vector<std::string> crashes(threads);
+   {
+      std::vector<std::thread> workers;
+      workers.reserve(threads);
+
+      for (std::size_t thread = 0; thread < threads; ++thread)
+      {
+         results[thread].bookings.assign(ids.size(), 0);
+         results[thread].edits.assign(ids.size(), 0);
+         workers.emplace_back([&, thread]
+            {
+               try
+               {
+                  work(shared, thread, results[thread]);
+               }
+               catch (const std::exception& ex)
+               {
+                  crashes[thread] = ex.what();
+               }
+            });
+      }
+
+      for (std::thread& worker : workers)
+      {
+         worker.join();
+      }
+   }
+
+   const Clock::time_point finish = Clock::now();
+   const double wallSeconds = std::chrono::duration<double>(
+      std::max(finish, shared.deadline) - start).count();
+
+   // Зведення результатів потоків.
+   WorkerResult total;
+   total.bookings.assign(ids.size(), 0);
+   total.edits.assign(ids.size(), 0);
+
+   for (std::size_t thread = 0; thread < threads; ++thread)
+   {
+      WorkerResult& part = results[thread];
+
+      for (std::size_t op = 0; op < operationCount; ++op)
+      {
+         total.latencyNs[op].insert(total.latencyNs[op].end(),
+            part.latencyNs[op].begin(), part.latencyNs[op].end());
+         total.serviceNs[op].insert(total.serviceNs[op].end(),
+            part.serviceNs[op].begin(), part.serviceNs[op].end());
+         total.errors[op] += part.errors[op];
+      }
+
+      total.booked += part.booked;
+      total.soldOut += part.soldOut;
+      total.conflicts += part.conflicts;
+      for (std::size_t i = 0; i < ids.size(); ++i)
+      {
+         total.bookings[i] += part.bookings[i];
+         total.edits[i] += part.edits[i];
+      }
+
+      for (const std::string& text : part.violations)
+      {
+         total.violation(text);
+      }
+      total.violationCount += part.violationCount - part.violations.size();
+
+      if (!crashes[thread].empty())
+      {
+         total.violation("потік " + std::to_string(thread)
+            + " завершився винятком: " + crashes[thread]);
+      }
+   }
+
+   std::uint64_t edited = 0;
+   for (std::size_t i = 0; i < ids.size(); ++i)
+   {
+      edited += total.edits[i];
+      if (total.edits[i] == 0)
+      {
+         continue;
+      }
+
+      // Кожна успішна правка додала 1 до ціни; різниця означає, що
+      // правку, про успіх якої повідомлено, перезаписала інша.
+      const Result<std::shared_ptr<const Tour>> tour = catalog.getTour(ids[i]);
+      const double expected =
+         info[i].price + static_cast<double>(total.edits[i]);
+      if (!tour.ok() || std::fabs(tour.value()->getPrice() - expected) > 0.5)
+      {
+         std::ostringstream text;
+         text << "втрачено правки туру " << i << ": успішних правок "
+              << total.edits[i] << ", очікувана ціна " << expected
+              << ", у каталозі "
+              << (tour.ok() ? tour.value()->getPrice() : -1.0);
+         total.violation(text.str());
+      }
+   }
+
+   for (std::size_t i = 0; i < ids.size(); ++i)
+   {
+      const Result<SeatInventory::Counts> seats = catalog.getSeats(ids[i]);
+      if (!seats.ok())
+      {
+         total.violation("тур " + std::to_string(i) + " зник із каталогу");
+         continue;
+      }
+
+      const int sold = seats.value().capacity - seats.value().available;
+      const std::uint64_t tickets =
+         catalog.seatsSold(ids[i]) - ticketsBefore[i];
+
+      if (seats.value().available < 0 || sold > seats.value().capacity)
+      {
+         total.violation("тур " + std::to_string(i) + " перепродано: продано "
+            + std::to_string(sold) + " з "
+            + std::to_string(seats.value().capacity));
+      }
+
+      if (sold - soldBefore[i] != static_cast<int>(total.bookings[i])
+          || tickets != total.bookings[i])
+      {
+         total.violation("тур " + std::to_string(i) + ": успішних бронювань "
+            + std::to_string(total.bookings[i]) + ", місць продано "
+            + std::to_string(sold - soldBefore[i]) + ", квитків "
+            + std::to_string(tickets));
+      }
+   }
+
+   std::uint64_t operations = 0;
+   for (std::size_t op = 0; op < operationCount; ++op)
+   {
+      std::sort(total.latencyNs[op].begin(), total.latencyNs[op].end());
+      std::sort(total.serviceNs[op].begin(), total.serviceNs[op].end());
+      operations += total.latencyNs[op].size();
+   }
+
+   out << "{\"tours\":" << ids.size()
+       << ",\"threads\":" << threads
+       << ",\"mode\":\"" << (options.rate > 0.0 ? "open" : "closed") << '"'
+       << ",\"rate\":" << options.rate
+       << ",\"seconds\":" << options.seconds
+       << ",\"seed\":" << options.seed
+       << ",\"skew\":" << options.skew
+       << ",\"metrics\":" << (Metrics::enabled ? "true" : "false")
+       << ",\"wallSeconds\":" << wallSeconds
+       << ",\"operations\":" << operations
+       << ",\"opsPerSecond\":"
+       << (wallSeconds > 0.0 ? static_cast<double>(operations) / wallSeconds
+                             : 0.0)
+       << ",\n \"ops\":{";
+
+   bool first = true;
+   for (std::size_t op = 0; op < operationCount; ++op)
+   {
+      if (total.latencyNs[op].empty())
+      {
+         continue;
+      }
+
+      out << (first ? "\n  " : ",\n  ") << '"' << operationNames[op]
+          << "\":{\"count\":" << total.latencyNs[op].size()
+          << ",\"errors\":" << total.errors[op]
+          << ",\"latencyNs\":";
+      writePercentiles(out, total.latencyNs[op]);
+      out << ",\"serviceNs\":";
+      writePercentiles(out, total.serviceNs[op]);
+      out << '}';
+      first = false;
+   }
+
+   out << "},\n \"bookings\":{\"booked\":" << total.booked
+       << ",\"soldOut\":" << total.soldOut
+       << ",\"failed\":"
+       << total.errors[static_cast<std::size_t>(LoadOperation::Book)]
+       << "},\n \"edits\":{\"applied\":" << edited
+       << ",\"conflicts\":" << total.conflicts
+       << "},\n \"contention\":{";
+
+   if (Metrics::enabled)
+   {
+      constexpr std::size_t places =
+         static_cast<std::size_t>(Contention::Count);
+      for (std::size_t i = 0; i < places; ++i)
+      {
+         const Contention where = static_cast<Contention>(i);
+         const ContentionStats stats = Metrics::contention(where);
+         out << (i == 0 ? "" : ",") << '"' << Metrics::name(where)
+             << "\":{\"events\":" << stats.events
+             << ",\"waitNs\":" << stats.waitNs
+             << ",\"maxWaitNs\":" << stats.maxWaitNs << '}';
+      }
+   }
+
+   out << "},\n \"violations\":{\"count\":" << total.violationCount
+       << ",\"items\":[";
+   for (std::size_t i = 0; i < total.violations.size(); ++i)
+   {
+      out << (i == 0 ? "\n  " : ",\n  ");
+      writeJsonString(out, total.violations[i]);
+   }
+   out << "]},\n \"ok\":" << (total.violationCount == 0 ? "true" : "false")
+       << "}\n";
+   out.flush();
+
+   return total.violationCount;
+}
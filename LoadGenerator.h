@@ -0,0 +1,86 @@
+// LoadGenerator.h
+#pragma once
+
+#include "BookingLedger.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+/// \file LoadGenerator.h
+/// \brief Багатопотокове навантаження на спільний каталог в одному процесі.
+
+/// \brief Параметри навантаження.
+/// \details Ваги суміші операцій відносні: частка операції — її вага,
+/// поділена на суму всіх ваг.
+struct LoadOptions
+{
+   std::string   directory = "load";                 ///< Каталог для згенерованих даних.
+   std::size_t   tours = 10000;                      ///< Розмір каталогу.
+   std::size_t   threads = 8;                        ///< Робочих потоків.
+   double        seconds = 5.0;                      ///< Тривалість навантаження.
+   double        rate = 0.0;                         ///< Операцій за секунду на всі потоки; 0 — замкнений цикл.
+   std::uint64_t seed = 1;                           ///< Зерно даних і вибору операцій.
+   double        skew = 1.0;                         ///< Показник Zipf для популярності турів.
+   SyncPolicy    sync = SyncPolicy::EveryBatch;      ///< Політика fsync журналу квитків.
+
+   unsigned      query = 30;  ///< Пошук за країною або містом.
+   unsigned      filter = 20; ///< Фільтр за рівнем, ціною або датами.
+   unsigned      get = 30;    ///< Читання одного туру.
+   unsigned      sort = 1;    ///< Сортування каталогу.
+   unsigned      edit = 9;    ///< Зміна ціни туру.
+   unsigned      book = 10;   ///< Бронювання місця.
+};
+
+/// \class LoadGenerator
+/// \brief Запускає threads потоків, що виконують суміш операцій над одним
+/// TourManager, і перевіряє узгодженість результату.
+/// \details Каталог генерується через DataGenerator (і повторно
+/// використовується, якщо вже згенерований з тим самим зерном); квитки й
+/// черги очікування щоразу починаються з порожніх файлів, а сам файл
+/// каталогу не змінюється. Тури для операцій обираються за розподілом
+/// Zipf, тож популярні тури справді конкурують.
+///
+/// Без rate кожен потік виконує операції одну за одною (замкнений цикл).
+/// З rate операції надходять пуассонівським потоком із заданою
+/// інтенсивністю незалежно від того, чи встигає каталог (відкритий цикл);
+/// затримка тоді рахується від запланованого моменту, а не від фактичного
+/// початку, щоб черга перед перевантаженим каталогом не ховалася. Час
+/// самої операції звітується окремо (serviceNs): різниця між ними — черга
+/// і запізнення пробудження потоку.
+///
+/// Перевірки узгодженості:
+/// - популярні тури редагують усі потоки одночасно: правка збільшує ціну
+///   на 1 через replaceTour з очікуваною версією і повторюється після
+///   Conflict, тож наприкінці ціна туру мусить дорівнювати початковій
+///   плюс кількість успішних правок (інакше правку втрачено), а потік
+///   після своєї правки не може прочитати меншу ціну;
+/// - приріст проданих місць кожного туру мусить дорівнювати кількості
+///   успішних бронювань і кількості квитків у сховищі, а продано не
+///   більше, ніж є місць.
+///
+/// Звіт — JSON з пропускною здатністю, перцентилями затримок для кожного
+/// виду операцій, результатами бронювань, лічильниками конкуренції (див.
+/// Metrics::acquire; у збірці з `-DTOUR_METRICS=0` — порожні) і списком
+/// порушень.
+class LoadGenerator
+{
+public:
+   /// \brief Створює навантаження.
+   /// \param options Параметри навантаження.
+   explicit LoadGenerator(LoadOptions options);
+
+   /// \brief Виконує навантаження і виводить звіт.
+   /// \param out Потік для JSON-звіту.
+   /// \return Кількість виявлених порушень узгодженості.
+   /// \throws FileException Якщо дані не вдається згенерувати чи прочитати.
+   std::size_t run(std::ostream& out);
+
+private:
+   LoadOptions options;
+
+   /// \brief Генерує каталог потрібного розміру, якщо його ще немає.
+   /// \return Каталог із файлами даних.
+   std::string prepare() const;
+};
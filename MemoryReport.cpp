@@ -0,0 +1,121 @@
+// MemoryReport.cpp
+
+#include "MemoryReport.h"
+
+#include <cstdint>
+#include <utility>
+
+bool FieldMemory::highOverhead() const
+{
+   return values != 0 && totalBytes() >= overheadFactor * payloadBytes;
+}
+
+void TypeMemory::addObject(std::size_t size)
+{
+   ++objects;
+   objectBytes += size;
+   cursor = 0;
+}
+
+void TypeMemory::addString(const char* field, const std::string& value)
+{
+   if (cursor >= fields.size() || fields[cursor].name != field)
+   {
+      cursor = 0;
+      while (cursor < fields.size() && fields[cursor].name != field)
+      {
+         ++cursor;
+      }
+
+      if (cursor == fields.size())
+      {
+         fields.push_back(FieldMemory{});
+         fields.back().name = field;
+      }
+   }
+
+   FieldMemory& entry = fields[cursor++];
+   const std::uint64_t heap = MemoryReport::stringHeapBytes(value);
+
+   ++entry.values;
+   entry.payloadBytes += value.size();
+   entry.inlineBytes += sizeof(std::string);
+   if (heap != 0)
+   {
+      entry.heapBytes += heap;
+      ++entry.heapBlocks;
+   }
+}
+
+std::uint64_t TypeMemory::heapBytes() const
+{
+   std::uint64_t total = 0;
+   for (const FieldMemory& field : fields)
+   {
+      total += field.heapBytes;
+   }
+   return total;
+}
+
+std::uint64_t TypeMemory::heapBlocks() const
+{
+   std::uint64_t total = 0;
+   for (const FieldMemory& field : fields)
+   {
+      total += field.heapBlocks;
+   }
+   return total;
+}
+
+void MemoryReport::add(std::string name, std::uint64_t items,
+   std::uint64_t bytes)
+{
+   components.push_back(MemoryComponent{std::move(name), items, bytes});
+}
+
+TypeMemory& MemoryReport::type(const char* name)
+{
+   for (TypeMemory& entry : types)
+   {
+      if (entry.name == name)
+      {
+         return entry;
+      }
+   }
+
+   types.push_back(TypeMemory{});
+   types.back().name = name;
+   return types.back();
+}
+
+std::uint64_t MemoryReport::totalBytes() const
+{
+   std::uint64_t total = 0;
+   for (const MemoryComponent& component : components)
+   {
+      total += component.bytes;
+   }
+   return total;
+}
+
+std::uint64_t MemoryReport::stringHeapBytes(const std::string& value)
+{
+   // Якщо дані лежать усередині самого об'єкта, рядок короткий (SSO).
+   const auto data = reinterpret_cast<std::uintptr_t>(value.data());
+   const auto object = reinterpret_cast<std::uintptr_t>(&value);
+   if (data >= object && data < object + sizeof(std::string))
+   {
+      return 0;
+   }
+
+   return value.capacity() + 1;
+}
+
+std::uint64_t MemoryReport::hashTableBytes(std::size_t buckets,
+   std::size_t nodes, std::size_t valueSize)
+{
+   // Вузол libstdc++: вказівник на наступний, значення, збережений хеш.
+   const std::uint64_t node =
+      sizeof(void*) + valueSize + sizeof(std::size_t) + allocatorOverhead;
+   return buckets * sizeof(void*) + nodes * node;
+}
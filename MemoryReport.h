@@ -0,0 +1,112 @@
+// MemoryReport.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// \file MemoryReport.h
+/// \brief Звіт про пам'ять, яку займає завантажений каталог.
+
+/// \brief Пам'ять одного рядкового поля в усіх об'єктах типу.
+struct FieldMemory
+{
+   std::string   name;             ///< Назва поля.
+   std::uint64_t values = 0;       ///< Кількість врахованих значень.
+   std::uint64_t payloadBytes = 0; ///< Довжина самих рядків.
+   std::uint64_t inlineBytes = 0;  ///< sizeof(std::string) у кожному об'єкті.
+   std::uint64_t heapBytes = 0;    ///< Окремі виділення під довгі рядки.
+   std::uint64_t heapBlocks = 0;   ///< Кількість таких виділень.
+
+   /// \brief Усього байтів, які займає поле.
+   std::uint64_t totalBytes() const
+   {
+      return inlineBytes + heapBytes;
+   }
+
+   /// \brief Чи займає поле щонайменше в overheadFactor разів більше,
+   /// ніж корисні дані.
+   bool highOverhead() const;
+
+   /// \brief Поріг для highOverhead().
+   static constexpr std::uint64_t overheadFactor = 4;
+};
+
+/// \brief Пам'ять усіх турів одного типу.
+struct TypeMemory
+{
+   std::string              name;                  ///< Назва типу.
+   std::uint64_t            objects = 0;           ///< Кількість об'єктів.
+   std::uint64_t            objectBytes = 0;       ///< sizeof об'єктів разом.
+   std::uint64_t            controlBlockBytes = 0; ///< Оцінка блоків керування shared_ptr.
+   std::vector<FieldMemory> fields;                ///< Рядкові поля.
+
+   /// \brief Починає облік наступного об'єкта.
+   /// \param size sizeof об'єкта.
+   void addObject(std::size_t size);
+
+   /// \brief Враховує рядкове поле поточного об'єкта.
+   /// \details Поля слід додавати в однаковому порядку для всіх об'єктів
+   /// типу: тоді пошук поля не потребує порівнянь назв.
+   /// \param field Назва поля.
+   /// \param value Значення поля.
+   void addString(const char* field, const std::string& value);
+
+   /// \brief Сума heapBytes усіх полів.
+   std::uint64_t heapBytes() const;
+
+   /// \brief Сума heapBlocks усіх полів.
+   std::uint64_t heapBlocks() const;
+
+private:
+   std::size_t cursor = 0;
+};
+
+/// \brief Одна складова загального обсягу пам'яті.
+struct MemoryComponent
+{
+   std::string   name;      ///< Назва складової.
+   std::uint64_t items = 0; ///< Кількість елементів.
+   std::uint64_t bytes = 0; ///< Зайнято байтів.
+};
+
+/// \struct MemoryReport
+/// \brief Обсяг пам'яті каталогу за складовими та за типами турів.
+/// \details Значення — оцінка: розміри контейнерів беруться за їхньою
+/// місткістю, вузли хеш-таблиць і блоки керування shared_ptr рахуються за
+/// типовою розкладкою libstdc++, а кожне окреме виділення додатково коштує
+/// allocatorOverhead байтів службових даних розподільника.
+struct MemoryReport
+{
+   std::vector<MemoryComponent> components; ///< Складові в порядку додавання.
+   std::vector<TypeMemory>      types;      ///< Тури за типами.
+
+   /// \brief Службові байти розподільника на одне виділення.
+   static constexpr std::size_t allocatorOverhead = 2 * sizeof(void*);
+
+   /// \brief Блок керування std::make_shared: vptr і два лічильники.
+   static constexpr std::size_t controlBlockSize =
+      sizeof(void*) + 2 * sizeof(int);
+
+   /// \brief Додає складову.
+   void add(std::string name, std::uint64_t items, std::uint64_t bytes);
+
+   /// \brief Повертає облік типу, створюючи його за потреби.
+   TypeMemory& type(const char* name);
+
+   /// \brief Сума всіх складових.
+   std::uint64_t totalBytes() const;
+
+   /// \brief Оцінка пам'яті рядка поза самим об'єктом std::string.
+   /// \details Короткі рядки зберігаються всередині об'єкта (SSO) і
+   /// окремого виділення не мають.
+   static std::uint64_t stringHeapBytes(const std::string& value);
+
+   /// \brief Оцінка пам'яті std::unordered_map без вмісту значень.
+   /// \param buckets Кількість кошиків.
+   /// \param nodes Кількість елементів.
+   /// \param valueSize sizeof(value_type).
+   static std::uint64_t hashTableBytes(std::size_t buckets, std::size_t nodes,
+      std::size_t valueSize);
+};
@@ -0,0 +1,431 @@
+// Metrics.cpp
+
+#include "Metrics.h"
+
+#include <atomic>
+#include <ostream>
+
+namespace
+{
+   const char* const operationNames[] =
+   {
+      "load",
+      "save",
+      "getTour",
+      "getSeats",
+      "findTours",
+      "scanTours",
+      "openCursor",
+      "sortTours",
+      "createTour",
+      "replaceTour",
+      "updateTour",
+      "removeTour",
+      "bookTour",
+      "bookGroup",
+      "cancelBooking",
+      "joinWaitlist",
+      "leaveWaitlist",
+      "loadTickets",
+      "importTickets",
+      "userTickets",
+      "tourTickets"
+   };
+
+   static_assert(sizeof(operationNames) / sizeof(operationNames[0])
+         == static_cast<std::size_t>(Operation::Count),
+      "Кожна операція повинна мати назву");
+
+   const char* const contentionNames[] =
+   {
+      "catalogWrite",
+      "ticketIndex",
+      "seatCounter"
+   };
+
+   static_assert(sizeof(contentionNames) / sizeof(contentionNames[0])
+         == static_cast<std::size_t>(Contention::Count),
+      "Кожне місце конкуренції повинно мати назву");
+
+#if TOUR_METRICS
+   /// \brief Розбиття гістограми: 2^subBits лінійних кошиків у кожному
+   /// діапазоні [2^e, 2^(e+1)).
+   constexpr int subBits = 4;
+   constexpr std::uint64_t subCount = std::uint64_t(1) << subBits;
+
+   /// \brief Найбільший діапазон: 2^44 нс — приблизно 4,9 години.
+   constexpr int maxExponent = 44;
+
+   constexpr std::size_t typeCount =
+      static_cast<std::size_t>(TrackedType::Count);
+
+   constexpr std::size_t bucketCount =
+      static_cast<std::size_t>((maxExponent - subBits + 2) * subCount);
+
+   int floorLog2(std::uint64_t value)
+   {
+      int result = 0;
+      for (int shift = 32; shift > 0; shift /= 2)
+      {
+         if (value >> shift)
+         {
+            value >>= shift;
+            result += shift;
+         }
+      }
+      return result;
+   }
+
+   std::size_t bucketIndex(std::uint64_t ns)
+   {
+      if (ns < 2 * subCount)
+      {
+         return static_cast<std::size_t>(ns);
+      }
+
+      const int exponent = floorLog2(ns);
+      if (exponent > maxExponent)
+      {
+         return bucketCount - 1;
+      }
+
+      const std::uint64_t sub = (ns >> (exponent - subBits)) & (subCount - 1);
+      return static_cast<std::size_t>(
+         (exponent - subBits + 1) * subCount + sub);
+   }
+
+   /// \brief Найбільше значення, що потрапляє в кошик.
+   std::uint64_t bucketUpper(std::size_t index)
+   {
+      if (index < 2 * subCount)
+      {
+         return index;
+      }
+
+      const int exponent = static_cast<int>(index / subCount) + subBits - 1;
+      const std::uint64_t sub = index % subCount;
+      const std::uint64_t width = std::uint64_t(1) << (exponent - subBits);
+      return ((subCount + sub) << (exponent - subBits)) + width - 1;
+   }
+
+   struct alignas(64) OperationStats
+   {
+      std::atomic<std::uint64_t> calls{0};
+      std::atomic<std::uint64_t> failures{0};
+      std::atomic<std::uint64_t> read{0};
+      std::atomic<std::uint64_t> written{0};
+      std::atomic<std::uint64_t> allocations{0};
+      std::atomic<std::uint64_t> allocatedBytes{0};
+      std::atomic<std::uint64_t> copies[typeCount];
+      std::atomic<std::uint64_t> moves[typeCount];
+      std::atomic<std::uint64_t> destroyed[typeCount];
+      std::atomic<std::uint64_t> totalNs{0};
+      std::atomic<std::uint64_t> maxNs{0};
+      std::atomic<std::uint64_t> buckets[bucketCount];
+
+      OperationStats()
+      {
+         clear();
+      }
+
+      void clear()
+      {
+         calls.store(0, std::memory_order_relaxed);
+         failures.store(0, std::memory_order_relaxed);
+         read.store(0, std::memory_order_relaxed);
+         written.store(0, std::memory_order_relaxed);
+         allocations.store(0, std::memory_order_relaxed);
+         allocatedBytes.store(0, std::memory_order_relaxed);
+         totalNs.store(0, std::memory_order_relaxed);
+         maxNs.store(0, std::memory_order_relaxed);
+
+         for (std::size_t type = 0; type < typeCount; ++type)
+         {
+            copies[type].store(0, std::memory_order_relaxed);
+            moves[type].store(0, std::memory_order_relaxed);
+            destroyed[type].store(0, std::memory_order_relaxed);
+         }
+
+         for (auto& bucket : buckets)
+         {
+            bucket.store(0, std::memory_order_relaxed);
+         }
+      }
+   };
+
+   void addIfNonZero(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+   {
+      if (value != 0)
+      {
+         counter.fetch_add(value, std::memory_order_relaxed);
+      }
+   }
+
+   OperationStats stats[static_cast<std::size_t>(Operation::Count)];
+
+   struct alignas(64) ContentionCounters
+   {
+      std::atomic<std::uint64_t> events{0};
+      std::atomic<std::uint64_t> waitNs{0};
+      std::atomic<std::uint64_t> maxWaitNs{0};
+
+      void clear()
+      {
+         events.store(0, std::memory_order_relaxed);
+         waitNs.store(0, std::memory_order_relaxed);
+         maxWaitNs.store(0, std::memory_order_relaxed);
+      }
+   };
+
+   ContentionCounters contended[static_cast<std::size_t>(Contention::Count)];
+
+   void raiseMax(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+   {
+      std::uint64_t previous = counter.load(std::memory_order_relaxed);
+      while (previous < value
+             && !counter.compare_exchange_weak(previous, value,
+                   std::memory_order_relaxed))
+      {
+      }
+   }
+
+   std::uint64_t toNanoseconds(std::chrono::steady_clock::duration elapsed)
+   {
+      const auto count =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+      return count > 0 ? static_cast<std::uint64_t>(count) : 0;
+   }
+
+   std::uint64_t percentile(const std::uint64_t* counts, std::uint64_t total,
+      double fraction)
+   {
+      if (total == 0)
+      {
+         return 0;
+      }
+
+      const std::uint64_t target = static_cast<std::uint64_t>(
+         fraction * static_cast<double>(total) + 0.5);
+      std::uint64_t seen = 0;
+
+      for (std::size_t i = 0; i < bucketCount; ++i)
+      {
+         seen += counts[i];
+         if (seen >= target && seen != 0)
+         {
+            return bucketUpper(i);
+         }
+      }
+
+      return bucketUpper(bucketCount - 1);
+   }
+#endif
+}
+
+const char* Metrics::name(Operation operation)
+{
+   const std::size_t index = static_cast<std::size_t>(operation);
+   return index < static_cast<std::size_t>(Operation::Count)
+      ? operationNames[index]
+      : "unknown";
+}
+
+const char* Metrics::name(Contention where)
+{
+   const std::size_t index = static_cast<std::size_t>(where);
+   return index < static_cast<std::size_t>(Contention::Count)
+      ? contentionNames[index]
+      : "unknown";
+}
+
+#if TOUR_METRICS
+
+void Metrics::record(const Scope& scope, bool failed,
+   std::chrono::steady_clock::duration elapsed,
+   const AllocationCounts& allocated)
+{
+   OperationStats& entry = stats[static_cast<std::size_t>(scope.operation)];
+   const std::uint64_t ns = toNanoseconds(elapsed);
+
+   entry.calls.fetch_add(1, std::memory_order_relaxed);
+   if (failed)
+   {
+      entry.failures.fetch_add(1, std::memory_order_relaxed);
+   }
+   addIfNonZero(entry.read, scope.read);
+   addIfNonZero(entry.written, scope.written);
+   addIfNonZero(entry.allocations,
+      allocated.allocations - scope.allocated.allocations);
+   addIfNonZero(entry.allocatedBytes, allocated.bytes - scope.allocated.bytes);
+
+   for (std::size_t type = 0; type < typeCount; ++type)
+   {
+      const LifecycleCounts& after = allocated.lifecycle[type];
+      const LifecycleCounts& before = scope.allocated.lifecycle[type];
+
+      addIfNonZero(entry.copies[type], after.copies - before.copies);
+      addIfNonZero(entry.moves[type], after.moves - before.moves);
+      addIfNonZero(entry.destroyed[type], after.destroyed - before.destroyed);
+   }
+
+   entry.totalNs.fetch_add(ns, std::memory_order_relaxed);
+   entry.buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+   raiseMax(entry.maxNs, ns);
+}
+
+void Metrics::waited(Contention where,
+   std::chrono::steady_clock::duration elapsed)
+{
+   ContentionCounters& entry = contended[static_cast<std::size_t>(where)];
+   const std::uint64_t ns = toNanoseconds(elapsed);
+
+   entry.events.fetch_add(1, std::memory_order_relaxed);
+   entry.waitNs.fetch_add(ns, std::memory_order_relaxed);
+   raiseMax(entry.maxWaitNs, ns);
+}
+
+void Metrics::retried(Contention where, std::uint64_t count)
+{
+   contended[static_cast<std::size_t>(where)].events.fetch_add(count,
+      std::memory_order_relaxed);
+}
+
+ContentionStats Metrics::contention(Contention where)
+{
+   const ContentionCounters& entry = contended[static_cast<std::size_t>(where)];
+
+   ContentionStats result;
+   result.events = entry.events.load(std::memory_order_relaxed);
+   result.waitNs = entry.waitNs.load(std::memory_order_relaxed);
+   result.maxWaitNs = entry.maxWaitNs.load(std::memory_order_relaxed);
+   return result;
+}
+
+void Metrics::writeJson(std::ostream& out)
+{
+   out << "{\"enabled\":true,\"operations\":{";
+
+   bool firstOperation = true;
+   for (std::size_t op = 0; op < static_cast<std::size_t>(Operation::Count); ++op)
+   {
+      const OperationStats& entry = stats[op];
+
+      // Кошики знімаються один раз: під час запису лічильники можуть рости,
+      // а перцентилі мають рахуватися з одного знімка.
+      std::uint64_t counts[bucketCount];
+      std::uint64_t total = 0;
+      for (std::size_t i = 0; i < bucketCount; ++i)
+      {
+         counts[i] = entry.buckets[i].load(std::memory_order_relaxed);
+         total += counts[i];
+      }
+
+      if (total == 0)
+      {
+         continue;
+      }
+
+      out << (firstOperation ? "" : ",") << '"' << operationNames[op]
+          << "\":{\"calls\":" << entry.calls.load(std::memory_order_relaxed)
+          << ",\"failures\":" << entry.failures.load(std::memory_order_relaxed)
+          << ",\"bytesRead\":" << entry.read.load(std::memory_order_relaxed)
+          << ",\"bytesWritten\":" << entry.written.load(std::memory_order_relaxed)
+          << ",\"allocations\":"
+          << entry.allocations.load(std::memory_order_relaxed)
+          << ",\"allocatedBytes\":"
+          << entry.allocatedBytes.load(std::memory_order_relaxed)
+          << ",\"totalNs\":" << entry.totalNs.load(std::memory_order_relaxed)
+          << ",\"maxNs\":" << entry.maxNs.load(std::memory_order_relaxed)
+          << ",\"p50Ns\":" << percentile(counts, total, 0.50)
+          << ",\"p90Ns\":" << percentile(counts, total, 0.90)
+          << ",\"p99Ns\":" << percentile(counts, total, 0.99)
+          << ",\"p999Ns\":" << percentile(counts, total, 0.999)
+          << ",\"lifecycle\":{";
+
+      // Лише типи, з якими щось відбувалося.
+      bool firstType = true;
+      for (std::size_t type = 0; type < typeCount; ++type)
+      {
+         const std::uint64_t copies =
+            entry.copies[type].load(std::memory_order_relaxed);
+         const std::uint64_t moves =
+            entry.moves[type].load(std::memory_order_relaxed);
+         const std::uint64_t destroyed =
+            entry.destroyed[type].load(std::memory_order_relaxed);
+
+         if (copies == 0 && moves == 0 && destroyed == 0)
+         {
+            continue;
+         }
+
+         out << (firstType ? "" : ",") << '"'
+             << AllocationStats::name(static_cast<TrackedType>(type))
+             << "\":{\"copies\":" << copies << ",\"moves\":" << moves
+             << ",\"destroyed\":" << destroyed << '}';
+         firstType = false;
+      }
+
+      out << "},\"histogram\":[";
+
+      // Лише непорожні кошики: [верхня межа в нс, кількість].
+      bool firstBucket = true;
+      for (std::size_t i = 0; i < bucketCount; ++i)
+      {
+         if (counts[i] == 0)
+         {
+            continue;
+         }
+
+         out << (firstBucket ? "" : ",") << '[' << bucketUpper(i) << ','
+             << counts[i] << ']';
+         firstBucket = false;
+      }
+
+      out << "]}";
+      firstOperation = false;
+   }
+
+   out << "},\"contention\":{";
+
+   for (std::size_t i = 0; i < static_cast<std::size_t>(Contention::Count); ++i)
+   {
+      const ContentionStats entry = contention(static_cast<Contention>(i));
+      out << (i == 0 ? "" : ",") << '"' << contentionNames[i]
+          << "\":{\"events\":" << entry.events
+          << ",\"waitNs\":" << entry.waitNs
+          << ",\"maxWaitNs\":" << entry.maxWaitNs << '}';
+   }
+
+   out << "}}";
+}
+
+void Metrics::reset()
+{
+   for (OperationStats& entry : stats)
+   {
+      entry.clear();
+   }
+
+   for (ContentionCounters& entry : contended)
+   {
+      entry.clear();
+   }
+}
+
+#else
+
+ContentionStats Metrics::contention(Contention)
+{
+   return {};
+}
+
+void Metrics::writeJson(std::ostream& out)
+{
+   out << "{\"enabled\":false}";
+}
+
+void Metrics::reset()
+{
+}
+
+#endif
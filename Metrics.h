@@ -0,0 +1,270 @@
+// Metrics.h
+#pragma once
+
+#include "AllocationStats.h"
+#include "Result.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+
+/// \file Metrics.h
+/// \brief Лічильники та гістограми затримок операцій каталогу.
+///
+/// Інструментування вмикається макросом TOUR_METRICS (за замовчуванням 1).
+/// Збірка з `-DTOUR_METRICS=0` прибирає його повністю: Metrics::Scope стає
+/// порожнім класом, а лічильники й гістограми не створюються.
+
+#if TOUR_METRICS
+#include <chrono>
+#include <exception>
+#endif
+
+/// \brief Операції, для яких ведеться статистика.
+enum class Operation
+{
+   Load,
+   Save,
+   GetTour,
+   GetSeats,
+   FindTours,
+   ScanTours,
+   OpenCursor,
+   SortTours,
+   CreateTour,
+   ReplaceTour,
+   UpdateTour,
+   RemoveTour,
+   BookTour,
+   BookGroup,
+   CancelBooking,
+   JoinWaitlist,
+   LeaveWaitlist,
+   LoadTickets,
+   ImportTickets,
+   UserTickets,
+   TourTickets,
+   Count ///< Кількість операцій; не операція.
+};
+
+/// \brief Місця, де потоки можуть чекати один на одного.
+enum class Contention
+{
+   CatalogWrite, ///< М'ютекс письменників каталогу.
+   TicketIndex,  ///< Запис до індексу квитків.
+   SeatCounter,  ///< Повтори compare-and-swap лічильника місць.
+   Count         ///< Кількість місць; не місце.
+};
+
+/// \brief Знімок лічильників конкуренції одного місця.
+struct ContentionStats
+{
+   std::uint64_t events = 0;    ///< Зайняті блокування або повтори CAS.
+   std::uint64_t waitNs = 0;    ///< Сумарне очікування на блокування.
+   std::uint64_t maxWaitNs = 0; ///< Найдовше очікування.
+};
+
+/// \class Metrics
+/// \brief Глобальна статистика операцій: виклики, невдачі, байти, пам'ять,
+/// затримки.
+/// \details Для кожної операції ведуться атомарні лічильники викликів,
+/// невдалих викликів (виняток або повернена помилка, позначена через
+/// Scope::fail() чи Scope::done()), прочитаних і записаних байтів,
+/// виділень пам'яті, копіювань, переміщень і знищень турів (див.
+/// AllocationStats), сумарного та максимального часу, а також гістограма
+/// затримок у стилі
+/// HDR: логарифмічні діапазони по 16 лінійних кошиків (похибка до ~6 %)
+/// від 1 нс до кількох годин. Запис — кілька relaxed-інкрементів без
+/// блокувань.
+///
+/// Байти приписуються найглибшій активній Scope поточного потоку, тож
+/// низькорівневий код (журнал квитків, сховище) може звітувати про
+/// ввід-вивід, не знаючи, яка операція його викликала. Виділення й події
+/// життєвого циклу, навпаки, включають вкладені операції: load() враховує
+/// і виділення loadTickets().
+///
+/// Окремо рахується конкуренція (див. Contention): блокування, захоплені
+/// через acquire(), спершу пробуються без очікування, і лише якщо м'ютекс
+/// зайнятий, вимірюється час очікування. Незайняте блокування коштує
+/// стільки ж, скільки звичайне.
+class Metrics
+{
+public:
+   /// \brief Чи ввімкнено інструментування в цій збірці.
+   static constexpr bool enabled = TOUR_METRICS != 0;
+
+#if TOUR_METRICS
+   /// \class Scope
+   /// \brief Вимірює одну операцію від створення до знищення.
+   class Scope
+   {
+   public:
+      /// \brief Починає вимірювання.
+      /// \param operation Операція, до якої віднести результат.
+      explicit Scope(Operation operation)
+         : operation(operation),
+           outer(active),
+           exceptions(std::uncaught_exceptions()),
+           allocated(AllocationStats::thisThread()),
+           start(std::chrono::steady_clock::now())
+      {
+         active = this;
+      }
+
+      /// \brief Записує тривалість, байти й виділення в статистику операції.
+      ~Scope()
+      {
+         const auto elapsed = std::chrono::steady_clock::now() - start;
+         active = outer;
+         Metrics::record(*this,
+            failed || std::uncaught_exceptions() > exceptions,
+            elapsed,
+            AllocationStats::thisThread());
+      }
+
+      /// \brief Позначає операцію невдалою, хоча винятку не було.
+      /// \param error Помилка, яку повертає операція.
+      /// \return Ту саму помилку: `return metrics.fail(Error{...});`.
+      Error fail(Error error)
+      {
+         failed = true;
+         return error;
+      }
+
+      /// \brief Позначає операцію невдалою, якщо результат — помилка.
+      /// \param result Результат, який повертає операція.
+      /// \return Той самий результат.
+      template <typename T>
+      Result<T> done(Result<T> result)
+      {
+         if (!result.ok())
+         {
+            failed = true;
+         }
+         return result;
+      }
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+   private:
+      friend class Metrics;
+
+      Operation                             operation;
+      Scope*                                outer;
+      int                                   exceptions;
+      bool                                  failed = false;
+      AllocationCounts                      allocated;
+      std::uint64_t                         read = 0;
+      std::uint64_t                         written = 0;
+      std::chrono::steady_clock::time_point start;
+
+      static inline thread_local Scope* active = nullptr;
+   };
+
+   /// \brief Додає прочитані байти до поточної операції потоку.
+   static void bytesRead(std::uint64_t bytes)
+   {
+      if (Scope::active != nullptr)
+      {
+         Scope::active->read += bytes;
+      }
+   }
+
+   /// \brief Додає записані байти до поточної операції потоку.
+   static void bytesWritten(std::uint64_t bytes)
+   {
+      if (Scope::active != nullptr)
+      {
+         Scope::active->written += bytes;
+      }
+   }
+
+   /// \brief Захоплює м'ютекс, рахуючи очікування, якщо він зайнятий.
+   /// \param mutex М'ютекс для виключного захоплення.
+   /// \param where Місце конкуренції.
+   /// \return Захоплене блокування.
+   template <typename Mutex>
+   static std::unique_lock<Mutex> acquire(Mutex& mutex, Contention where)
+   {
+      std::unique_lock<Mutex> lock(mutex, std::try_to_lock);
+      if (!lock.owns_lock())
+      {
+         const auto start = std::chrono::steady_clock::now();
+         lock.lock();
+         waited(where, std::chrono::steady_clock::now() - start);
+      }
+      return lock;
+   }
+
+   /// \brief Рахує повтори операції без блокувань.
+   /// \param where Місце конкуренції.
+   /// \param count Кількість повторів.
+   static void retried(Contention where, std::uint64_t count);
+#else
+   class Scope
+   {
+   public:
+      explicit Scope(Operation)
+      {
+      }
+
+      Error fail(Error error)
+      {
+         return error;
+      }
+
+      template <typename T>
+      Result<T> done(Result<T> result)
+      {
+         return result;
+      }
+   };
+
+   static void bytesRead(std::uint64_t)
+   {
+   }
+
+   static void bytesWritten(std::uint64_t)
+   {
+   }
+
+   template <typename Mutex>
+   static std::unique_lock<Mutex> acquire(Mutex& mutex, Contention)
+   {
+      return std::unique_lock<Mutex>(mutex);
+   }
+
+   static void retried(Contention, std::uint64_t)
+   {
+   }
+#endif
+
+   /// \brief Повертає назву операції для звітів.
+   static const char* name(Operation operation);
+
+   /// \brief Повертає назву місця конкуренції для звітів.
+   static const char* name(Contention where);
+
+   /// \brief Повертає поточні лічильники місця конкуренції (нулі, якщо
+   /// інструментування вимкнено).
+   static ContentionStats contention(Contention where);
+
+   /// \brief Записує статистику всіх операцій одним JSON-об'єктом без переносів.
+   /// \param out Потік для запису.
+   static void writeJson(std::ostream& out);
+
+   /// \brief Обнуляє всю статистику.
+   static void reset();
+
+private:
+#if TOUR_METRICS
+   static void record(const Scope& scope, bool failed,
+      std::chrono::steady_clock::duration elapsed,
+      const AllocationCounts& allocated);
+
+   static void waited(Contention where,
+      std::chrono::steady_clock::duration elapsed);
+#endif
+};
@@ -0,0 +1,431 @@
+// PasswordHasher.cpp
+
+#include "PasswordHasher.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace
+{
+   const char hashPrefix[] = "$pbkdf2-sha256$";
+   constexpr std::size_t saltSize = 16;
+   constexpr std::size_t keySize = 32;
+   constexpr unsigned maxIterations = 100000000;
+
+   using Digest = std::array<std::uint8_t, 32>;
+
+   /// \brief Потокове обчислення SHA-256 (FIPS 180-4).
+   class Sha256
+   {
+   public:
+      void update(const std::uint8_t* data, std::size_t size)
+      {
+         total += size;
+
+         if (used != 0)
+         {
+            const std::size_t take = std::min(size, block.size() - used);
+            std::memcpy(block.data() + used, data, take);
+            used += take;
+            data += take;
+            size -= take;
+
+            if (used < block.size())
+            {
+               return;
+            }
+
+            compress(block.data());
+            used = 0;
+         }
+
+         while (size >= block.size())
+         {
+            compress(data);
+            data += block.size();
+            size -= block.size();
+         }
+
+         std::memcpy(block.data(), data, size);
+         used = size;
+      }
+
+      void update(const std::string& data)
+      {
+         update(reinterpret_cast<const std::uint8_t*>(data.data()), data.size());
+      }
+
+      Digest finish()
+      {
+         const std::uint64_t bits = total * 8;
+
+         const std::uint8_t pad = 0x80;
+         update(&pad, 1);
+
+         const std::uint8_t zero = 0;
+         while (used != 56)
+         {
+            update(&zero, 1);
+         }
+
+         std::uint8_t length[8];
+         for (int i = 0; i < 8; ++i)
+         {
+            length[i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+         }
+         update(length, 8);
+
+         Digest out;
+         for (int i = 0; i < 8; ++i)
+         {
+            out[4 * i] = static_cast<std::uint8_t>(state[i] >> 24);
+            out[4 * i + 1] = static_cast<std::uint8_t>(state[i] >> 16);
+            out[4 * i + 2] = static_cast<std::uint8_t>(state[i] >> 8);
+            out[4 * i + 3] = static_cast<std::uint8_t>(state[i]);
+         }
+
+         return out;
+      }
+
+   private:
+      std::array<std::uint32_t, 8> state{
+         0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+      std::array<std::uint8_t, 64> block{};
+      std::size_t   used = 0;
+      std::uint64_t total = 0;
+
+      static std::uint32_t rotr(std::uint32_t x, int n)
+      {
+         return (x >> n) | (x << (32 - n));
+      }
+
+      void compress(const std::uint8_t* chunk)
+      {
+         static const std::uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+            0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+            0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+            0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+            0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+            0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+         std::uint32_t w[64];
+         for (int i = 0; i < 16; ++i)
+         {
+            w[i] = (std::uint32_t(chunk[4 * i]) << 24)
+               | (std::uint32_t(chunk[4 * i + 1]) << 16)
+               | (std::uint32_t(chunk[4 * i + 2]) << 8)
+               | std::uint32_t(chunk[4 * i + 3]);
+         }
+
+         for (int i = 16; i < 64; ++i)
+         {
+            const std::uint32_t s0 =
+               rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const std::uint32_t s1 =
+               rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+         }
+
+         std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+         std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+         for (int i = 0; i < 64; ++i)
+         {
+            const std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            const std::uint32_t ch = (e & f) ^ (~e & g);
+            const std::uint32_t t1 = h + s1 + ch + k[i] + w[i];
+            const std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            const std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            const std::uint32_t t2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+         }
+
+         state[0] += a;
+         state[1] += b;
+         state[2] += c;
+         state[3] += d;
+         state[4] += e;
+         state[5] += f;
+         state[6] += g;
+         state[7] += h;
+      }
+   };
+
+   /// \brief HMAC із заздалегідь обчисленими станами ipad/opad.
+   /// \details PBKDF2 рахує тисячі HMAC з одним ключем; копіювання готових
+   /// станів економить два стиснення на кожну ітерацію.
+   class Hmac
+   {
+   public:
+      explicit Hmac(const std::string& key)
+      {
+         std::array<std::uint8_t, 64> padded{};
+
+         if (key.size() > padded.size())
+         {
+            Sha256 keyHash;
+            keyHash.update(key);
+            const Digest digest = keyHash.finish();
+            std::copy(digest.begin(), digest.end(), padded.begin());
+         }
+         else
+         {
+            std::memcpy(padded.data(), key.data(), key.size());
+         }
+
+         std::array<std::uint8_t, 64> pad;
+         for (std::size_t i = 0; i < pad.size(); ++i)
+         {
+            pad[i] = padded[i] ^ 0x36;
+         }
+         inner.update(pad.data(), pad.size());
+
+         for (std::size_t i = 0; i < pad.size(); ++i)
+         {
+            pad[i] = padded[i] ^ 0x5c;
+         }
+         outer.update(pad.data(), pad.size());
+      }
+
+      Digest compute(const std::uint8_t* data, std::size_t size) const
+      {
+         Sha256 first = inner;
+         first.update(data, size);
+         const Digest innerDigest = first.finish();
+
+         Sha256 second = outer;
+         second.update(innerDigest.data(), innerDigest.size());
+         return second.finish();
+      }
+
+   private:
+      Sha256 inner;
+      Sha256 outer;
+   };
+
+   Digest pbkdf2(const std::string& password,
+      const std::string& salt,
+      unsigned iterations)
+   {
+      const Hmac prf(password);
+
+      // Потрібен лише перший блок: довжина ключа дорівнює розміру SHA-256.
+      std::string firstInput = salt;
+      firstInput.append("\0\0\0\1", 4);
+
+      Digest u = prf.compute(
+         reinterpret_cast<const std::uint8_t*>(firstInput.data()),
+         firstInput.size());
+      Digest result = u;
+
+      for (unsigned i = 1; i < iterations; ++i)
+      {
+         u = prf.compute(u.data(), u.size());
+         for (std::size_t j = 0; j < result.size(); ++j)
+         {
+            result[j] ^= u[j];
+         }
+      }
+
+      return result;
+   }
+
+   std::string toHex(const std::uint8_t* data, std::size_t size)
+   {
+      static const char digits[] = "0123456789abcdef";
+
+      std::string out;
+      out.reserve(size * 2);
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         out += digits[data[i] >> 4];
+         out += digits[data[i] & 0x0f];
+      }
+
+      return out;
+   }
+
+   bool fromHex(const std::string& hex, std::string& out)
+   {
+      if (hex.size() % 2 != 0)
+      {
+         return false;
+      }
+
+      auto value = [](char c) -> int
+      {
+         if (c >= '0' && c <= '9')
+         {
+            return c - '0';
+         }
+         if (c >= 'a' && c <= 'f')
+         {
+            return c - 'a' + 10;
+         }
+         return -1;
+      };
+
+      out.clear();
+      for (std::size_t i = 0; i < hex.size(); i += 2)
+      {
+         const int hi = value(hex[i]);
+         const int lo = value(hex[i + 1]);
+         if (hi < 0 || lo < 0)
+         {
+            return false;
+         }
+         out += static_cast<char>((hi << 4) | lo);
+      }
+
+      return true;
+   }
+
+   /// \brief Розбирає рядок хешу на ітерації, сіль і ключ.
+   bool parseHash(const std::string& stored,
+      unsigned& iterations,
+      std::string& salt,
+      std::string& key)
+   {
+      if (!PasswordHasher::isHashed(stored))
+      {
+         return false;
+      }
+
+      const std::size_t start = sizeof(hashPrefix) - 1;
+      const std::size_t saltStart = stored.find('$', start);
+      if (saltStart == std::string::npos)
+      {
+         return false;
+      }
+
+      const std::size_t keyStart = stored.find('$', saltStart + 1);
+      if (keyStart == std::string::npos)
+      {
+         return false;
+      }
+
+      const std::string count = stored.substr(start, saltStart - start);
+      if (count.empty() || count.size() > 9
+          || count.find_first_not_of("0123456789") != std::string::npos)
+      {
+         return false;
+      }
+
+      iterations = static_cast<unsigned>(std::stoul(count));
+      if (iterations == 0 || iterations > maxIterations)
+      {
+         return false;
+      }
+
+      return fromHex(stored.substr(saltStart + 1, keyStart - saltStart - 1), salt)
+         && fromHex(stored.substr(keyStart + 1), key)
+         && !salt.empty() && key.size() == keySize;
+   }
+}
+
+PasswordHasher::PasswordHasher(unsigned iterations)
+   : rounds(std::min(std::max(iterations, 1u), maxIterations))
+{
+}
+
+std::string PasswordHasher::hash(const std::string& password) const
+{
+   const std::string salt = randomBytes(saltSize);
+   const Digest key = pbkdf2(password, salt, rounds);
+
+   return hashPrefix + std::to_string(rounds) + '$'
+      + toHex(reinterpret_cast<const std::uint8_t*>(salt.data()), salt.size())
+      + '$' + toHex(key.data(), key.size());
+}
+
+bool PasswordHasher::needsRehash(const std::string& stored) const
+{
+   unsigned iterations = 0;
+   std::string salt;
+   std::string key;
+
+   return !parseHash(stored, iterations, salt, key) || iterations < rounds;
+}
+
+bool PasswordHasher::verify(const std::string& stored,
+   const std::string& password)
+{
+   unsigned iterations = 0;
+   std::string salt;
+   std::string key;
+
+   if (!parseHash(stored, iterations, salt, key))
+   {
+      return false;
+   }
+
+   const Digest actual = pbkdf2(password, salt, iterations);
+   return equalConstantTime(
+      std::string(reinterpret_cast<const char*>(actual.data()), actual.size()),
+      key);
+}
+
+bool PasswordHasher::isHashed(const std::string& stored)
+{
+   return stored.compare(0, sizeof(hashPrefix) - 1, hashPrefix) == 0;
+}
+
+std::string PasswordHasher::hmac(const std::string& key,
+   const std::string& message)
+{
+   const Digest digest = Hmac(key).compute(
+      reinterpret_cast<const std::uint8_t*>(message.data()), message.size());
+   return std::string(reinterpret_cast<const char*>(digest.data()), digest.size());
+}
+
+bool PasswordHasher::equalConstantTime(const std::string& a,
+   const std::string& b)
+{
+   unsigned char diff = a.size() == b.size() ? 0 : 1;
+   const std::size_t size = std::max(a.size(), b.size());
+
+   for (std::size_t i = 0; i < size; ++i)
+   {
+      const unsigned char x = i < a.size() ? a[i] : 0;
+      const unsigned char y = i < b.size() ? b[i] : 0;
+      diff |= x ^ y;
+   }
+
+   return diff == 0;
+}
+
+std::string PasswordHasher::randomBytes(std::size_t count)
+{
+   std::random_device device;
+
+   std::string out;
+   out.reserve(count);
+   while (out.size() < count)
+   {
+      const unsigned int value = device();
+      for (std::size_t i = 0; i < sizeof(value) && out.size() < count; ++i)
+      {
+         out += static_cast<char>((value >> (8 * i)) & 0xff);
+      }
+   }
+
+   return out;
+}
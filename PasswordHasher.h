@@ -0,0 +1,66 @@
+// PasswordHasher.h
+#pragma once
+
+#include <string>
+
+/// \file PasswordHasher.h
+/// \brief Солені хеші паролів PBKDF2-HMAC-SHA256.
+
+/// \class PasswordHasher
+/// \brief Обчислює та перевіряє хеші паролів із налаштовуваною вартістю.
+/// \details Хеш зберігається одним рядком
+/// `$pbkdf2-sha256$<ітерації>$<сіль hex>$<ключ hex>`, тож уміщується в поле
+/// пароля файлу користувачів. Кількість ітерацій записана в самому хеші:
+/// зміна вартості не ламає старих записів, а needsRehash() підказує, які
+/// з них варто переобчислити.
+class PasswordHasher
+{
+public:
+   /// \brief Кількість ітерацій за замовчуванням.
+   static constexpr unsigned defaultIterations = 100000;
+
+   /// \brief Створює обчислювач хешів.
+   /// \param iterations Кількість ітерацій PBKDF2 (щонайменше 1).
+   explicit PasswordHasher(unsigned iterations = defaultIterations);
+
+   /// \brief Обчислює хеш пароля з новою випадковою сіллю.
+   /// \param password Пароль.
+   /// \return Рядок хешу у форматі `$pbkdf2-sha256$...`.
+   std::string hash(const std::string& password) const;
+
+   /// \brief Перевіряє, чи хеш обчислено з меншою вартістю, ніж налаштовано.
+   /// \param stored Збережений хеш.
+   bool needsRehash(const std::string& stored) const;
+
+   /// \brief Повертає налаштовану кількість ітерацій.
+   unsigned iterations() const
+   {
+      return rounds;
+   }
+
+   /// \brief Перевіряє пароль проти збереженого хешу.
+   /// \details Порівняння виконується за сталий час.
+   /// \param stored Збережений хеш.
+   /// \param password Пароль для перевірки.
+   /// \return true, якщо пароль відповідає хешу; false також для зіпсованого хешу.
+   static bool verify(const std::string& stored, const std::string& password);
+
+   /// \brief Перевіряє, чи поле пароля містить хеш, а не відкритий текст.
+   static bool isHashed(const std::string& stored);
+
+   /// \brief Обчислює HMAC-SHA256.
+   /// \param key Ключ.
+   /// \param message Повідомлення.
+   /// \return 32 байти коду автентичності.
+   static std::string hmac(const std::string& key, const std::string& message);
+
+   /// \brief Порівнює два рядки за час, що не залежить від місця розбіжності.
+   static bool equalConstantTime(const std::string& a, const std::string& b);
+
+   /// \brief Повертає випадкові байти для солі та секретів.
+   /// \param count Кількість байтів.
+   static std::string randomBytes(std::size_t count);
+
+private:
+   unsigned rounds;
+};
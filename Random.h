@@ -0,0 +1,117 @@
+// Random.h
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// \file Random.h
+/// \brief Відтворюваний генератор випадкових чисел і розподіл Zipf.
+
+/// \brief xoshiro256** із зерном, розгорнутим через splitmix64.
+/// \details Стандартні розподіли <random> залежать від реалізації
+/// бібліотеки, тому всі вибірки будуються поверх next().
+class Random
+{
+public:
+   explicit Random(std::uint64_t seed)
+   {
+      for (auto& word : state)
+      {
+         seed += 0x9e3779b97f4a7c15ULL;
+         std::uint64_t z = seed;
+         z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+         z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+         word = z ^ (z >> 31);
+      }
+   }
+
+   std::uint64_t next()
+   {
+      const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+      const std::uint64_t t = state[1] << 17;
+
+      state[2] ^= state[0];
+      state[3] ^= state[1];
+      state[1] ^= state[2];
+      state[0] ^= state[3];
+      state[2] ^= t;
+      state[3] = rotl(state[3], 45);
+
+      return result;
+   }
+
+   /// \brief Рівномірне число з [0, 1).
+   double uniform()
+   {
+      return static_cast<double>(next() >> 11) * 0x1.0p-53;
+   }
+
+   /// \brief Рівномірне ціле з [0, bound).
+   std::size_t below(std::size_t bound)
+   {
+      return bound == 0 ? 0 : static_cast<std::size_t>(next() % bound);
+   }
+
+   bool chance(double probability)
+   {
+      return uniform() < probability;
+   }
+
+   /// \brief Стандартний нормальний розподіл (перетворення Бокса — Мюллера).
+   double normal()
+   {
+      const double u1 = 1.0 - uniform();
+      const double u2 = uniform();
+      return std::sqrt(-2.0 * std::log(u1))
+         * std::cos(6.283185307179586 * u2);
+   }
+
+private:
+   std::uint64_t state[4];
+
+   static std::uint64_t rotl(std::uint64_t x, int k)
+   {
+      return (x << k) | (x >> (64 - k));
+   }
+};
+
+/// \brief Таблиця розподілу Zipf: ранг i має вагу 1 / (i + 1)^s.
+class ZipfTable
+{
+public:
+   ZipfTable(std::size_t count, double exponent)
+      : cdf(count)
+   {
+      double total = 0.0;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         total += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+         cdf[i] = total;
+      }
+
+      for (double& value : cdf)
+      {
+         value /= total;
+      }
+   }
+
+   std::size_t sample(Random& random) const
+   {
+      if (cdf.empty())
+      {
+         return 0;
+      }
+
+      const auto found =
+         std::upper_bound(cdf.begin(), cdf.end(), random.uniform());
+      return found == cdf.end()
+         ? cdf.size() - 1
+         : static_cast<std::size_t>(found - cdf.begin());
+   }
+
+private:
+   std::vector<double> cdf;
+};
@@ -0,0 +1,52 @@
+// ReportFormat.cpp
+
+#include "ReportFormat.h"
+
+#include <cstdio>
+#include <ostream>
+
+void writeJsonString(std::ostream& out, const std::string& text)
+{
+   out << '"';
+
+   for (unsigned char ch : text)
+   {
+      switch (ch)
+      {
+         case '"':
+            out << "\\\"";
+            break;
+
+         case '\\':
+            out << "\\\\";
+            break;
+
+         case '\n':
+            out << "\\n";
+            break;
+
+         case '\r':
+            out << "\\r";
+            break;
+
+         case '\t':
+            out << "\\t";
+            break;
+
+         default:
+            if (ch < 0x20)
+            {
+               char buffer[8];
+               std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+               out << buffer;
+            }
+            else
+            {
+               out << static_cast<char>(ch);
+            }
+            break;
+      }
+   }
+
+   out << '"';
+}
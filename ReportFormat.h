@@ -0,0 +1,36 @@
+// ReportFormat.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// \file ReportFormat.h
+/// \brief Спільні помічники JSON-звітів: екранування рядків і перцентилі.
+
+/// \brief Записує рядок як JSON-рядок у лапках.
+/// \details Лапки, зворотна скісна риска й керівні символи екрануються
+/// (`\n`, `\r`, `\t` або `\u00XX`), тож результат — коректний JSON для
+/// будь-якого вмісту. Байти UTF-8 виводяться як є.
+/// \param out Потік виведення.
+/// \param text Рядок для запису.
+void writeJsonString(std::ostream& out, const std::string& text);
+
+/// \brief Повертає перцентиль відсортованої вибірки (найближчий ранг).
+/// \param sorted Вибірка, впорядкована за зростанням.
+/// \param fraction Частка від 0 до 1, наприклад 0.99.
+/// \return Значення перцентиля або нуль для порожньої вибірки.
+template <typename T>
+T percentile(const std::vector<T>& sorted, double fraction)
+{
+   if (sorted.empty())
+   {
+      return T{};
+   }
+
+   const std::size_t rank = static_cast<std::size_t>(
+      fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+   return sorted[std::min(rank, sorted.size() - 1)];
+}
@@ -0,0 +1,109 @@
+// Result.h
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+
+/// \file Result.h
+/// \brief Типи для повернення помилок як значень у програмному API.
+
+/// \brief Категорія помилки програмного API.
+enum class ErrorCode
+{
+   InvalidArgument, ///< Некоректні вхідні параметри.
+   NotFound,        ///< Потрібний об'єкт не знайдено.
+   SoldOut,         ///< Вільних місць на тур не залишилося.
+   IoError,         ///< Помилка читання або запису файлу.
+   Conflict         ///< Об'єкт змінено іншим записом після прочитання.
+};
+
+/// \brief Опис помилки: категорія та текст для користувача.
+struct Error
+{
+   ErrorCode   code = ErrorCode::InvalidArgument;
+   std::string message;
+};
+
+/// \class Result
+/// \brief Результат операції: або значення, або помилка.
+/// \tparam T Тип значення при успішному виконанні.
+template <typename T>
+class Result
+{
+public:
+   /// \brief Створює успішний результат.
+   /// \param value Значення результату.
+   Result(T value)
+      : storedValue(std::move(value))
+   {
+   }
+
+   /// \brief Створює результат з помилкою.
+   /// \param error Опис помилки.
+   Result(Error error)
+      : storedError(std::move(error))
+   {
+   }
+
+   /// \brief Повертає true, якщо операція виконана успішно.
+   bool ok() const
+   {
+      return storedValue.has_value();
+   }
+
+   /// \brief Повертає значення успішного результату.
+   const T& value() const
+   {
+      return *storedValue;
+   }
+
+   /// \brief Повертає значення успішного результату для зміни.
+   T& value()
+   {
+      return *storedValue;
+   }
+
+   /// \brief Повертає опис помилки неуспішного результату.
+   const Error& error() const
+   {
+      return storedError;
+   }
+
+private:
+   std::optional<T> storedValue;
+   Error            storedError;
+};
+
+/// \brief Спеціалізація для операцій без значення.
+template <>
+class Result<void>
+{
+public:
+   /// \brief Створює успішний результат.
+   Result() = default;
+
+   /// \brief Створює результат з помилкою.
+   /// \param error Опис помилки.
+   Result(Error error)
+      : failed(true),
+        storedError(std::move(error))
+   {
+   }
+
+   /// \brief Повертає true, якщо операція виконана успішно.
+   bool ok() const
+   {
+      return !failed;
+   }
+
+   /// \brief Повертає опис помилки неуспішного результату.
+   const Error& error() const
+   {
+      return storedError;
+   }
+
+private:
+   bool  failed = false;
+   Error storedError;
+};
@@ -0,0 +1,108 @@
+// SeatInventory.cpp
+
+#include "SeatInventory.h"
+#include "Metrics.h"
+
+#include <algorithm>
+
+SeatInventory::SeatInventory(int capacity, int sold)
+   : freeSeats(0),
+     totalSeats(std::max(capacity, 0))
+{
+   const int total = totalSeats.load(std::memory_order_relaxed);
+   freeSeats.store(total - std::clamp(sold, 0, total),
+      std::memory_order_relaxed);
+}
+
+bool SeatInventory::tryReserve(int seats)
+{
+   if (seats <= 0)
+   {
+      return false;
+   }
+
+   int current = freeSeats.load(std::memory_order_relaxed);
+   std::uint64_t retries = 0;
+   bool reserved = false;
+
+   while (current >= seats)
+   {
+      if (freeSeats.compare_exchange_weak(current, current - seats,
+             std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+         reserved = true;
+         break;
+      }
+      ++retries;
+   }
+
+   if (retries != 0)
+   {
+      Metrics::retried(Contention::SeatCounter, retries);
+   }
+
+   return reserved;
+}
+
+void SeatInventory::release(int seats)
+{
+   if (seats > 0)
+   {
+      freeSeats.fetch_add(seats, std::memory_order_acq_rel);
+   }
+}
+
+void SeatInventory::take(int seats)
+{
+   if (seats > 0)
+   {
+      freeSeats.fetch_sub(seats, std::memory_order_acq_rel);
+   }
+}
+
+void SeatInventory::setSold(int sold)
+{
+   freeSeats.store(totalSeats.load(std::memory_order_relaxed)
+      - std::max(sold, 0), std::memory_order_release);
+}
+
+Result<void> SeatInventory::resize(int newCapacity)
+{
+   if (newCapacity < 0)
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Кількість місць не може бути від'ємною."};
+   }
+
+   const int delta =
+      newCapacity - totalSeats.load(std::memory_order_acquire);
+   int current = freeSeats.load(std::memory_order_relaxed);
+
+   do
+   {
+      if (current + delta < 0)
+      {
+         return Error{ErrorCode::InvalidArgument,
+            "Продано більше місць, ніж нова місткість туру."};
+      }
+   }
+   while (!freeSeats.compare_exchange_weak(current, current + delta,
+             std::memory_order_acq_rel, std::memory_order_relaxed));
+
+   totalSeats.store(newCapacity, std::memory_order_release);
+   return {};
+}
+
+SeatInventory::Counts SeatInventory::counts() const
+{
+   Counts result;
+   result.capacity = capacity();
+   result.available = std::clamp(available(), 0, result.capacity);
+   return result;
+}
+
+int SeatInventory::sold() const
+{
+   const Counts current = counts();
+   return current.capacity - current.available;
+}
@@ -0,0 +1,91 @@
+// SeatInventory.h
+#pragma once
+
+#include "Result.h"
+
+#include <atomic>
+
+/// \file SeatInventory.h
+/// \brief Лічильник вільних місць туру для конкурентного бронювання.
+
+/// \class SeatInventory
+/// \brief Місткість туру та кількість вільних місць.
+/// \details Бронювання зменшує лічильник через compare-and-swap без
+/// блокувань, тому потоки, що бронюють один популярний тур, не
+/// вишиковуються за спільним м'ютексом і не можуть продати більше
+/// місць, ніж є. Лічильник займає власну кеш-лінію, щоб сусідні
+/// тури не заважали один одному.
+///
+/// Об'єкт спільний для всіх версій каталогу, у яких є тур, тому
+/// редагування туру не скидає продані місця.
+class alignas(64) SeatInventory
+{
+public:
+   /// \brief Місткість для турів, у яких вона не задана.
+   static constexpr int defaultCapacity = 30;
+
+   /// \brief Знімок лічильників для відображення.
+   struct Counts
+   {
+      int capacity = 0;
+      int available = 0;
+   };
+
+   /// \brief Створює лічильник.
+   /// \param capacity Загальна кількість місць (не менше 0).
+   /// \param sold Уже продані місця (обмежуються місткістю).
+   explicit SeatInventory(int capacity = defaultCapacity, int sold = 0);
+
+   /// \brief Намагається зарезервувати місця.
+   /// \param seats Кількість місць (більше 0).
+   /// \return true, якщо місця зарезервовано; false, якщо їх не вистачає.
+   bool tryReserve(int seats = 1);
+
+   /// \brief Повертає раніше зарезервовані місця.
+   /// \param seats Кількість місць.
+   void release(int seats = 1);
+
+   /// \brief Списує місця без перевірки, чи їх вистачає.
+   /// \details Для квитків, уже записаних у журнал в обхід бронювання
+   /// (імпорт): вільних місць може стати менше нуля, і тоді тур не
+   /// продається, доки скасування не покриють нестачу.
+   /// \param seats Кількість місць.
+   void take(int seats);
+
+   /// \brief Встановлює кількість проданих місць.
+   /// \details На відміну від конструктора не обмежує продані місця
+   /// місткістю, щоб скасування продажу понад місткість не відкривали
+   /// місця. Викликається до публікації лічильника в каталозі.
+   /// \param sold Продані місця за журналом квитків.
+   void setSold(int sold);
+
+   /// \brief Змінює місткість, зберігаючи вже продані місця.
+   /// \details Викликається лише письменником каталогу, але безпечна
+   /// щодо одночасних бронювань.
+   /// \param newCapacity Нова місткість.
+   /// \return Помилка, якщо продано більше місць, ніж нова місткість.
+   Result<void> resize(int newCapacity);
+
+   /// \brief Повертає поточну місткість і кількість вільних місць.
+   Counts counts() const;
+
+   /// \brief Повертає загальну кількість місць.
+   int capacity() const
+   {
+      return totalSeats.load(std::memory_order_acquire);
+   }
+
+   /// \brief Повертає кількість вільних місць; від'ємна означає
+   /// перепродаж.
+   int available() const
+   {
+      return freeSeats.load(std::memory_order_acquire);
+   }
+
+   /// \brief Повертає кількість проданих місць.
+   int sold() const;
+
+private:
+   std::atomic<int> freeSeats;
+   std::atomic<int> totalSeats;
+};
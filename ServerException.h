@@ -0,0 +1,17 @@
+// ServerException.h
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/// \brief Виключення, пов'язане з помилками мережевого серверного режиму.
+class ServerException : public std::runtime_error
+{
+public:
+    /// \brief Створює виняток серверного режиму з повідомленням.
+    /// \param msg Опис помилки.
+    explicit ServerException(const std::string& msg)
+       : std::runtime_error("Помилка сервера: " + msg)
+    {
+    }
+};
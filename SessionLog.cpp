@@ -0,0 +1,288 @@
+// SessionLog.cpp
+
+#include "SessionLog.h"
+#include "FileException.h"
+#include "ReportFormat.h"
+
+#include <istream>
+#include <ostream>
+#include <thread>
+
+namespace
+{
+   const char* const sessionHeader = "# tours-session 1";
+
+   void writeEscaped(std::ostream& out, const std::string& text)
+   {
+      for (char ch : text)
+      {
+         if (ch == '\\')
+         {
+            out << "\\\\";
+         }
+         else if (ch == '\r')
+         {
+            out << "\\r";
+         }
+         else
+         {
+            out << ch;
+         }
+      }
+   }
+
+   bool unescape(const std::string& text, std::size_t from, std::string& out)
+   {
+      out.clear();
+
+      for (std::size_t i = from; i < text.size(); ++i)
+      {
+         if (text[i] != '\\')
+         {
+            out.push_back(text[i]);
+            continue;
+         }
+
+         if (++i == text.size())
+         {
+            return false;
+         }
+
+         if (text[i] == '\\')
+         {
+            out.push_back('\\');
+         }
+         else if (text[i] == 'r')
+         {
+            out.push_back('\r');
+         }
+         else
+         {
+            return false;
+         }
+      }
+
+      return true;
+   }
+}
+
+SessionRecorder::SessionRecorder(std::istream& input, const std::string& path)
+   : input(input),
+     source(input.rdbuf()),
+     file(path, std::ios::trunc)
+{
+   if (!file)
+   {
+      throw FileException("Не вдалося створити файл сесії: " + path);
+   }
+
+   file << sessionHeader << '\n';
+   file.flush();
+
+   input.rdbuf(this);
+}
+
+SessionRecorder::~SessionRecorder()
+{
+   input.rdbuf(source);
+}
+
+SessionRecorder::int_type SessionRecorder::underflow()
+{
+   if (gptr() < egptr())
+   {
+      return traits_type::to_int_type(*gptr());
+   }
+
+   // Час роздумів — від запиту програми до отримання всього рядка.
+   const auto asked = std::chrono::steady_clock::now();
+
+   line.clear();
+   for (int_type ch = source->sbumpc();
+        !traits_type::eq_int_type(ch, traits_type::eof());
+        ch = source->sbumpc())
+   {
+      line.push_back(traits_type::to_char_type(ch));
+      if (line.back() == '\n')
+      {
+         break;
+      }
+   }
+
+   if (line.empty())
+   {
+      return traits_type::eof();
+   }
+
+   const auto think = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - asked);
+
+   // Рядок без переносу (кінець введення) відтворюється з переносом.
+   const bool terminated = line.back() == '\n';
+   file << think.count() << ' ';
+   writeEscaped(file, terminated ? line.substr(0, line.size() - 1) : line);
+   file << '\n';
+   file.flush();
+
+   setg(&line[0], &line[0], &line[0] + line.size());
+   return traits_type::to_int_type(*gptr());
+}
+
+SessionPlayer::SessionPlayer(std::istream& input, std::ostream& output,
+   const std::string& path, double speed)
+   : input(input),
+     output(output),
+     savedInput(input.rdbuf()),
+     savedOutput(output.rdbuf()),
+     savedExceptions(input.exceptions()),
+     path(path),
+     speed(speed)
+{
+   std::ifstream file(path);
+   if (!file)
+   {
+      throw FileException("Не вдалося відкрити файл сесії: " + path);
+   }
+
+   std::string line;
+   if (!std::getline(file, line) || line != sessionHeader)
+   {
+      throw FileException("Невідомий формат файлу сесії: " + path);
+   }
+
+   std::size_t lineNumber = 1;
+   while (std::getline(file, line))
+   {
+      ++lineNumber;
+
+      const std::size_t space = line.find(' ');
+      Record record;
+      std::size_t used = 0;
+
+      try
+      {
+         record.thinkMicros = std::stoull(line.substr(0, space), &used);
+      }
+      catch (const std::exception&)
+      {
+         used = 0;
+      }
+
+      if (space == std::string::npos || used != space
+          || !unescape(line, space + 1, record.text))
+      {
+         throw FileException("Пошкоджений рядок " + std::to_string(lineNumber)
+            + " у файлі сесії: " + path);
+      }
+
+      records.push_back(std::move(record));
+   }
+
+   input.rdbuf(this);
+   output.rdbuf(&discard);
+
+   // Потік перекидає далі виняток буфера лише з badbit у масці.
+   input.exceptions(savedExceptions | std::ios::badbit);
+   started = Clock::now();
+}
+
+SessionPlayer::~SessionPlayer()
+{
+   finish();
+}
+
+SessionPlayer::int_type SessionPlayer::underflow()
+{
+   if (gptr() < egptr())
+   {
+      return traits_type::to_int_type(*gptr());
+   }
+
+   const Clock::time_point asked = Clock::now();
+   if (next != 0)
+   {
+      responseNs.push_back(static_cast<std::uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(
+            asked - deliveredAt).count()));
+   }
+
+   if (next == records.size())
+   {
+      // Оригінальна сесія на цьому місці обірвалася.
+      throw SessionEnded();
+   }
+
+   const Record& record = records[next++];
+
+   if (speed > 0.0 && record.thinkMicros != 0)
+   {
+      std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(
+         static_cast<double>(record.thinkMicros) / speed));
+      waited += Clock::now() - asked;
+   }
+
+   current = record.text;
+   current.push_back('\n');
+   setg(&current[0], &current[0], &current[0] + current.size());
+
+   deliveredAt = Clock::now();
+   return traits_type::to_int_type(*gptr());
+}
+
+void SessionPlayer::finish()
+{
+   if (finished)
+   {
+      return;
+   }
+   finished = true;
+
+   const Clock::time_point now = Clock::now();
+   if (next != 0 && responseNs.size() < next)
+   {
+      responseNs.push_back(static_cast<std::uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - deliveredAt).count()));
+   }
+
+   output.flush();
+   input.rdbuf(savedInput);
+   input.exceptions(savedExceptions);
+   output.rdbuf(savedOutput);
+
+   const auto millis = [](Clock::duration duration)
+   {
+      return std::chrono::duration<double, std::milli>(duration).count();
+   };
+
+   output << "{\"session\":";
+   writeJsonString(output, path);
+   output << ",\"inputs\":" << records.size()
+          << ",\"consumed\":" << next
+          << ",\"elapsedMs\":" << millis(now - started)
+          << ",\"thinkMs\":" << millis(waited)
+          << ",\"outputBytes\":" << discard.bytes
+          << ",\"responseNs\":[";
+   for (std::size_t i = 0; i < responseNs.size(); ++i)
+   {
+      output << (i == 0 ? "" : ",") << responseNs[i];
+   }
+   output << "]}\n";
+   output.flush();
+}
+
+SessionPlayer::Discard::int_type SessionPlayer::Discard::overflow(int_type ch)
+{
+   if (!traits_type::eq_int_type(ch, traits_type::eof()))
+   {
+      ++bytes;
+   }
+   return traits_type::not_eof(ch);
+}
+
+std::streamsize SessionPlayer::Discard::xsputn(const char*,
+   std::streamsize count)
+{
+   bytes += static_cast<std::uint64_t>(count);
+   return count;
+}
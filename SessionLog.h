@@ -0,0 +1,146 @@
+// SessionLog.h
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <ios>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/// \file SessionLog.h
+/// \brief Запис і відтворення інтерактивних сесій.
+///
+/// Файл сесії — текст: рядок-заголовок `# tours-session 1`, далі по одному
+/// рядку на кожен введений рядок: `<мікросекунди> <текст>`. Мікросекунди —
+/// час роздумів, тобто скільки програма чекала на цей рядок. У тексті
+/// `\` записується як `\\`, а символ повернення каретки — як `\r`.
+///
+/// Файл містить усе введене, зокрема логіни й паролі, тому сесії варто
+/// записувати під тестовими обліковими записами.
+
+/// \class SessionEnded
+/// \brief Виняток, яким SessionPlayer завершує вичерпану сесію.
+/// \details Летить крізь читання з потоку введення (SessionPlayer вмикає
+/// для нього badbit у масці винятків) і має бути перехоплений там, де
+/// завершується інтерактивна сесія: розгортання стеку знищує менеджери
+/// та зупиняє їхні фонові потоки так само, як звичайний вихід з меню.
+class SessionEnded : public std::exception
+{
+public:
+   const char* what() const noexcept override
+   {
+      return "Відтворену сесію завершено.";
+   }
+};
+
+/// \class SessionRecorder
+/// \brief Буфер потоку, що пропускає введення з джерела і записує кожен
+/// рядок у файл сесії.
+/// \details Під час створення підміняє буфер потоку введення, під час
+/// знищення повертає попередній. Рядок записується і скидається на диск,
+/// щойно програма його отримала, тож обірвана сесія теж зберігається.
+class SessionRecorder : public std::streambuf
+{
+public:
+   /// \brief Починає запис.
+   /// \param input Потік введення, зазвичай std::cin.
+   /// \param path Файл сесії; перезаписується.
+   /// \throws FileException Якщо файл не вдається створити.
+   SessionRecorder(std::istream& input, const std::string& path);
+
+   /// \brief Повертає потоку введення попередній буфер.
+   ~SessionRecorder() override;
+
+   SessionRecorder(const SessionRecorder&) = delete;
+   SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+protected:
+   int_type underflow() override;
+
+private:
+   std::istream&   input;
+   std::streambuf* source;
+   std::ofstream   file;
+   std::string     line;
+};
+
+/// \class SessionPlayer
+/// \brief Буфер потоку, що подає програмі рядки з файлу сесії.
+/// \details Перед кожним рядком витримується записаний час роздумів,
+/// поділений на speed; speed = 0 подає рядки без очікування. Виведення
+/// програми відкидається (але форматується, як і під час справжньої
+/// сесії), а для кожного рядка вимірюється час відповіді — від подачі
+/// рядка до наступного запиту введення.
+///
+/// Якщо програма просить введення після останнього рядка, сесія
+/// вважається завершеною так само, як в оригіналі (користувач закрив
+/// термінал): читання кидає SessionEnded. Кінець файлу тут не підходить,
+/// бо меню на помилці введення просто повторюють запит. Підсумок виводить
+/// деструктор, коли програма завершується — після SessionEnded чи раніше.
+class SessionPlayer : public std::streambuf
+{
+public:
+   /// \brief Завантажує сесію і підміняє буфери потоків.
+   /// \param input Потік введення, зазвичай std::cin.
+   /// \param output Потік виведення, зазвичай std::cout; у нього ж
+   /// виводиться підсумок.
+   /// \param path Файл сесії.
+   /// \param speed Множник швидкості; 0 — без очікувань.
+   /// \throws FileException Якщо файл не вдається прочитати або він
+   /// має невідомий формат.
+   SessionPlayer(std::istream& input, std::ostream& output,
+      const std::string& path, double speed);
+
+   /// \brief Повертає буфери потоків і виводить підсумок.
+   ~SessionPlayer() override;
+
+   SessionPlayer(const SessionPlayer&) = delete;
+   SessionPlayer& operator=(const SessionPlayer&) = delete;
+
+protected:
+   int_type underflow() override;
+
+private:
+   using Clock = std::chrono::steady_clock;
+
+   struct Record
+   {
+      std::uint64_t thinkMicros = 0;
+      std::string   text;
+   };
+
+   /// \brief Відкидає виведення, рахуючи байти.
+   class Discard : public std::streambuf
+   {
+   public:
+      std::uint64_t bytes = 0;
+
+   protected:
+      int_type overflow(int_type ch) override;
+      std::streamsize xsputn(const char* data, std::streamsize count) override;
+   };
+
+   std::istream&              input;
+   std::ostream&              output;
+   std::streambuf*            savedInput;
+   std::streambuf*            savedOutput;
+   std::ios::iostate          savedExceptions;
+   Discard                    discard;
+   std::string                path;
+   double                     speed;
+   std::vector<Record>        records;
+   std::size_t                next = 0;
+   std::string                current;
+   Clock::time_point          started;
+   Clock::time_point          deliveredAt;
+   Clock::duration            waited{};
+   std::vector<std::uint64_t> responseNs;
+   bool                       finished = false;
+
+   /// \brief Повертає буфери потоків і один раз виводить підсумок.
+   void finish();
+};
@@ -0,0 +1,328 @@
+// SessionReplay.cpp
+
+#include "SessionReplay.h"
+#include "FileException.h"
+#include "ReportFormat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+SessionReplay::SessionReplay(ReplayOptions options)
+   : options(std::move(options))
+{
+}
+
+#ifdef __linux__
+
+namespace
+{
+   using Clock = std::chrono::steady_clock;
+
+   /// \brief Замінює `<slot>/data` свіжою копією вихідного каталогу даних.
+   /// \throws FileException Якщо каталог не вдається видалити чи скопіювати.
+   void resetSlotData(const std::string& slot, const std::string& source)
+   {
+      namespace fs = std::filesystem;
+
+      try
+      {
+         const fs::path data = fs::path(slot) / "data";
+         fs::remove_all(data);
+         if (fs::exists(source))
+         {
+            fs::copy(source, data, fs::copy_options::recursive);
+         }
+      }
+      catch (const fs::filesystem_error& ex)
+      {
+         throw FileException(ex.what());
+      }
+   }
+
+   struct Launch
+   {
+      std::size_t       session = 0;
+      std::size_t       slot = 0;
+      pid_t             pid = -1;
+      Clock::time_point started;
+      double            elapsedMs = 0.0;
+      int               exitCode = -1;
+      std::string       resultPath;
+      double            inputs = 0.0;
+      double            consumed = 0.0;
+   };
+
+   /// \brief Шукає числове поле у плоскому JSON-підсумку SessionPlayer.
+   bool findNumber(const std::string& json, const std::string& key,
+      double& value)
+   {
+      const std::string pattern = "\"" + key + "\":";
+      const std::size_t at = json.find(pattern);
+      if (at == std::string::npos)
+      {
+         return false;
+      }
+
+      char* end = nullptr;
+      const char* start = json.c_str() + at + pattern.size();
+      value = std::strtod(start, &end);
+      return end != start;
+   }
+
+   /// \brief Дописує до samples масив responseNs з підсумку.
+   void appendResponses(const std::string& json,
+      std::vector<std::uint64_t>& samples)
+   {
+      const std::string pattern = "\"responseNs\":[";
+      std::size_t at = json.find(pattern);
+      if (at == std::string::npos)
+      {
+         return;
+      }
+
+      const char* cursor = json.c_str() + at + pattern.size();
+      while (*cursor != ']' && *cursor != '\0')
+      {
+         char* end = nullptr;
+         const unsigned long long value = std::strtoull(cursor, &end, 10);
+         if (end == cursor)
+         {
+            return;
+         }
+
+         samples.push_back(static_cast<std::uint64_t>(value));
+         cursor = *end == ',' ? end + 1 : end;
+      }
+   }
+}
+
+std::size_t SessionReplay::run(std::ostream& out)
+{
+   namespace fs = std::filesystem;
+
+   if (options.sessions.empty() || options.parallel == 0)
+   {
+      return 0;
+   }
+
+   std::vector<std::string> sessions;
+   for (const std::string& session : options.sessions)
+   {
+      if (!fs::is_regular_file(session))
+      {
+         throw FileException("Файл сесії не знайдено: " + session);
+      }
+      sessions.push_back(fs::absolute(session).string());
+   }
+
+   std::vector<Launch> launches(sessions.size() * options.repeat);
+   const std::size_t slotCount = std::min(options.parallel, launches.size());
+
+   // Кожен слот працює з власною копією даних; копія оновлюється перед
+   // кожним запуском у слоті.
+   std::vector<std::string> slots;
+   try
+   {
+      for (std::size_t slot = 0; slot < slotCount; ++slot)
+      {
+         const fs::path directory =
+            fs::path(options.directory) / std::to_string(slot);
+         fs::remove_all(directory);
+         fs::create_directories(directory);
+         slots.push_back(directory.string());
+      }
+   }
+   catch (const fs::filesystem_error& ex)
+   {
+      throw FileException(ex.what());
+   }
+
+   std::ostringstream speedText;
+   if (options.speed > 0.0)
+   {
+      speedText << "speed=" << options.speed;
+   }
+   else
+   {
+      speedText << "speed=max";
+   }
+   const std::string speedArgument = speedText.str();
+
+   std::vector<std::size_t> freeSlots;
+   for (std::size_t slot = slotCount; slot-- > 0;)
+   {
+      freeSlots.push_back(slot);
+   }
+
+   const Clock::time_point wallStart = Clock::now();
+   std::size_t nextLaunch = 0;
+   std::size_t running = 0;
+
+   while (nextLaunch < launches.size() || running != 0)
+   {
+      while (nextLaunch < launches.size() && !freeSlots.empty())
+      {
+         Launch& launch = launches[nextLaunch];
+         launch.session = nextLaunch % sessions.size();
+         launch.slot = freeSlots.back();
+         launch.resultPath = slots[launch.slot] + "/run-"
+            + std::to_string(nextLaunch) + ".json";
+
+         // Попередня сесія слоту могла зберегти каталог: кожен запуск
+         // починає з тих самих даних.
+         resetSlotData(slots[launch.slot], options.dataDirectory);
+
+         // Усе, що потрібно дочірньому процесу, готується до fork().
+         const std::string directory = slots[launch.slot];
+         const std::string resultPath = launch.resultPath;
+         const std::string errorPath = directory + "/stderr.log";
+         std::string program = "/proc/self/exe";
+         std::string mode = "--play";
+         std::string session = sessions[launch.session];
+         std::string speed = speedArgument;
+         char* arguments[] =
+            {&program[0], &mode[0], &session[0], &speed[0], nullptr};
+
+         const pid_t pid = ::fork();
+         if (pid < 0)
+         {
+            throw FileException("Не вдалося запустити процес відтворення.");
+         }
+
+         if (pid == 0)
+         {
+            const int result = ::open(resultPath.c_str(),
+               O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            const int errors = ::open(errorPath.c_str(),
+               O_WRONLY | O_CREAT | O_APPEND, 0644);
+            const int nothing = ::open("/dev/null", O_RDONLY);
+
+            if (result < 0 || errors < 0 || nothing < 0
+                || ::dup2(nothing, 0) < 0 || ::dup2(result, 1) < 0
+                || ::dup2(errors, 2) < 0 || ::chdir(directory.c_str()) != 0)
+            {
+               ::_exit(126);
+            }
+
+            for (const int fd : {result, errors, nothing})
+            {
+               if (fd > 2)
+               {
+                  ::close(fd);
+               }
+            }
+            ::execv(program.c_str(), arguments);
+            ::_exit(127);
+         }
+
+         launch.pid = pid;
+         launch.started = Clock::now();
+         freeSlots.pop_back();
+         ++running;
+         ++nextLaunch;
+      }
+
+      int status = 0;
+      const pid_t finished = ::waitpid(-1, &status, 0);
+      if (finished < 0)
+      {
+         break;
+      }
+
+      for (Launch& launch : launches)
+      {
+         if (launch.pid != finished)
+         {
+            continue;
+         }
+
+         launch.pid = -1;
+         launch.elapsedMs = std::chrono::duration<double, std::milli>(
+            Clock::now() - launch.started).count();
+         launch.exitCode = WIFEXITED(status) ? WEXITSTATUS(status)
+                                             : 128 + WTERMSIG(status);
+         freeSlots.push_back(launch.slot);
+         --running;
+         break;
+      }
+   }
+
+   const double wallMs = std::chrono::duration<double, std::milli>(
+      Clock::now() - wallStart).count();
+
+   std::vector<std::uint64_t> responses;
+   std::size_t failed = 0;
+   double inputs = 0.0;
+
+   for (Launch& launch : launches)
+   {
+      std::ifstream file(launch.resultPath);
+      std::string summary;
+      std::getline(file, summary);
+
+      if (launch.exitCode != 0 || !findNumber(summary, "inputs", launch.inputs)
+          || !findNumber(summary, "consumed", launch.consumed))
+      {
+         ++failed;
+         continue;
+      }
+
+      inputs += launch.consumed;
+      appendResponses(summary, responses);
+   }
+
+   std::sort(responses.begin(), responses.end());
+
+   out << "{\"runs\":" << launches.size()
+       << ",\"failed\":" << failed
+       << ",\"parallel\":" << options.parallel
+       << ",\"speed\":" << options.speed
+       << ",\"wallMs\":" << wallMs
+       << ",\"inputs\":" << inputs
+       << ",\"inputsPerSecond\":" << (wallMs > 0.0 ? inputs * 1000.0 / wallMs : 0.0)
+       << ",\"responseNs\":{\"count\":" << responses.size()
+       << ",\"p50\":" << percentile(responses, 0.50)
+       << ",\"p90\":" << percentile(responses, 0.90)
+       << ",\"p99\":" << percentile(responses, 0.99)
+       << ",\"max\":" << (responses.empty() ? 0 : responses.back())
+       << "},\"runsDetail\":[";
+
+   for (std::size_t i = 0; i < launches.size(); ++i)
+   {
+      const Launch& launch = launches[i];
+      out << (i == 0 ? "\n  " : ",\n  ") << "{\"session\":";
+      writeJsonString(out, options.sessions[launch.session]);
+      out << ",\"slot\":" << launch.slot
+          << ",\"exitCode\":" << launch.exitCode
+          << ",\"elapsedMs\":" << launch.elapsedMs
+          << ",\"inputs\":" << launch.inputs
+          << ",\"consumed\":" << launch.consumed << '}';
+   }
+   out << "\n]}\n";
+   out.flush();
+
+   return failed;
+}
+
+#else
+
+std::size_t SessionReplay::run(std::ostream&)
+{
+   throw FileException("Паралельне відтворення сесій підтримується лише в Linux.");
+}
+
+#endif
@@ -0,0 +1,52 @@
+// SessionReplay.h
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// \file SessionReplay.h
+/// \brief Паралельне відтворення записаних сесій окремими процесами.
+
+/// \brief Параметри відтворення.
+struct ReplayOptions
+{
+   std::vector<std::string> sessions;                ///< Файли сесій (див. SessionLog.h).
+   std::size_t              parallel = 1;            ///< Одночасних процесів.
+   std::size_t              repeat = 1;              ///< Скільки разів відтворити кожну сесію.
+   double                   speed = 1.0;             ///< Множник швидкості; 0 — без очікувань.
+   std::string              directory = "replay";    ///< Робочі каталоги процесів.
+   std::string              dataDirectory = "data";  ///< Дані, що копіюються кожному процесу.
+};
+
+/// \class SessionReplay
+/// \brief Запускає записані сесії в дочірніх процесах `--play` і зводить
+/// їхні результати.
+/// \details Кожен з parallel слотів отримує власну копію каталогу даних у
+/// `<directory>/<номер слоту>/data`, тож збереження каталогу в одній сесії
+/// не заважає іншим. Копія робиться заново перед кожним запуском, тож
+/// кожне відтворення (зокрема повторні з repeat) починає з тих самих даних. Сесії запускаються по черзі у вільних слотах;
+/// стандартне виведення процесу (підсумок SessionPlayer) зберігається у
+/// `run-<номер>.json`, помилки дописуються у `stderr.log` слоту.
+///
+/// Звіт — JSON з пропускною здатністю, перцентилями часу відповіді на
+/// введений рядок по всіх сесіях і результатом кожного запуску.
+/// Підтримується лише в Linux.
+class SessionReplay
+{
+public:
+   /// \brief Створює відтворення.
+   /// \param options Параметри відтворення.
+   explicit SessionReplay(ReplayOptions options);
+
+   /// \brief Виконує всі запуски і виводить звіт.
+   /// \param out Потік для JSON-звіту.
+   /// \return Кількість запусків, що завершилися з помилкою.
+   /// \throws FileException Якщо не вдається підготувати каталоги,
+   /// запустити процес або платформа не підтримується.
+   std::size_t run(std::ostream& out);
+
+private:
+   ReplayOptions options;
+};
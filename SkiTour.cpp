@@ -2,15 +2,26 @@
 /// \brief Реалізація класу SkiTour — гірськолижний тур.
 
 #include "SkiTour.h"
+#include "CsvScanner.h"
 #include "FileException.h"
+#include "AllocationStats.h"
+#include "MemoryReport.h"
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <cctype>
 #include <string>
 
 namespace
 {
+/// \brief Поля CSV-рядка гірськолижного туру в порядку запису.
+const char* const fieldNames[] =
+{
+   "country", "resort", "difficulty", "equipmentIncluded",
+   "insuranceIncluded", "departureDate", "returnDate", "price"
+};
+
 bool isValidDate(const std::string& date)
 {
    if (date.size() != 10)
@@ -112,55 +123,33 @@ bool tryParsePrice(const std::string& text, double& value)
 }
 
 SkiTour::SkiTour(const std::string& csvLine)
+   : SkiTour(CsvRow(csvLine), 0)
 {
-   std::istringstream iss(csvLine);
-   std::string token;
-
-   if (!std::getline(iss, country, ','))
-   {
-      throw FileException("Немає поля country у SkiTour.");
-   }
-
-   if (!std::getline(iss, resort, ','))
-   {
-      throw FileException("Немає поля resort у SkiTour.");
-   }
-
-   if (!std::getline(iss, difficulty, ','))
-   {
-      throw FileException("Немає поля difficulty у SkiTour.");
-   }
-
-   if (!std::getline(iss, token, ','))
-   {
-      throw FileException("Немає поля equipmentIncluded у SkiTour.");
-   }
-   equipmentIncluded = (token == "1");
-
-   if (!std::getline(iss, token, ','))
-   {
-      throw FileException("Немає поля insuranceIncluded у SkiTour.");
-   }
-   insuranceIncluded = (token == "1");
+}
 
-   if (!std::getline(iss, departureDate, ','))
-   {
-      throw FileException("Немає поля departureDate у SkiTour.");
-   }
+SkiTour::SkiTour(const CsvRow& row, std::size_t first)
+{
+   constexpr std::size_t fieldCount =
+      sizeof(fieldNames) / sizeof(fieldNames[0]);
 
-   if (!std::getline(iss, returnDate, ','))
+   if (row.size() < first + fieldCount)
    {
-      throw FileException("Немає поля returnDate у SkiTour.");
+      const std::size_t present = row.size() > first ? row.size() - first : 0;
+      throw FileException(std::string("Немає поля ") + fieldNames[present]
+         + " у SkiTour.");
    }
 
-   if (!std::getline(iss, token))
-   {
-      throw FileException("Немає поля price у SkiTour.");
-   }
+   row.copyField(first, country);
+   row.copyField(first + 1, resort);
+   row.copyField(first + 2, difficulty);
+   equipmentIncluded = row.field(first + 3) == "1";
+   insuranceIncluded = row.field(first + 4) == "1";
+   row.copyField(first + 5, departureDate);
+   row.copyField(first + 6, returnDate);
 
    try
    {
-      price = std::stod(token);
+      price = std::stod(row.field(first + 7));
    }
    catch (...)
    {
@@ -178,7 +167,7 @@ SkiTour::SkiTour(const SkiTour& other)
      returnDate(other.returnDate),
      price(other.price)
 {
-   std::cout << "[Copy] SkiTour скопійовано\n";
+   AllocationStats::copied(TrackedType::SkiTour);
 }
 
 SkiTour::SkiTour(SkiTour&& other) noexcept
@@ -191,12 +180,12 @@ SkiTour::SkiTour(SkiTour&& other) noexcept
      returnDate(std::move(other.returnDate)),
      price(other.price)
 {
-   std::cout << "[Move] SkiTour переміщено\n";
+   AllocationStats::moved(TrackedType::SkiTour);
 }
 
 SkiTour::~SkiTour()
 {
-   std::cout << "[Destructor] SkiTour видалено\n";
+   AllocationStats::destroyed(TrackedType::SkiTour);
 }
 
 void SkiTour::input()
@@ -359,14 +348,19 @@ std::string SkiTour::toCSV() const
 {
    std::ostringstream oss;
 
-   oss << country << ','
-       << resort << ','
-       << difficulty << ','
+   // Текстові поля беруться в лапки, лише якщо цього потребують.
+   CsvScanner::writeField(oss, country);
+   oss << ',';
+   CsvScanner::writeField(oss, resort);
+   oss << ',';
+   CsvScanner::writeField(oss, difficulty);
+   oss << ','
        << (equipmentIncluded ? "1" : "0") << ','
-       << (insuranceIncluded ? "1" : "0") << ','
-       << departureDate << ','
-       << returnDate << ','
-       << price;
+       << (insuranceIncluded ? "1" : "0") << ',';
+   CsvScanner::writeField(oss, departureDate);
+   oss << ',';
+   CsvScanner::writeField(oss, returnDate);
+   oss << ',' << price;
 
    return oss.str();
 }
@@ -520,3 +514,102 @@ void SkiTour::editInteractive()
       }
    }
 }
+
+std::shared_ptr<Tour> SkiTour::clone() const
+{
+   return std::make_shared<SkiTour>(*this);
+}
+
+Result<void> SkiTour::applyPatch(const TourPatch& patch)
+{
+   if (patch.accommodation || patch.transport
+       || patch.food || patch.extras)
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Гірськолижний тур не має полів проживання, транспорту, "
+         "харчування та додаткових вигод."};
+   }
+
+   const std::string newDeparture =
+      patch.departureDate.value_or(departureDate);
+   const std::string newReturn = patch.returnDate.value_or(returnDate);
+
+   if (patch.departureDate && !isValidDate(newDeparture))
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Некоректна дата відправлення: " + newDeparture};
+   }
+
+   if (patch.returnDate && !isValidDate(newReturn))
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Некоректна дата повернення: " + newReturn};
+   }
+
+   if (!newDeparture.empty() && !newReturn.empty()
+       && newReturn < newDeparture)
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Дата повернення не може бути раніше дати відправлення."};
+   }
+
+   if (patch.hotelLevel
+       && *patch.hotelLevel != "Easy"
+       && *patch.hotelLevel != "Medium"
+       && *patch.hotelLevel != "Hard")
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Складність має бути Easy, Medium або Hard."};
+   }
+
+   if (patch.price && !(*patch.price >= 0.0))
+   {
+      return Error{ErrorCode::InvalidArgument, "Некоректна ціна."};
+   }
+
+   if (patch.country)
+   {
+      country = *patch.country;
+   }
+
+   if (patch.city)
+   {
+      resort = *patch.city;
+   }
+
+   if (patch.hotelLevel)
+   {
+      difficulty = *patch.hotelLevel;
+   }
+
+   if (patch.equipmentIncluded)
+   {
+      equipmentIncluded = *patch.equipmentIncluded;
+   }
+
+   if (patch.insuranceIncluded)
+   {
+      insuranceIncluded = *patch.insuranceIncluded;
+   }
+
+   if (patch.price)
+   {
+      price = *patch.price;
+   }
+
+   departureDate = newDeparture;
+   returnDate = newReturn;
+
+   return {};
+}
+
+void SkiTour::accountMemory(MemoryReport& report) const
+{
+   TypeMemory& usage = report.type("SkiTour");
+   usage.addObject(sizeof(*this));
+   usage.addString("country", country);
+   usage.addString("resort", resort);
+   usage.addString("difficulty", difficulty);
+   usage.addString("departureDate", departureDate);
+   usage.addString("returnDate", returnDate);
+}
@@ -4,9 +4,12 @@
 #include "Tour.h"
 #include "ISerializable.h"
 
+#include <cstddef>
 #include <iostream>
 #include <string>
 
+struct CsvRow;
+
 /// \file SkiTour.h
 /// \brief Оголошення класу SkiTour — гірськолижний тур.
 
@@ -34,6 +37,12 @@ public:
    /// \param csvLine Рядок з даними туру у форматі CSV.
    explicit SkiTour(const std::string& csvLine);
 
+   /// \brief Створює гірськолижний тур з уже розбитого CSV-рядка.
+   /// \param row Поля рядка (див. CsvScanner).
+   /// \param first Номер першого поля туру; попередні поля — службові.
+   /// \throws FileException Якщо полів не вистачає або ціна некоректна.
+   SkiTour(const CsvRow& row, std::size_t first);
+
    /// \brief Створює копію гірськолижного туру.
    /// \param other Інший об’єкт SkiTour для копіювання.
    SkiTour(const SkiTour& other);
@@ -52,6 +61,7 @@ public:
    void display() const override;
 
    /// \brief Серіалізує тур у формат CSV.
+   /// \details Текстові поля за потреби беруться в лапки, як у CityTour.
    /// \return Рядок з даними туру у форматі CSV.
    std::string toCSV() const override;
 
@@ -99,4 +109,17 @@ public:
 
    /// \brief Дозволяє змінити параметри туру у інтерактивному режимі.
    void editInteractive() override;
+
+   /// \brief Створює незалежну копію туру.
+   /// \return Копія туру.
+   std::shared_ptr<Tour> clone() const override;
+
+   /// \brief Застосовує набір змін без консольного введення.
+   /// \param patch Поля, які потрібно змінити.
+   /// \return Порожній результат або опис помилки валідації.
+   Result<void> applyPatch(const TourPatch& patch) override;
+
+   /// \brief Додає розмір туру і його рядкових полів до звіту про пам'ять.
+   /// \param report Звіт, у якому накопичується облік.
+   void accountMemory(MemoryReport& report) const override;
 };
@@ -0,0 +1,362 @@
+// SlotMap.h
+#pragma once
+
+#include "ChunkedVector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/// \file SlotMap.h
+/// \brief Генераційна slot map зі стабільними 64-бітними ідентифікаторами.
+
+/// \brief Стабільний ідентифікатор елемента slot map.
+/// \details Молодші 32 біти — номер слота, старші 32 біти — покоління слота.
+using SlotId = std::uint64_t;
+
+/// \class SlotMap
+/// \brief Контейнер зі стабільними ідентифікаторами та видаленням за O(1).
+/// \details Значення зберігаються щільно, тому перебір іде без пропусків.
+/// Видалення переносить останній елемент на місце видаленого, а покоління
+/// слота збільшується, тож застарілий ідентифікатор більше не знаходить
+/// жодного елемента.
+///
+/// Усі масиви — ChunkedVector, тож копія контейнера ділить з оригіналом
+/// незмінені блоки: копія коштує n / ChunkedVector::chunkSize вказівників,
+/// а кожна наступна зміна копії — ще не більше кількох блоків.
+template <typename T>
+class SlotMap
+{
+public:
+   /// \brief Ідентифікатор, який ніколи не видається контейнером.
+   static constexpr SlotId invalidId = ~SlotId{0};
+
+   /// \brief Складає ідентифікатор із номера слота та покоління.
+   /// \param index Номер слота.
+   /// \param generation Покоління слота.
+   /// \return 64-бітний ідентифікатор.
+   static SlotId makeId(std::uint32_t index, std::uint32_t generation)
+   {
+      return (static_cast<SlotId>(generation) << 32) | index;
+   }
+
+   /// \brief Повертає номер слота з ідентифікатора.
+   static std::uint32_t indexOf(SlotId id)
+   {
+      return static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+   }
+
+   /// \brief Повертає покоління з ідентифікатора.
+   static std::uint32_t generationOf(SlotId id)
+   {
+      return static_cast<std::uint32_t>(id >> 32);
+   }
+
+   /// \brief Додає значення та повертає його новий ідентифікатор.
+   /// \param value Значення для додавання.
+   /// \return Стабільний ідентифікатор елемента.
+   SlotId insert(T value)
+   {
+      if (freeListStale)
+      {
+         rebuildFreeList();
+      }
+
+      std::uint32_t index = 0;
+      if (!freeSlots.empty())
+      {
+         index = freeSlots.back();
+         freeSlots.pop_back();
+      }
+      else
+      {
+         index = static_cast<std::uint32_t>(slots.size());
+         slots.push_back(Slot{});
+      }
+
+      Slot& slot = slots.mutableAt(index);
+      slot.dense = static_cast<std::uint32_t>(dense.size());
+      dense.push_back(std::move(value));
+      denseToSlot.push_back(index);
+
+      return makeId(index, slot.generation);
+   }
+
+   /// \brief Додає значення під заздалегідь відомим ідентифікатором.
+   /// \details Використовується під час відновлення збереженого каталогу.
+   /// Список вільних слотів перебудовується ліниво при наступному insert().
+   /// \param id Ідентифікатор, під яким треба розмістити значення.
+   /// \param value Значення для додавання.
+   /// \return false, якщо ідентифікатор некоректний або слот уже зайнятий.
+   bool insertAt(SlotId id, T value)
+   {
+      if (id == invalidId)
+      {
+         return false;
+      }
+
+      const std::uint32_t index = indexOf(id);
+
+      if (index >= slots.size())
+      {
+         slots.resize(static_cast<std::size_t>(index) + 1);
+      }
+
+      if (slots[index].dense != vacant)
+      {
+         return false;
+      }
+
+      Slot& slot = slots.mutableAt(index);
+      slot.generation = generationOf(id);
+      slot.dense = static_cast<std::uint32_t>(dense.size());
+      dense.push_back(std::move(value));
+      denseToSlot.push_back(index);
+      freeListStale = true;
+
+      return true;
+   }
+
+   /// \brief Відновлює вільний слот із збереженим поколінням.
+   /// \details Без цього вільний слот після перезапуску отримав би
+   /// покоління 0 і повторно видав би ідентифікатор видаленого елемента.
+   /// \param id Ідентифікатор, який слот видасть наступним (див. vacantIds()).
+   /// \return false, якщо ідентифікатор некоректний або слот уже зайнятий.
+   bool reserveAt(SlotId id)
+   {
+      if (id == invalidId)
+      {
+         return false;
+      }
+
+      const std::uint32_t index = indexOf(id);
+
+      if (index >= slots.size())
+      {
+         slots.resize(static_cast<std::size_t>(index) + 1);
+      }
+
+      if (slots[index].dense != vacant)
+      {
+         return false;
+      }
+
+      slots.mutableAt(index).generation = generationOf(id);
+      freeListStale = true;
+
+      return true;
+   }
+
+   /// \brief Повертає ідентифікатори, які видадуть вільні слоти.
+   /// \details Разом з ідентифікаторами живих елементів описує стан усіх
+   /// слотів, тож після reserveAt() жоден ідентифікатор не повториться.
+   std::vector<SlotId> vacantIds() const
+   {
+      std::vector<SlotId> ids;
+
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+         if (slots[i].dense == vacant)
+         {
+            ids.push_back(makeId(static_cast<std::uint32_t>(i),
+               slots[i].generation));
+         }
+      }
+
+      return ids;
+   }
+
+   /// \brief Видаляє елемент за ідентифікатором за O(1).
+   /// \details У копії зі спільними блоками додатково копіює не більше
+   /// кількох блоків.
+   /// \param id Ідентифікатор елемента.
+   /// \return true, якщо елемент існував і був видалений.
+   bool erase(SlotId id)
+   {
+      if (!contains(id))
+      {
+         return false;
+      }
+
+      const std::uint32_t index = indexOf(id);
+      const std::uint32_t hole = slots[index].dense;
+      const std::uint32_t last = static_cast<std::uint32_t>(dense.size() - 1);
+
+      if (hole != last)
+      {
+         T& target = dense.mutableAt(hole);
+         target = std::move(dense.mutableAt(last));
+
+         const std::uint32_t moved = denseToSlot[last];
+         denseToSlot.mutableAt(hole) = moved;
+         slots.mutableAt(moved).dense = hole;
+      }
+
+      dense.pop_back();
+      denseToSlot.pop_back();
+
+      Slot& slot = slots.mutableAt(index);
+      slot.dense = vacant;
+      ++slot.generation;
+
+      if (!freeListStale)
+      {
+         freeSlots.push_back(index);
+      }
+
+      return true;
+   }
+
+   /// \brief Перевіряє, чи відповідає ідентифікатор живому елементу.
+   bool contains(SlotId id) const
+   {
+      if (id == invalidId)
+      {
+         return false;
+      }
+
+      const std::uint32_t index = indexOf(id);
+      return index < slots.size()
+          && slots[index].dense != vacant
+          && slots[index].generation == generationOf(id);
+   }
+
+   /// \brief Шукає елемент за ідентифікатором для зміни.
+   /// \return Вказівник на значення або nullptr для застарілого ідентифікатора.
+   T* find(SlotId id)
+   {
+      return contains(id) ? &dense.mutableAt(slots[indexOf(id)].dense) : nullptr;
+   }
+
+   /// \brief Шукає елемент за ідентифікатором (константна версія).
+   const T* find(SlotId id) const
+   {
+      return contains(id) ? &dense[slots[indexOf(id)].dense] : nullptr;
+   }
+
+   /// \brief Повертає ідентифікатор елемента за позицією у щільному масиві.
+   SlotId idAt(std::size_t position) const
+   {
+      const std::uint32_t index = denseToSlot[position];
+      return makeId(index, slots[index].generation);
+   }
+
+   /// \brief Повертає щільний масив значень для послідовного перебору.
+   const ChunkedVector<T>& values() const
+   {
+      return dense;
+   }
+
+   /// \brief Повертає кількість живих елементів.
+   std::size_t size() const
+   {
+      return dense.size();
+   }
+
+   /// \brief Перевіряє, чи порожній контейнер.
+   bool empty() const
+   {
+      return dense.empty();
+   }
+
+   /// \brief Повертає байти, зайняті власними масивами контейнера.
+   /// \details Враховується місткість блоків, а не лише заповнена частина,
+   /// зокрема блоків, спільних з копіями контейнера; пам'ять, якою володіють
+   /// самі елементи, не враховується.
+   std::size_t memoryBytes() const
+   {
+      return slots.memoryBytes() + dense.memoryBytes()
+         + denseToSlot.memoryBytes() + freeSlots.memoryBytes();
+   }
+
+   /// \brief Повертає кількість окремих виділень пам'яті під масиви.
+   std::size_t allocations() const
+   {
+      return slots.allocations() + dense.allocations()
+         + denseToSlot.allocations() + freeSlots.allocations();
+   }
+
+   /// \brief Резервує місце під вказану кількість елементів.
+   void reserve(std::size_t count)
+   {
+      dense.reserve(count);
+      denseToSlot.reserve(count);
+      slots.reserve(count);
+   }
+
+   /// \brief Видаляє всі елементи та скидає ідентифікатори.
+   void clear()
+   {
+      dense.clear();
+      denseToSlot.clear();
+      slots.clear();
+      freeSlots.clear();
+      freeListStale = false;
+   }
+
+   /// \brief Впорядковує щільний масив; ідентифікатори при цьому не змінюються.
+   /// \param comp Компаратор значень у стилі std::sort.
+   template <typename Compare>
+   void sort(Compare comp)
+   {
+      std::vector<std::uint32_t> order(dense.size());
+      std::iota(order.begin(), order.end(), 0u);
+
+      std::sort(
+         order.begin(),
+         order.end(),
+         [this, &comp](std::uint32_t a, std::uint32_t b)
+         {
+            return comp(dense[a], dense[b]);
+         });
+
+      ChunkedVector<T> sorted;
+      ChunkedVector<std::uint32_t> sortedSlots;
+      sorted.reserve(dense.size());
+      sortedSlots.reserve(dense.size());
+
+      for (std::uint32_t from : order)
+      {
+         slots.mutableAt(denseToSlot[from]).dense =
+            static_cast<std::uint32_t>(sorted.size());
+         sorted.push_back(dense[from]);
+         sortedSlots.push_back(denseToSlot[from]);
+      }
+
+      dense.swap(sorted);
+      denseToSlot.swap(sortedSlots);
+   }
+
+private:
+   static constexpr std::uint32_t vacant = 0xFFFFFFFFu;
+
+   struct Slot
+   {
+      std::uint32_t dense = vacant;
+      std::uint32_t generation = 0;
+   };
+
+   ChunkedVector<Slot>          slots;
+   ChunkedVector<T>             dense;
+   ChunkedVector<std::uint32_t> denseToSlot;
+   ChunkedVector<std::uint32_t> freeSlots;
+   bool                         freeListStale = false;
+
+   void rebuildFreeList()
+   {
+      freeSlots.clear();
+
+      for (std::size_t i = slots.size(); i-- > 0;)
+      {
+         if (slots[i].dense == vacant)
+         {
+            freeSlots.push_back(static_cast<std::uint32_t>(i));
+         }
+      }
+
+      freeListStale = false;
+   }
+};
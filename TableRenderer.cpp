@@ -0,0 +1,256 @@
+// TableRenderer.cpp
+
+#include "TableRenderer.h"
+
+#include <algorithm>
+#include <ostream>
+#include <utility>
+
+namespace
+{
+bool isWide(std::uint32_t cp)
+{
+   return (cp >= 0x1100 && cp <= 0x115F)
+       || (cp >= 0x2E80 && cp <= 0xA4CF)
+       || (cp >= 0xAC00 && cp <= 0xD7A3)
+       || (cp >= 0xF900 && cp <= 0xFAFF)
+       || (cp >= 0xFE30 && cp <= 0xFE4F)
+       || (cp >= 0xFF00 && cp <= 0xFF60)
+       || (cp >= 0xFFE0 && cp <= 0xFFE6)
+       || (cp >= 0x1F300 && cp <= 0x1F64F)
+       || (cp >= 0x1F900 && cp <= 0x1F9FF)
+       || (cp >= 0x20000 && cp <= 0x3FFFD);
+}
+
+bool isCombining(std::uint32_t cp)
+{
+   return (cp >= 0x0300 && cp <= 0x036F)
+       || (cp >= 0x0483 && cp <= 0x0489)
+       || (cp >= 0x200B && cp <= 0x200F)
+       || (cp >= 0xFE00 && cp <= 0xFE0F);
+}
+
+void appendSpaces(std::string& buffer, std::size_t count)
+{
+   buffer.append(count, ' ');
+}
+}
+
+TableRenderer::TableRenderer(std::vector<Column> columns)
+   : columns(std::move(columns))
+{
+}
+
+void TableRenderer::reserve(std::size_t rows)
+{
+   cellEnds.reserve(rows * columns.size());
+   cellWidths.reserve(rows * columns.size());
+   cells.reserve(rows * columns.size() * 12);
+}
+
+void TableRenderer::beginRow()
+{
+   // Неповний попередній рядок доповнюється порожніми клітинками.
+   while (cellEnds.size() % columns.size() != 0)
+   {
+      addCell(std::string());
+   }
+}
+
+void TableRenderer::addCell(const std::string& text)
+{
+   cells += text;
+   cellEnds.push_back(static_cast<std::uint32_t>(cells.size()));
+   cellWidths.push_back(
+      static_cast<std::uint32_t>(displayWidth(text.data(), text.size())));
+}
+
+std::size_t TableRenderer::rowCount() const
+{
+   return (cellEnds.size() + columns.size() - 1) / columns.size();
+}
+
+const char* TableRenderer::cellData(std::size_t index, std::size_t& size) const
+{
+   if (index >= cellEnds.size())
+   {
+      size = 0;
+      return cells.data();
+   }
+
+   const std::size_t begin = index == 0 ? 0 : cellEnds[index - 1];
+   size = cellEnds[index] - begin;
+   return cells.data() + begin;
+}
+
+void TableRenderer::render(std::string& buffer,
+   std::size_t first,
+   std::size_t count) const
+{
+   const std::size_t total = rowCount();
+   first = std::min(first, total);
+   const std::size_t last = count > total - first ? total : first + count;
+   const std::size_t columnCount = columns.size();
+
+   std::vector<std::size_t> widths(columnCount);
+   for (std::size_t c = 0; c < columnCount; ++c)
+   {
+      widths[c] = displayWidth(columns[c].title.data(), columns[c].title.size());
+   }
+
+   for (std::size_t r = first; r < last; ++r)
+   {
+      for (std::size_t c = 0; c < columnCount; ++c)
+      {
+         const std::size_t index = r * columnCount + c;
+         if (index < cellWidths.size())
+         {
+            widths[c] = std::max<std::size_t>(widths[c], cellWidths[index]);
+         }
+      }
+   }
+
+   std::size_t lineWidth = 0;
+   for (std::size_t width : widths)
+   {
+      lineWidth += width + 3;
+   }
+   buffer.reserve(buffer.size() + (last - first + 2) * (lineWidth + 16));
+
+   auto appendCell = [&](const char* data, std::size_t size,
+                         std::size_t width, std::size_t c)
+   {
+      const std::size_t pad = widths[c] - width;
+
+      if (c != 0)
+      {
+         buffer += " | ";
+      }
+
+      if (columns[c].align == Align::Right)
+      {
+         appendSpaces(buffer, pad);
+         buffer.append(data, size);
+      }
+      else
+      {
+         buffer.append(data, size);
+         if (c + 1 != columnCount)
+         {
+            appendSpaces(buffer, pad);
+         }
+      }
+   };
+
+   for (std::size_t c = 0; c < columnCount; ++c)
+   {
+      const std::string& title = columns[c].title;
+      appendCell(title.data(), title.size(),
+         displayWidth(title.data(), title.size()), c);
+   }
+   buffer += '\n';
+
+   for (std::size_t c = 0; c < columnCount; ++c)
+   {
+      if (c != 0)
+      {
+         buffer += "-+-";
+      }
+      buffer.append(widths[c], '-');
+   }
+   buffer += '\n';
+
+   for (std::size_t r = first; r < last; ++r)
+   {
+      for (std::size_t c = 0; c < columnCount; ++c)
+      {
+         const std::size_t index = r * columnCount + c;
+         std::size_t size = 0;
+         const char* data = cellData(index, size);
+         const std::size_t width = index < cellWidths.size() ? cellWidths[index] : 0;
+
+         appendCell(data, size, width, c);
+      }
+      buffer += '\n';
+   }
+}
+
+void TableRenderer::print(std::ostream& out,
+   std::size_t first,
+   std::size_t count) const
+{
+   std::string buffer;
+   render(buffer, first, count);
+
+   out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+   out.flush();
+}
+
+std::size_t TableRenderer::displayWidth(const char* text, std::size_t size)
+{
+   std::size_t width = 0;
+   std::size_t i = 0;
+
+   while (i < size)
+   {
+      const unsigned char lead = static_cast<unsigned char>(text[i]);
+
+      // Швидкий шлях для ASCII.
+      if (lead < 0x80)
+      {
+         ++width;
+         ++i;
+         continue;
+      }
+
+      std::uint32_t cp = 0;
+      std::size_t length = 1;
+
+      if ((lead & 0xE0) == 0xC0)
+      {
+         cp = lead & 0x1F;
+         length = 2;
+      }
+      else if ((lead & 0xF0) == 0xE0)
+      {
+         cp = lead & 0x0F;
+         length = 3;
+      }
+      else if ((lead & 0xF8) == 0xF0)
+      {
+         cp = lead & 0x07;
+         length = 4;
+      }
+      else
+      {
+         // Некоректний байт займає одну позицію.
+         ++width;
+         ++i;
+         continue;
+      }
+
+      if (i + length > size)
+      {
+         width += 1;
+         break;
+      }
+
+      for (std::size_t k = 1; k < length; ++k)
+      {
+         cp = (cp << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+      }
+
+      if (isWide(cp))
+      {
+         width += 2;
+      }
+      else if (!isCombining(cp))
+      {
+         width += 1;
+      }
+
+      i += length;
+   }
+
+   return width;
+}
@@ -0,0 +1,84 @@
+// TableRenderer.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// \file TableRenderer.h
+/// \brief Буферизований рендерер таблиць для консольного виводу.
+
+/// \class TableRenderer
+/// \brief Форматує рядки таблиці в один буфер і виводить його одним записом.
+/// \details Клітинки зберігаються в одному суцільному рядку без окремих
+/// виділень пам'яті на кожну клітинку. Ширина стовпців обчислюється лише
+/// за рядками, що реально виводяться, з урахуванням ширини символів UTF-8
+/// (кирилиця займає одну позицію, а не два байти).
+class TableRenderer
+{
+public:
+   /// \brief Вирівнювання вмісту стовпця.
+   enum class Align
+   {
+      Left,
+      Right
+   };
+
+   /// \brief Опис стовпця таблиці.
+   struct Column
+   {
+      std::string title;
+      Align       align = Align::Left;
+   };
+
+   /// \brief Створює таблицю з указаними стовпцями.
+   /// \param columns Заголовки та вирівнювання стовпців.
+   explicit TableRenderer(std::vector<Column> columns);
+
+   /// \brief Резервує місце під вказану кількість рядків.
+   void reserve(std::size_t rows);
+
+   /// \brief Починає новий рядок таблиці.
+   void beginRow();
+
+   /// \brief Додає клітинку до поточного рядка.
+   /// \param text Вміст клітинки у UTF-8.
+   void addCell(const std::string& text);
+
+   /// \brief Повертає кількість доданих рядків.
+   std::size_t rowCount() const;
+
+   /// \brief Форматує рядки [first, first + count) у буфер.
+   /// \details Ширина стовпців рахується лише за цими рядками, тому
+   /// посторінковий вивід не торкається невидимих рядків.
+   /// \param buffer Буфер, до якого дописується таблиця.
+   /// \param first Перший рядок сторінки.
+   /// \param count Кількість рядків сторінки.
+   void render(std::string& buffer,
+      std::size_t first = 0,
+      std::size_t count = static_cast<std::size_t>(-1)) const;
+
+   /// \brief Форматує рядки та виводить їх у потік одним записом.
+   /// \param out Потік виводу.
+   /// \param first Перший рядок сторінки.
+   /// \param count Кількість рядків сторінки.
+   void print(std::ostream& out,
+      std::size_t first = 0,
+      std::size_t count = static_cast<std::size_t>(-1)) const;
+
+   /// \brief Обчислює ширину тексту UTF-8 у позиціях термінала.
+   /// \param text Текст у кодуванні UTF-8.
+   /// \param size Довжина тексту в байтах.
+   /// \return Кількість позицій, яку займе текст.
+   static std::size_t displayWidth(const char* text, std::size_t size);
+
+private:
+   std::vector<Column>        columns;
+   std::string                cells;
+   std::vector<std::uint32_t> cellEnds;
+   std::vector<std::uint32_t> cellWidths;
+
+   const char* cellData(std::size_t index, std::size_t& size) const;
+};
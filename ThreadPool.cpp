@@ -0,0 +1,65 @@
+// ThreadPool.cpp
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+   threads = std::max<std::size_t>(threads, 1);
+   workers.reserve(threads);
+
+   for (std::size_t i = 0; i < threads; ++i)
+   {
+      workers.emplace_back(&ThreadPool::workerLoop, this);
+   }
+}
+
+ThreadPool::~ThreadPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+
+   wakeUp.notify_all();
+
+   for (auto& worker : workers)
+   {
+      worker.join();
+   }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.push_back(std::move(task));
+   }
+
+   wakeUp.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+   while (true)
+   {
+      std::function<void()> task;
+
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         wakeUp.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+         if (tasks.empty())
+         {
+            return;
+         }
+
+         task = std::move(tasks.front());
+         tasks.pop_front();
+      }
+
+      task();
+   }
+}
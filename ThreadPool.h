@@ -0,0 +1,49 @@
+// ThreadPool.h
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \file ThreadPool.h
+/// \brief Простий пул робочих потоків із загальною чергою завдань.
+
+/// \class ThreadPool
+/// \brief Виконує завдання у фіксованій кількості робочих потоків.
+/// \details Деструктор дочікується виконання всіх уже поставлених завдань.
+class ThreadPool
+{
+public:
+   /// \brief Запускає пул.
+   /// \param threads Кількість робочих потоків (щонайменше 1).
+   explicit ThreadPool(std::size_t threads);
+
+   /// \brief Дочікується завершення завдань і зупиняє потоки.
+   ~ThreadPool();
+
+   ThreadPool(const ThreadPool&) = delete;
+   ThreadPool& operator=(const ThreadPool&) = delete;
+
+   /// \brief Ставить завдання в чергу.
+   /// \param task Завдання для виконання в одному з потоків пулу.
+   void submit(std::function<void()> task);
+
+   /// \brief Повертає кількість робочих потоків.
+   std::size_t size() const
+   {
+      return workers.size();
+   }
+
+private:
+   std::vector<std::thread>          workers;
+   std::deque<std::function<void()>> tasks;
+   std::mutex                        mutex;
+   std::condition_variable           wakeUp;
+   bool                              stopping = false;
+
+   void workerLoop();
+};
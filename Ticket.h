@@ -0,0 +1,33 @@
+// Ticket.h
+#pragma once
+
+#include "SlotMap.h"
+
+#include <cstdint>
+#include <string>
+
+/// \file Ticket.h
+/// \brief Підтвердження бронювання туру.
+
+/// \struct Ticket
+/// \brief Дані оформленого квитка.
+struct Ticket
+{
+   std::string username;
+   SlotId      tourId = 0;
+   std::string country;
+   std::string city;
+   std::string departureDate;
+   std::string returnDate;
+   double      price = 0.0;   ///< Сплачена сума за всі місця квитка.
+   std::int64_t bookedAt = 0; ///< Час бронювання, секунди Unix.
+   std::uint32_t seats = 1;   ///< Кількість місць у квитку.
+};
+
+/// \struct BookingItem
+/// \brief Один тур у груповому бронюванні.
+struct BookingItem
+{
+   SlotId        tourId = 0;
+   std::uint32_t seats = 1;
+};
@@ -0,0 +1,47 @@
+// TicketRecord.h
+#pragma once
+
+#include "SlotMap.h"
+
+#include <cstdint>
+
+/// \file TicketRecord.h
+/// \brief Двійковий формат файлу квитків.
+/// \details Файл складається з заголовка TicketFileHeader і послідовності
+/// записів TicketRecord однакового розміру. Числа зберігаються в порядку
+/// байтів платформи.
+
+/// \brief Заголовок двійкового файлу квитків.
+struct TicketFileHeader
+{
+   char          magic[8];   ///< Завжди "TOURTKT1".
+   std::uint32_t recordSize; ///< sizeof(TicketRecord) на момент запису.
+   std::uint32_t reserved;
+};
+
+/// \brief Прапорці запису квитка.
+enum TicketFlags : std::uint32_t
+{
+   ticketCancellation = 1u, ///< Запис скасовує останній активний квиток користувача на тур.
+   ticketCancelled = 2u     ///< Лише в пам'яті: квиток скасовано пізнішим записом.
+};
+
+/// \brief Один оформлений квиток у файлі квитків.
+/// \details Замість копії даних туру зберігається його ідентифікатор.
+/// Файл лише дописується, тому скасування — це окремий запис з прапорцем
+/// ticketCancellation.
+struct TicketRecord
+{
+   SlotId        tourId;        ///< Ідентифікатор туру в каталозі.
+   std::int64_t  bookedAt;      ///< Час бронювання, секунди Unix; 0 — невідомо.
+   double        price;         ///< Ціна на момент бронювання.
+   std::uint32_t seats;         ///< Кількість місць у квитку.
+   std::uint32_t flags;         ///< Комбінація TicketFlags.
+   char          username[32];  ///< Ім'я користувача, доповнене нулями.
+};
+
+static_assert(sizeof(TicketFileHeader) == 16, "Несподіваний розмір заголовка");
+static_assert(sizeof(TicketRecord) == 64, "Несподіваний розмір запису квитка");
+
+/// \brief Сигнатура двійкового файлу квитків.
+inline constexpr char ticketFileMagic[8] = {'T', 'O', 'U', 'R', 'T', 'K', 'T', '1'};
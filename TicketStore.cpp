@@ -0,0 +1,397 @@
+// TicketStore.cpp
+
+#include "TicketStore.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+constexpr SlotId unknownTour = SlotMap<TicketRecord>::invalidId;
+
+std::vector<std::string> splitFields(const std::string& line)
+{
+   std::vector<std::string> fields;
+   std::istringstream iss(line);
+   std::string field;
+
+   while (std::getline(iss, field, ','))
+   {
+      fields.push_back(field);
+   }
+
+   return fields;
+}
+
+bool parseNumber(const std::string& text, double& value)
+{
+   try
+   {
+      std::size_t pos = 0;
+      value = std::stod(text, &pos);
+      return pos == text.size();
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+}
+
+TicketRecord TicketStore::makeRecord(const Ticket& ticket)
+{
+   TicketRecord record{};
+   record.tourId = ticket.tourId;
+   record.bookedAt = ticket.bookedAt;
+   record.price = ticket.price;
+   record.seats = ticket.seats;
+   std::memcpy(record.username, ticket.username.data(),
+      std::min(ticket.username.size(), maxUsernameLength));
+   return record;
+}
+
+std::string TicketStore::usernameOf(const TicketRecord& record)
+{
+   const char* end = static_cast<const char*>(
+      std::memchr(record.username, '\0', maxUsernameLength));
+   return std::string(record.username,
+      end == nullptr ? record.username + maxUsernameLength : end);
+}
+
+Result<std::size_t> TicketStore::load(const std::string& path)
+{
+   std::vector<TicketRecord> loaded;
+
+   std::FILE* file = std::fopen(path.c_str(), "rb");
+   if (file != nullptr)
+   {
+      TicketFileHeader header{};
+      const bool hasHeader = std::fread(&header, sizeof(header), 1, file) == 1;
+
+      if (hasHeader
+          && (std::memcmp(header.magic, ticketFileMagic, sizeof(header.magic)) != 0
+              || header.recordSize != sizeof(TicketRecord)))
+      {
+         std::fclose(file);
+         return Error{ErrorCode::IoError,
+            "Невідомий формат файлу квитків: " + path};
+      }
+
+      if (hasHeader)
+      {
+         std::fseek(file, 0, SEEK_END);
+         const long end = std::ftell(file);
+         std::fseek(file, static_cast<long>(sizeof(header)), SEEK_SET);
+
+         // Неповний останній запис (обірваний запис під час збою) ігнорується.
+         const std::size_t count =
+            (static_cast<std::size_t>(end) - sizeof(header)) / sizeof(TicketRecord);
+         loaded.resize(count);
+
+         if (std::fread(loaded.data(), sizeof(TicketRecord), count, file) != count)
+         {
+            std::fclose(file);
+            return Error{ErrorCode::IoError,
+               "Помилка читання файлу квитків: " + path};
+         }
+
+         Metrics::bytesRead(sizeof(header) + count * sizeof(TicketRecord));
+      }
+
+      std::fclose(file);
+   }
+
+   std::unique_lock<std::shared_mutex> lock(mutex);
+   records = std::move(loaded);
+   byUser.clear();
+   byTour.clear();
+   indexLocked(0);
+
+   return records.size();
+}
+
+void TicketStore::add(const TicketRecord* added, std::size_t count)
+{
+   const auto lock = Metrics::acquire(mutex, Contention::TicketIndex);
+
+   const std::size_t first = records.size();
+   records.insert(records.end(), added, added + count);
+   indexLocked(first);
+}
+
+void TicketStore::indexLocked(std::size_t first)
+{
+   for (std::size_t i = first; i < records.size(); ++i)
+   {
+      TicketRecord& record = records[i];
+      const auto position = static_cast<std::uint32_t>(i);
+
+      if ((record.flags & ticketCancellation) != 0)
+      {
+         // Скасування знімає останній активний квиток користувача на тур;
+         // сам запис скасування в індекси не потрапляє.
+         auto user = byUser.find(usernameOf(record));
+         if (user == byUser.end())
+         {
+            continue;
+         }
+
+         for (auto it = user->second.rbegin(); it != user->second.rend(); ++it)
+         {
+            TicketRecord& original = records[*it];
+            if (original.tourId == record.tourId
+                && (original.flags & ticketCancelled) == 0)
+            {
+               original.flags |= ticketCancelled;
+               byTour[original.tourId].seats -= original.seats;
+               break;
+            }
+         }
+         continue;
+      }
+
+      record.flags &= ~static_cast<std::uint32_t>(ticketCancelled);
+      byUser[usernameOf(record)].push_back(position);
+
+      TourTickets& tour = byTour[record.tourId];
+      tour.records.push_back(position);
+      tour.seats += record.seats;
+   }
+}
+
+std::vector<TicketRecord> TicketStore::collectLocked(
+   const std::vector<std::uint32_t>& positions) const
+{
+   std::vector<TicketRecord> result;
+   result.reserve(positions.size());
+
+   for (std::uint32_t position : positions)
+   {
+      if ((records[position].flags & ticketCancelled) == 0)
+      {
+         result.push_back(records[position]);
+      }
+   }
+
+   return result;
+}
+
+std::vector<TicketRecord> TicketStore::forUser(const std::string& username) const
+{
+   std::shared_lock<std::shared_mutex> lock(mutex);
+
+   auto found = byUser.find(username);
+   if (found == byUser.end())
+   {
+      return {};
+   }
+
+   return collectLocked(found->second);
+}
+
+std::vector<TicketRecord> TicketStore::forTour(SlotId tourId) const
+{
+   std::shared_lock<std::shared_mutex> lock(mutex);
+
+   auto found = byTour.find(tourId);
+   if (found == byTour.end())
+   {
+      return {};
+   }
+
+   return collectLocked(found->second.records);
+}
+
+std::optional<TicketRecord> TicketStore::findActive(const std::string& username,
+   SlotId tourId) const
+{
+   std::shared_lock<std::shared_mutex> lock(mutex);
+
+   auto found = byUser.find(username);
+   if (found == byUser.end())
+   {
+      return std::nullopt;
+   }
+
+   for (auto it = found->second.rbegin(); it != found->second.rend(); ++it)
+   {
+      const TicketRecord& record = records[*it];
+      if (record.tourId == tourId && (record.flags & ticketCancelled) == 0)
+      {
+         return record;
+      }
+   }
+
+   return std::nullopt;
+}
+
+std::uint64_t TicketStore::seatsSold(SlotId tourId) const
+{
+   std::shared_lock<std::shared_mutex> lock(mutex);
+
+   auto found = byTour.find(tourId);
+   return found == byTour.end() ? 0 : found->second.seats;
+}
+
+std::size_t TicketStore::size() const
+{
+   std::shared_lock<std::shared_mutex> lock(mutex);
+   return records.size();
+}
+
+std::size_t TicketStore::dropKnown(std::vector<TicketRecord>& imported) const
+{
+   const auto sameTicket = [](const TicketRecord& a, const TicketRecord& b)
+   {
+      return a.tourId == b.tourId && a.bookedAt == b.bookedAt
+         && a.price == b.price && a.seats == b.seats
+         && std::memcmp(a.username, b.username, maxUsernameLength) == 0;
+   };
+
+   std::shared_lock<std::shared_mutex> lock(mutex);
+
+   // Наявні квитки, що вже поглинули запис імпорту.
+   std::vector<bool> matched(records.size(), false);
+   std::size_t dropped = 0;
+
+   auto kept = imported.begin();
+   for (const TicketRecord& record : imported)
+   {
+      bool known = false;
+
+      auto user = byUser.find(usernameOf(record));
+      if (user != byUser.end())
+      {
+         for (std::uint32_t position : user->second)
+         {
+            if (!matched[position] && sameTicket(records[position], record))
+            {
+               matched[position] = true;
+               known = true;
+               break;
+            }
+         }
+      }
+
+      if (known)
+      {
+         ++dropped;
+      }
+      else
+      {
+         *kept++ = record;
+      }
+   }
+
+   imported.erase(kept, imported.end());
+   return dropped;
+}
+
+void TicketStore::accountMemory(MemoryReport& report) const
+{
+   std::shared_lock<std::shared_mutex> lock(mutex);
+
+   report.add("tickets.records", records.size(),
+      records.capacity() * sizeof(TicketRecord)
+         + MemoryReport::allocatorOverhead);
+
+   std::uint64_t userBytes = MemoryReport::hashTableBytes(
+      byUser.bucket_count(), byUser.size(),
+      sizeof(decltype(byUser)::value_type));
+   for (const auto& entry : byUser)
+   {
+      const std::uint64_t name = MemoryReport::stringHeapBytes(entry.first);
+      userBytes += name + (name != 0 ? MemoryReport::allocatorOverhead : 0)
+         + entry.second.capacity() * sizeof(std::uint32_t)
+         + MemoryReport::allocatorOverhead;
+   }
+   report.add("tickets.byUser", byUser.size(), userBytes);
+
+   std::uint64_t tourBytes = MemoryReport::hashTableBytes(
+      byTour.bucket_count(), byTour.size(),
+      sizeof(decltype(byTour)::value_type));
+   for (const auto& entry : byTour)
+   {
+      tourBytes += entry.second.records.capacity() * sizeof(std::uint32_t)
+         + MemoryReport::allocatorOverhead;
+   }
+   report.add("tickets.byTour", byTour.size(), tourBytes);
+}
+
+Result<std::vector<TicketRecord>> TicketStore::importText(
+   const std::string& path,
+   const TourResolver& resolver)
+{
+   std::ifstream file(path);
+   if (!file)
+   {
+      return Error{ErrorCode::IoError,
+         "Не вдалося відкрити файл квитків: " + path};
+   }
+
+   std::vector<TicketRecord> imported;
+   std::string line;
+
+   while (std::getline(file, line))
+   {
+      Metrics::bytesRead(line.size() + 1);
+
+      if (!line.empty() && line.back() == '\r')
+      {
+         line.pop_back();
+      }
+
+      if (line.empty() || line.rfind("username,", 0) == 0)
+      {
+         continue;
+      }
+
+      const std::vector<std::string> fields = splitFields(line);
+
+      Ticket ticket;
+      double price = 0.0;
+
+      if (fields.size() == 7 && parseNumber(fields[6], price))
+      {
+         // username,tourId,country,city,departureDate,returnDate,price
+         ticket.username = fields[0];
+         try
+         {
+            ticket.tourId = static_cast<SlotId>(std::stoull(fields[1]));
+         }
+         catch (...)
+         {
+            ticket.tourId = unknownTour;
+         }
+      }
+      else if (fields.size() == 6 && parseNumber(fields[5], price))
+      {
+         // username,country,city,departureDate,returnDate,price
+         ticket.username = fields[0];
+         ticket.tourId = resolver
+            ? resolver(fields[1], fields[2], fields[3], fields[4])
+            : unknownTour;
+      }
+      else
+      {
+         return Error{ErrorCode::InvalidArgument,
+            "Некоректний рядок у файлі квитків: " + line};
+      }
+
+      if (ticket.username.size() > maxUsernameLength)
+      {
+         return Error{ErrorCode::InvalidArgument,
+            "Задовге ім'я користувача у файлі квитків: " + line};
+      }
+
+      ticket.price = price;
+      imported.push_back(makeRecord(ticket));
+   }
+
+   return imported;
+}
@@ -0,0 +1,122 @@
+// TicketStore.h
+#pragma once
+
+#include "MemoryReport.h"
+#include "Result.h"
+#include "Ticket.h"
+#include "TicketRecord.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// \file TicketStore.h
+/// \brief Індексоване сховище оформлених квитків.
+
+/// \class TicketStore
+/// \brief Тримає всі записи квитків у пам'яті з індексами за
+/// користувачем і за туром.
+/// \details Записи зберігаються у файлі фіксованого розміру (TicketRecord),
+/// тому завантаження — це одне послідовне читання без розбору тексту.
+/// Індекси зберігають номери записів, тож пошук квитків користувача чи
+/// туру та кількість проданих місць не потребують перегляду всього файлу.
+/// Записи скасування (ticketCancellation) позначають скасований квиток і
+/// зменшують кількість проданих місць.
+///
+/// Читання безпечне з багатьох потоків; add() виконується під
+/// ексклюзивним блокуванням.
+class TicketStore
+{
+public:
+   /// \brief Пошук туру для квитка старого формату (без ідентифікатора).
+   /// \details Отримує країну, місто, дату відправлення і повернення;
+   /// повертає ідентифікатор туру або SlotMap::invalidId.
+   using TourResolver = std::function<SlotId(const std::string&,
+      const std::string&, const std::string&, const std::string&)>;
+
+   /// \brief Максимальна довжина імені користувача в байтах.
+   static constexpr std::size_t maxUsernameLength =
+      sizeof(TicketRecord::username);
+
+   /// \brief Перетворює квиток у двійковий запис.
+   /// \param ticket Квиток; ім'я користувача довше за maxUsernameLength
+   /// обрізається, тому його слід відхиляти раніше.
+   static TicketRecord makeRecord(const Ticket& ticket);
+
+   /// \brief Повертає ім'я користувача з запису.
+   static std::string usernameOf(const TicketRecord& record);
+
+   /// \brief Замінює вміст сховища записами з двійкового файлу.
+   /// \details Відсутній файл означає порожнє сховище.
+   /// \param path Шлях до файлу квитків.
+   /// \return Кількість завантажених записів або IoError.
+   Result<std::size_t> load(const std::string& path);
+
+   /// \brief Додає вже записані у файл квитки до індексів.
+   /// \param records Записи квитків.
+   /// \param count Кількість записів.
+   void add(const TicketRecord* records, std::size_t count);
+
+   /// \brief Повертає активні квитки користувача в порядку бронювання.
+   std::vector<TicketRecord> forUser(const std::string& username) const;
+
+   /// \brief Повертає активні квитки туру в порядку бронювання.
+   std::vector<TicketRecord> forTour(SlotId tourId) const;
+
+   /// \brief Шукає останній активний квиток користувача на тур.
+   std::optional<TicketRecord> findActive(const std::string& username,
+      SlotId tourId) const;
+
+   /// \brief Повертає кількість проданих і не скасованих місць туру.
+   std::uint64_t seatsSold(SlotId tourId) const;
+
+   /// \brief Повертає загальну кількість квитків.
+   std::size_t size() const;
+
+   /// \brief Вилучає записи, які вже є у сховищі.
+   /// \details Записи порівнюються за всіма полями, крім прапорців, і
+   /// кожен наявний квиток (зокрема скасований) поглинає лише один
+   /// однаковий запис, тож повторний імпорт того самого файлу нічого не
+   /// додає, а два однакові квитки в одному файлі зберігаються.
+   /// \param imported Записи для перевірки; лишаються лише нові.
+   /// \return Кількість вилучених записів.
+   std::size_t dropKnown(std::vector<TicketRecord>& imported) const;
+
+   /// \brief Додає до звіту пам'ять записів і обох індексів.
+   /// \param report Звіт, у якому накопичується облік.
+   void accountMemory(MemoryReport& report) const;
+
+   /// \brief Читає текстовий файл квитків tickets.txt.
+   /// \details Підтримує обидва формати: з колонкою tourId і старий
+   /// `username,country,city,departureDate,returnDate,price`, для якого тур
+   /// шукається через resolver. Квитки, тур яких не знайдено, отримують
+   /// SlotMap::invalidId. Ім'я довше за maxUsernameLength не обрізається,
+   /// а робить файл некоректним.
+   /// \param path Шлях до текстового файлу.
+   /// \param resolver Пошук туру для рядків без ідентифікатора.
+   /// \return Записи квитків або IoError/InvalidArgument.
+   static Result<std::vector<TicketRecord>> importText(const std::string& path,
+      const TourResolver& resolver);
+
+private:
+   struct TourTickets
+   {
+      std::vector<std::uint32_t> records;
+      std::uint64_t              seats = 0;
+   };
+
+   mutable std::shared_mutex mutex;
+   std::vector<TicketRecord> records;
+
+   std::unordered_map<std::string, std::vector<std::uint32_t>> byUser;
+   std::unordered_map<SlotId, TourTickets>                     byTour;
+
+   void indexLocked(std::size_t first);
+   std::vector<TicketRecord> collectLocked(
+      const std::vector<std::uint32_t>& positions) const;
+};
@@ -1,8 +1,14 @@
 // Tour.h
 #pragma once
 
+#include "Result.h"
+#include "TourPatch.h"
+
+#include <memory>
 #include <string>
 
+struct MemoryReport;
+
 /// \file Tour.h
 /// \brief Абстрактний базовий клас для всіх видів турів.
 
@@ -59,4 +65,21 @@ public:
 
    /// \brief Інтерактивне редагування параметрів туру.
    virtual void editInteractive() = 0;
+
+   /// \brief Створює незалежну копію туру.
+   /// \return Новий об'єкт того ж типу з тими самими даними.
+   virtual std::shared_ptr<Tour> clone() const = 0;
+
+   /// \brief Застосовує набір змін без консольного введення.
+   /// \details Спочатку перевіряються всі поля, тому при помилці
+   /// тур залишається без змін.
+   /// \param patch Поля, які потрібно змінити.
+   /// \return Порожній результат або опис помилки валідації.
+   virtual Result<void> applyPatch(const TourPatch& patch) = 0;
+
+   // --- Облік пам'яті. ---
+
+   /// \brief Додає розмір об'єкта і його рядкових полів до обліку свого типу.
+   /// \param report Звіт, у якому накопичується облік.
+   virtual void accountMemory(MemoryReport& report) const = 0;
 };
@@ -0,0 +1,63 @@
+// TourCursor.cpp
+
+#include "TourCursor.h"
+
+#include <algorithm>
+#include <utility>
+
+TourCursor::TourCursor(std::shared_ptr<const CatalogSnapshot> catalog,
+   TourQuery query,
+   std::size_t pageSize)
+   : catalog(std::move(catalog)),
+     query(std::move(query)),
+     pageSize(std::max<std::size_t>(pageSize, 1)),
+     pageStarts(1, 0)
+{
+}
+
+const std::vector<SlotId>& TourCursor::nextPage()
+{
+   static const std::vector<SlotId> noPage;
+
+   if (!started)
+   {
+      started = true;
+      loadPage(0);
+      return page;
+   }
+
+   if (!more)
+   {
+      return noPage;
+   }
+
+   if (pageIndex + 1 == pageStarts.size())
+   {
+      pageStarts.push_back(scanEnd);
+   }
+
+   loadPage(pageIndex + 1);
+   return page;
+}
+
+const std::vector<SlotId>& TourCursor::previousPage()
+{
+   if (started && pageIndex > 0)
+   {
+      loadPage(pageIndex - 1);
+   }
+
+   return page;
+}
+
+void TourCursor::loadPage(std::size_t index)
+{
+   pageIndex = index;
+   page.clear();
+   scanEnd = catalog->scan(query, pageStarts[index], pageSize, page);
+
+   // Перевірка наявності наступної сторінки шукає лише один збіг.
+   std::vector<SlotId> probe;
+   catalog->scan(query, scanEnd, 1, probe);
+   more = !probe.empty();
+}
@@ -0,0 +1,83 @@
+// TourCursor.h
+#pragma once
+
+#include "CatalogSnapshot.h"
+#include "TourQuery.h"
+#include "SlotMap.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// \file TourCursor.h
+/// \brief Курсор для посторінкового перегляду результатів запиту.
+
+/// \class TourCursor
+/// \brief Лінивий курсор, що видає результати запиту сторінками.
+/// \details Курсор не збирає весь результат наперед: кожна сторінка
+/// отримується скануванням каталогу з позиції, де закінчилася попередня,
+/// і лише до заповнення сторінки. Для повернення назад курсор пам'ятає
+/// позиції початку вже переглянутих сторінок. Курсор тримає незмінний
+/// знімок каталогу, тому паралельні зміни не зсувають його сторінки.
+class TourCursor
+{
+public:
+   /// \brief Створює курсор над знімком каталогу.
+   /// \param catalog Знімок каталогу, який сканується.
+   /// \param query Критерій відбору турів.
+   /// \param pageSize Кількість турів на сторінці (щонайменше 1).
+   TourCursor(std::shared_ptr<const CatalogSnapshot> catalog,
+      TourQuery query,
+      std::size_t pageSize);
+
+   /// \brief Повертає знімок каталогу, за яким ідуть сторінки.
+   const CatalogSnapshot& snapshot() const
+   {
+      return *catalog;
+   }
+
+   /// \brief Переходить до наступної сторінки.
+   /// \return Ідентифікатори турів сторінки; порожньо, якщо сторінок більше немає.
+   const std::vector<SlotId>& nextPage();
+
+   /// \brief Переходить до попередньої сторінки.
+   /// \return Ідентифікатори турів сторінки; поточна сторінка, якщо це перша.
+   const std::vector<SlotId>& previousPage();
+
+   /// \brief Повертає поточну сторінку без сканування.
+   const std::vector<SlotId>& currentPage() const
+   {
+      return page;
+   }
+
+   /// \brief Перевіряє, чи є сторінки після поточної.
+   bool hasNext() const
+   {
+      return !started || more;
+   }
+
+   /// \brief Перевіряє, чи є сторінки перед поточною.
+   bool hasPrevious() const
+   {
+      return pageIndex > 0;
+   }
+
+   /// \brief Повертає номер поточної сторінки, починаючи з 1 (0 до першого nextPage()).
+   std::size_t pageNumber() const
+   {
+      return started ? pageIndex + 1 : 0;
+   }
+
+private:
+   std::shared_ptr<const CatalogSnapshot> catalog;
+   TourQuery                              query;
+   std::size_t                            pageSize;
+   std::vector<std::size_t>               pageStarts;
+   std::size_t                            pageIndex = 0;
+   std::size_t                            scanEnd = 0;
+   std::vector<SlotId>                    page;
+   bool                                   started = false;
+   bool                                   more = false;
+
+   void loadPage(std::size_t index);
+};
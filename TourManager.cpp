@@ -6,8 +6,14 @@
 #include "FileException.h"
 #include "ValidationException.h"
 #include "NotFoundException.h"
+#include "TableRenderer.h"
+#include "Metrics.h"
+#include "CsvScanner.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #include <limits>
@@ -66,103 +72,1401 @@ bool readStrictInt(int& value)
 
    return true;
 }
+
+bool readStrictId(TourId& value)
+{
+   std::string token;
+
+   if (!(std::cin >> token))
+   {
+      return false;
+   }
+
+   if (token.empty())
+   {
+      return false;
+   }
+
+   for (unsigned char ch : token)
+   {
+      if (!std::isdigit(ch))
+      {
+         return false;
+      }
+   }
+
+   try
+   {
+      value = static_cast<TourId>(std::stoull(token));
+   }
+   catch (...)
+   {
+      return false;
+   }
+
+   return true;
+}
+
+[[noreturn]] void throwError(const Error& error)
+{
+   switch (error.code)
+   {
+      case ErrorCode::NotFound:
+         throw NotFoundException(error.message);
+
+      case ErrorCode::IoError:
+         throw FileException(error.message);
+
+      case ErrorCode::SoldOut:
+      case ErrorCode::Conflict:
+      case ErrorCode::InvalidArgument:
+      default:
+         throw ValidationException(error.message);
+   }
+}
+
+template <typename T>
+T unwrap(Result<T> result)
+{
+   if (!result.ok())
+   {
+      throwError(result.error());
+   }
+
+   return std::move(result.value());
+}
+
+void unwrap(const Result<void>& result)
+{
+   if (!result.ok())
+   {
+      throwError(result.error());
+   }
+}
+
+std::atomic<std::uint64_t> nextInstanceId{1};
+
+struct PinnedSnapshot
+{
+   std::uint64_t                          instanceId = 0;
+   std::uint64_t                          version = 0;
+   std::shared_ptr<const CatalogSnapshot> snapshot;
+};
+
+thread_local PinnedSnapshot pinned;
+
+bool parseSeatCount(const std::string& text, int& value)
+{
+   if (text.empty() || text.size() > 9)
+   {
+      return false;
+   }
+
+   for (unsigned char ch : text)
+   {
+      if (!std::isdigit(ch))
+      {
+         return false;
+      }
+   }
+
+   value = std::stoi(text);
+   return true;
+}
+
+std::vector<std::string> splitHeader(std::string header)
+{
+   if (!header.empty() && header.back() == '\r')
+   {
+      header.pop_back();
+   }
+
+   std::vector<std::string> columns;
+   std::istringstream iss(header);
+   std::string column;
+
+   while (std::getline(iss, column, ','))
+   {
+      columns.push_back(column);
+   }
+
+   return columns;
+}
+}
+
+TourManager::TourManager(const std::string& dataFile,
+   const std::string& ticketsFile,
+   const std::string& waitlistFile,
+   LedgerOptions ledgerOptions)
+   : dataFile(dataFile),
+     current(std::make_shared<CatalogSnapshot>()),
+     instanceId(nextInstanceId.fetch_add(1)),
+     ledger(ticketsFile, ledgerOptions),
+     waitlist(waitlistFile)
+{
+}
+
+TourManager::~TourManager()
+{
+   // Інакше закріплений знімок із усіма турами жив би до завершення потоку.
+   if (pinned.instanceId == instanceId)
+   {
+      pinned = PinnedSnapshot{};
+   }
+}
+
+std::shared_ptr<const CatalogSnapshot> TourManager::snapshot() const
+{
+   return std::atomic_load(&current);
+}
+
+const CatalogSnapshot& TourManager::pinSnapshot() const
+{
+   const std::uint64_t version =
+      publishedVersion.load(std::memory_order_acquire);
+
+   if (pinned.instanceId != instanceId
+       || pinned.version != version
+       || !pinned.snapshot)
+   {
+      pinned.snapshot = std::atomic_load(&current);
+      pinned.instanceId = instanceId;
+      pinned.version = pinned.snapshot->version();
+   }
+
+   return *pinned.snapshot;
+}
+
+Result<void> TourManager::commit(
+   const std::function<Result<void>(CatalogSnapshot::Tours&)>& change)
+{
+   const auto lock = Metrics::acquire(writeMutex, Contention::CatalogWrite);
+
+   CatalogSnapshot::Tours next = std::atomic_load(&current)->tours();
+
+   Result<void> result = change(next);
+   if (result.ok())
+   {
+      publish(std::move(next));
+   }
+
+   return result;
+}
+
+void TourManager::publish(CatalogSnapshot::Tours tours)
+{
+   const std::uint64_t version = std::atomic_load(&current)->version() + 1;
+
+   std::atomic_store(&current,
+      std::shared_ptr<const CatalogSnapshot>(
+         std::make_shared<CatalogSnapshot>(std::move(tours), version)));
+
+   publishedVersion.store(version, std::memory_order_release);
+}
+
+void TourManager::load()
+{
+   Metrics::Scope metrics(Operation::Load);
+
+   CatalogSnapshot::Tours tours;
+
+   std::ifstream file(dataFile, std::ios::binary);
+   if (!file)
+   {
+      throw FileException("Не вдалося відкрити файл турів: " + dataFile);
+   }
+
+   // Файл читається одним блоком і розбирається CsvScanner без
+   // копіювання рядків.
+   std::string content;
+   file.seekg(0, std::ios::end);
+   const std::streamoff length = file.tellg();
+   file.seekg(0, std::ios::beg);
+   if (length > 0)
+   {
+      content.resize(static_cast<std::size_t>(length));
+      file.read(&content[0], length);
+   }
+
+   if (!file)
+   {
+      throw FileException("Помилка читання файлу турів: " + dataFile);
+   }
+   Metrics::bytesRead(content.size());
+
+   CsvScanner scanner(content.data(), content.size());
+   CsvRow row;
+   if (!scanner.next(row))
+   {
+      throw FileException("Файл турів порожній: " + dataFile);
+   }
+   const std::string header(row.text());
+
+   // Стовпці до "data" — службові (тип, ідентифікатор, місця),
+   // решта рядка — дані конкретного туру.
+   const std::vector<std::string> columns = splitHeader(header);
+   const auto dataColumn =
+      std::find(columns.begin(), columns.end(), "data");
+
+   if (dataColumn == columns.end() || columns.front() != "type")
+   {
+      throw FileException("Невідомий формат заголовка файлу турів: " + header);
+   }
+
+   const std::size_t prefixCount =
+      static_cast<std::size_t>(dataColumn - columns.begin());
+   const auto idColumn =
+      std::find(columns.begin(), dataColumn, "id");
+   const std::size_t idIndex =
+      static_cast<std::size_t>(idColumn - columns.begin());
+   const std::size_t capacityIndex = static_cast<std::size_t>(
+      std::find(columns.begin(), dataColumn, "capacity") - columns.begin());
+   const std::size_t soldIndex = static_cast<std::size_t>(
+      std::find(columns.begin(), dataColumn, "sold") - columns.begin());
+
+   // Збережений файл описує кожен слот окремим рядком (тур або free), тож
+   // номер слота менший за кількість рядків. Запас — для файлів, збережених
+   // без рядків free; більші номери вважаються пошкодженими, а не приводом
+   // виділяти пам'ять під мільйони порожніх слотів.
+   const std::size_t slotLimit = static_cast<std::size_t>(
+      std::count(content.begin(), content.end(), '\n')) + slotSlack;
+
+   const auto parseId = [slotLimit](const std::string& text)
+   {
+      TourId id = CatalogSnapshot::Tours::invalidId;
+      try
+      {
+         id = static_cast<TourId>(std::stoull(text));
+      }
+      catch (...)
+      {
+         return CatalogSnapshot::Tours::invalidId;
+      }
+
+      return CatalogSnapshot::Tours::indexOf(id) < slotLimit
+         ? id
+         : CatalogSnapshot::Tours::invalidId;
+   };
+
+   std::vector<bool> described;
+   std::uint32_t highestGeneration = 0;
+   const auto describe = [&](TourId id)
+   {
+      const std::uint32_t index = CatalogSnapshot::Tours::indexOf(id);
+      if (index >= described.size())
+      {
+         described.resize(static_cast<std::size_t>(index) + 1);
+      }
+      described[index] = true;
+      highestGeneration = std::max(highestGeneration,
+         CatalogSnapshot::Tours::generationOf(id));
+   };
+
+   // Тури без придатного ID розміщуються після відновлення всіх слотів,
+   // щоб не зайняти слот, який описано далі у файлі.
+   std::vector<CatalogEntry> unplaced;
+
+   std::vector<std::string> prefix(prefixCount);
+   while (scanner.next(row))
+   {
+      if (row.text().empty())
+      {
+         continue;
+      }
+
+      if (row.raw(0) == "free")
+      {
+         const TourId id = idIndex < row.size()
+            ? parseId(row.field(idIndex))
+            : CatalogSnapshot::Tours::invalidId;
+
+         if (tours.reserveAt(id))
+         {
+            describe(id);
+         }
+         else
+         {
+            std::cerr << "Некоректний вільний слот: " << row.text() << "\n";
+         }
+         continue;
+      }
+
+      if (row.size() < prefixCount)
+      {
+         std::cerr << "Пропущено рядок (немає типу).\n";
+         continue;
+      }
+
+      for (std::size_t i = 0; i < prefixCount; ++i)
+      {
+         row.copyField(i, prefix[i]);
+      }
+
+      const std::string& type = prefix[0];
+
+      try
+      {
+         CatalogEntry entry;
+         std::shared_ptr<const Tour>& tourPtr = entry.tour;
+
+         if (type == "city")
+         {
+            tourPtr = std::make_shared<CityTour>(row, prefixCount);
+         }
+         else if (type == "ski")
+         {
+            tourPtr = std::make_shared<SkiTour>(row, prefixCount);
+         }
+         else
+         {
+            std::cerr << "Невідомий тип туру: " << type << "\n";
+            continue;
+         }
+
+         int capacity = SeatInventory::defaultCapacity;
+         int sold = 0;
+         if (capacityIndex < prefixCount
+             && !parseSeatCount(prefix[capacityIndex], capacity))
+         {
+            std::cerr << "Некоректна кількість місць: "
+                      << prefix[capacityIndex] << ", використано "
+                      << SeatInventory::defaultCapacity << ".\n";
+            capacity = SeatInventory::defaultCapacity;
+         }
+
+         if (soldIndex < prefixCount
+             && !parseSeatCount(prefix[soldIndex], sold))
+         {
+            std::cerr << "Некоректна кількість проданих місць: "
+                      << prefix[soldIndex] << "\n";
+            sold = 0;
+         }
+
+         if (sold > capacity)
+         {
+            std::cerr << "Продано більше місць, ніж місткість туру; "
+                         "вільних місць немає.\n";
+         }
+
+         entry.seats = std::make_shared<SeatInventory>(capacity, sold);
+
+         if (idIndex < prefixCount)
+         {
+            const TourId id = parseId(prefix[idIndex]);
+            if (tours.insertAt(id, entry))
+            {
+               describe(id);
+               continue;
+            }
+
+            std::cerr << "Некоректний або повторний ідентифікатор туру: "
+                      << prefix[idIndex] << ", призначено новий.\n";
+         }
+
+         unplaced.push_back(std::move(entry));
+      }
+      catch (const FileException& ex)
+      {
+         std::cerr << "Помилка читання туру: " << ex.what() << "\n";
+      }
+      catch (const std::exception& ex)
+      {
+         std::cerr << "Загальна помилка парсингу туру: "
+                   << ex.what() << "\n";
+      }
+   }
+
+   // Вільні слоти, яких файл не описує, не повинні повторно видати ID
+   // видаленого туру: вони отримують покоління, новіше за всі відомі.
+   for (const TourId vacantId : tours.vacantIds())
+   {
+      const std::uint32_t index = CatalogSnapshot::Tours::indexOf(vacantId);
+      if (index >= described.size() || !described[index])
+      {
+         tours.reserveAt(
+            CatalogSnapshot::Tours::makeId(index, highestGeneration + 1));
+      }
+   }
+
+   for (CatalogEntry& entry : unplaced)
+   {
+      tours.insert(std::move(entry));
+   }
+
+   // Продані місця визначає журнал квитків, а не колонка sold: вона
+   // відстає від квитків, заброньованих після останнього save(). Колонка
+   // використовується, лише якщо журнал не вдалося прочитати.
+   Result<std::size_t> loaded = loadTickets();
+   if (loaded.ok())
+   {
+      const auto& values = tours.values();
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+         values[i].seats->setSold(
+            static_cast<int>(tickets.seatsSold(tours.idAt(i))));
+      }
+   }
+   else
+   {
+      std::cerr << loaded.error().message << "\n";
+   }
+
+   {
+      const auto lock = Metrics::acquire(writeMutex, Contention::CatalogWrite);
+      publish(std::move(tours));
+   }
+
+   Result<std::size_t> queued = waitlist.load();
+   if (!queued.ok())
+   {
+      std::cerr << queued.error().message << "\n";
+   }
+}
+
+void TourManager::save() const
+{
+   Metrics::Scope metrics(Operation::Save);
+
+   std::ofstream file(dataFile, std::ios::trunc);
+   if (!file)
+   {
+      throw FileException(
+         "Не вдалося відкрити файл турів для запису: " + dataFile);
+   }
+
+   file << "type,id,capacity,sold,data\n";
+
+   const std::shared_ptr<const CatalogSnapshot> catalog = snapshot();
+   const auto& tours = catalog->tours();
+   const auto& values = tours.values();
+   for (std::size_t i = 0; i < values.size(); ++i)
+   {
+      const auto& tourPtr = values[i].tour;
+      const SeatInventory::Counts seats = values[i].seats->counts();
+
+      if (auto cityTour =
+              std::dynamic_pointer_cast<const CityTour>(tourPtr))
+      {
+         file << "city," << tours.idAt(i) << ','
+              << seats.capacity << ','
+              << seats.capacity - seats.available << ','
+              << cityTour->toCSV() << "\n";
+      }
+      else if (auto skiTour =
+                  std::dynamic_pointer_cast<const SkiTour>(tourPtr))
+      {
+         file << "ski," << tours.idAt(i) << ','
+              << seats.capacity << ','
+              << seats.capacity - seats.available << ','
+              << skiTour->toCSV() << "\n";
+      }
+      else
+      {
+
+      }
+   }
+
+   // Вільні слоти зберігаються з поколінням, яке вони видадуть наступним,
+   // інакше після перезапуску новий тур отримав би ID видаленого.
+   for (const TourId id : tours.vacantIds())
+   {
+      file << "free," << id << "\n";
+   }
+
+   Metrics::bytesWritten(static_cast<std::uint64_t>(file.tellp()));
+}
+
+std::size_t TourManager::size() const
+{
+   return pinSnapshot().tours().size();
+}
+
+Result<std::shared_ptr<const Tour>> TourManager::getTour(TourId id) const
+{
+   Metrics::Scope metrics(Operation::GetTour);
+
+   const auto* entry = pinSnapshot().tours().find(id);
+   if (entry == nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::NotFound,
+         "Тур з таким ID не існує."});
+   }
+
+   return entry->tour;
+}
+
+Result<SeatInventory::Counts> TourManager::getSeats(TourId id) const
+{
+   Metrics::Scope metrics(Operation::GetSeats);
+
+   const SeatInventory* seats = pinSnapshot().seats(id);
+   if (seats == nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::NotFound,
+         "Тур з таким ID не існує."});
+   }
+
+   return seats->counts();
+}
+
+std::vector<TourId> TourManager::findTours(const TourQuery& query) const
+{
+   Metrics::Scope metrics(Operation::FindTours);
+
+   const CatalogSnapshot& catalog = pinSnapshot();
+
+   std::vector<TourId> found;
+   catalog.scan(query, 0, catalog.tours().size(), found);
+   return found;
+}
+
+std::size_t TourManager::scanTours(const TourQuery& query,
+   std::size_t position,
+   std::size_t limit,
+   std::vector<TourId>& out) const
+{
+   Metrics::Scope metrics(Operation::ScanTours);
+
+   return pinSnapshot().scan(query, position, limit, out);
+}
+
+TourCursor TourManager::openCursor(const TourQuery& query,
+   std::size_t pageSize) const
+{
+   Metrics::Scope metrics(Operation::OpenCursor);
+
+   return TourCursor(snapshot(), query, pageSize);
+}
+
+Result<void> TourManager::sortTours(SortKey key)
+{
+   Metrics::Scope metrics(Operation::SortTours);
+
+   if (key != SortKey::Price && key != SortKey::DepartureDate)
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         "Невідомий критерій сортування."});
+   }
+
+   return metrics.done(commit(
+      [key](CatalogSnapshot::Tours& tours) -> Result<void>
+      {
+         if (key == SortKey::Price)
+         {
+            tours.sort(
+               [](const CatalogEntry& a, const CatalogEntry& b)
+               {
+                  return a.tour->getPrice() < b.tour->getPrice();
+               });
+         }
+         else
+         {
+            tours.sort(
+               [](const CatalogEntry& a, const CatalogEntry& b)
+               {
+                  return a.tour->getDepartureDate()
+                       < b.tour->getDepartureDate();
+               });
+         }
+
+         return {};
+      }));
+}
+
+Result<TourId> TourManager::createTour(TourKind kind, const TourPatch& fields)
+{
+   Metrics::Scope metrics(Operation::CreateTour);
+
+   const char* missing = nullptr;
+
+   if (!fields.country)
+   {
+      missing = "country";
+   }
+   else if (!fields.city)
+   {
+      missing = "city";
+   }
+   else if (!fields.departureDate)
+   {
+      missing = "departureDate";
+   }
+   else if (!fields.returnDate)
+   {
+      missing = "returnDate";
+   }
+   else if (!fields.hotelLevel)
+   {
+      missing = "hotelLevel";
+   }
+   else if (!fields.price)
+   {
+      missing = "price";
+   }
+
+   if (missing != nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         std::string("Не задано обов'язкове поле: ") + missing});
+   }
+
+   const int capacity = fields.capacity.value_or(SeatInventory::defaultCapacity);
+   if (capacity < 0)
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         "Кількість місць не може бути від'ємною."});
+   }
+
+   std::shared_ptr<Tour> tourPtr;
+   if (kind == TourKind::City)
+   {
+      tourPtr = std::make_shared<CityTour>();
+   }
+   else
+   {
+      tourPtr = std::make_shared<SkiTour>();
+   }
+
+   Result<void> applied = tourPtr->applyPatch(fields);
+   if (!applied.ok())
+   {
+      return metrics.fail(applied.error());
+   }
+
+   return metrics.done(insertTour(std::move(tourPtr), capacity));
+}
+
+Result<TourId> TourManager::insertTour(std::shared_ptr<Tour> tour,
+   int capacity)
+{
+   if (!tour)
+   {
+      return Error{ErrorCode::InvalidArgument, "Порожній тур."};
+   }
+
+   if (capacity < 0)
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Кількість місць не може бути від'ємною."};
+   }
+
+   CatalogEntry entry;
+   entry.tour = std::move(tour);
+   entry.seats = std::make_shared<SeatInventory>(capacity);
+
+   TourId id = 0;
+   commit(
+      [&](CatalogSnapshot::Tours& tours) -> Result<void>
+      {
+         id = tours.insert(std::move(entry));
+         return {};
+      });
+
+   return id;
+}
+
+Result<void> TourManager::replaceTour(TourId id, std::shared_ptr<Tour> tour,
+   const std::shared_ptr<const Tour>& expected)
+{
+   Metrics::Scope metrics(Operation::ReplaceTour);
+
+   if (!tour)
+   {
+      return Error{ErrorCode::InvalidArgument, "Порожній тур."};
+   }
+
+   return metrics.done(commit(
+      [&](CatalogSnapshot::Tours& tours) -> Result<void>
+      {
+         auto* slot = tours.find(id);
+         if (slot == nullptr)
+         {
+            return Error{ErrorCode::NotFound, "Тур з таким ID не існує."};
+         }
+
+         if (expected && slot->tour != expected)
+         {
+            return Error{ErrorCode::Conflict,
+               "Тур змінено іншим записом; повторіть редагування."};
+         }
+
+         slot->tour = std::move(tour);
+         return {};
+      }));
+}
+
+Result<void> TourManager::updateTour(TourId id, const TourPatch& patch)
+{
+   Metrics::Scope metrics(Operation::UpdateTour);
+
+   // Швидка перевірка без копіювання каталогу; під блокуванням повторюється.
+   if (pinSnapshot().find(id) == nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::NotFound,
+         "Тур з таким ID не існує."});
+   }
+
+   Result<void> updated = commit(
+      [&](CatalogSnapshot::Tours& tours) -> Result<void>
+      {
+         auto* slot = tours.find(id);
+         if (slot == nullptr)
+         {
+            return Error{ErrorCode::NotFound, "Тур з таким ID не існує."};
+         }
+
+         std::shared_ptr<Tour> edited = slot->tour->clone();
+
+         Result<void> applied = edited->applyPatch(patch);
+         if (!applied.ok())
+         {
+            return applied;
+         }
+
+         // Місткість змінюється останньою: це єдиний крок, що зачіпає
+         // спільний лічильник, тому при помилці тур лишається незмінним.
+         if (patch.capacity)
+         {
+            Result<void> resized = slot->seats->resize(*patch.capacity);
+            if (!resized.ok())
+            {
+               return resized;
+            }
+         }
+
+         slot->tour = std::move(edited);
+         return {};
+      });
+
+   // Нові місця після збільшення місткості отримує черга очікування.
+   if (updated.ok() && patch.capacity)
+   {
+      promoteWaitlist(id);
+   }
+
+   return metrics.done(updated);
+}
+
+Result<void> TourManager::removeTour(TourId id)
+{
+   Metrics::Scope metrics(Operation::RemoveTour);
+
+   if (pinSnapshot().find(id) == nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::NotFound,
+         "Тур з таким ID не існує."});
+   }
+
+   return metrics.done(commit(
+      [id](CatalogSnapshot::Tours& tours) -> Result<void>
+      {
+         if (!tours.erase(id))
+         {
+            return Error{ErrorCode::NotFound, "Тур з таким ID не існує."};
+         }
+
+         return {};
+      }));
+}
+
+Result<Ticket> TourManager::bookTour(const std::string& username, TourId id)
+{
+   Metrics::Scope metrics(Operation::BookTour);
+
+   const CatalogSnapshot& catalog = pinSnapshot();
+   const Tour* tourPtr = catalog.find(id);
+   if (tourPtr == nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::NotFound,
+         "Тур з таким ID не існує."});
+   }
+
+   if (username.size() > TicketStore::maxUsernameLength)
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         "Ім'я користувача задовге для квитка."});
+   }
+
+   // Звільнені місця спершу належать черзі очікування.
+   if (!waitlist.empty() && waitlist.size(id) != 0)
+   {
+      return metrics.fail(Error{ErrorCode::SoldOut,
+         "На цей тур є черга очікування; приєднайтеся до неї."});
+   }
+
+   SeatInventory& seats = *catalog.seats(id);
+
+   if (!seats.tryReserve())
+   {
+      return metrics.fail(Error{ErrorCode::SoldOut,
+         "Вільних місць на цей тур немає."});
+   }
+
+   // Між першою перевіркою і резервуванням хтось міг стати в чергу, а
+   // скасування — звільнити місце саме для нього. Повторна перевірка після
+   // резервування (у парі з бар'єром у joinWaitlist) бачить таку заявку;
+   // місце тоді повертається черзі.
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   if (!waitlist.empty() && waitlist.size(id) != 0)
+   {
+      seats.release();
+      promoteWaitlist(id);
+      return metrics.fail(Error{ErrorCode::SoldOut,
+         "На цей тур є черга очікування; приєднайтеся до неї."});
+   }
+
+   return metrics.done(issueTicket(catalog, seats, username, id, 1));
+}
+
+Result<Ticket> TourManager::issueTicket(const CatalogSnapshot& catalog,
+   SeatInventory& inventory,
+   const std::string& username,
+   TourId id,
+   std::uint32_t seats)
+{
+   const Tour& tour = *catalog.find(id);
+
+   Ticket ticket;
+   ticket.username = username;
+   ticket.tourId = id;
+   ticket.country = tour.getCountry();
+   ticket.city = tour.getCity();
+   ticket.departureDate = tour.getDepartureDate();
+   ticket.returnDate = tour.getReturnDate();
+   ticket.price = tour.getPrice() * seats;
+   ticket.bookedAt = static_cast<std::int64_t>(std::time(nullptr));
+   ticket.seats = seats;
+
+   const TicketRecord record = TicketStore::makeRecord(ticket);
+   Result<void> written = ledger.append(record);
+   if (!written.ok())
+   {
+      inventory.release(static_cast<int>(seats));
+      return written.error();
+   }
+
+   tickets.add(&record, 1);
+   return ticket;
+}
+
+Result<Ticket> TourManager::cancelBooking(const std::string& username,
+   TourId id)
+{
+   Metrics::Scope metrics(Operation::CancelBooking);
+
+   Ticket cancelled;
+   {
+      // Скасування серіалізуються, щоб один квиток не скасували двічі.
+      std::lock_guard<std::mutex> lock(promotionMutex);
+
+      std::optional<TicketRecord> active = tickets.findActive(username, id);
+      if (!active)
+      {
+         return metrics.fail(Error{ErrorCode::NotFound,
+            "Активного квитка на цей тур не знайдено."});
+      }
+
+      TicketRecord record = *active;
+      record.flags = ticketCancellation;
+      record.bookedAt = static_cast<std::int64_t>(std::time(nullptr));
+
+      Result<void> written = ledger.append(record);
+      if (!written.ok())
+      {
+         return metrics.fail(written.error());
+      }
+
+      tickets.add(&record, 1);
+
+      const CatalogSnapshot& catalog = pinSnapshot();
+      if (SeatInventory* seats = catalog.seats(id))
+      {
+         seats->release(static_cast<int>(active->seats));
+      }
+
+      cancelled = makeTicket(catalog, *active);
+   }
+
+   promoteWaitlist(id);
+   return cancelled;
+}
+
+Result<WaitlistEntry> TourManager::joinWaitlist(const std::string& username,
+   TourId id,
+   std::uint32_t seats,
+   int priority)
+{
+   Metrics::Scope metrics(Operation::JoinWaitlist);
+
+   if (pinSnapshot().find(id) == nullptr)
+   {
+      return metrics.fail(Error{ErrorCode::NotFound,
+         "Тур з таким ID не існує."});
+   }
+
+   if (username.size() > TicketStore::maxUsernameLength)
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         "Ім'я користувача задовге для квитка."});
+   }
+
+   Result<WaitlistEntry> joined =
+      waitlist.join(username, id, seats, priority);
+   if (joined.ok())
+   {
+      // Пара до бар'єра в bookTour: або бронювання побачить цю заявку,
+      // або просування нижче побачить місце, яке воно зайняло.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      promoteWaitlist(id);
+   }
+
+   return metrics.done(joined);
+}
+
+Result<void> TourManager::leaveWaitlist(const std::string& username, TourId id)
+{
+   Metrics::Scope metrics(Operation::LeaveWaitlist);
+
+   std::lock_guard<std::mutex> lock(promotionMutex);
+   return metrics.done(waitlist.leave(username, id));
+}
+
+std::vector<WaitlistEntry> TourManager::waitlistFor(TourId id) const
+{
+   return waitlist.entries(id);
+}
+
+std::size_t TourManager::waitlistPosition(const std::string& username,
+   TourId id) const
+{
+   return waitlist.position(username, id);
+}
+
+std::size_t TourManager::promoteWaitlist(TourId id)
+{
+   // Один просувальник за раз: інакше двоє могли б обслужити ту саму
+   // першу заявку.
+   std::lock_guard<std::mutex> lock(promotionMutex);
+
+   std::size_t promoted = 0;
+   while (true)
+   {
+      std::optional<WaitlistEntry> next = waitlist.front(id);
+      if (!next)
+      {
+         break;
+      }
+
+      const CatalogSnapshot& catalog = pinSnapshot();
+      SeatInventory* seats = catalog.seats(id);
+
+      // Порядок черги суворий: якщо першій заявці місць не вистачає,
+      // наступні теж чекають.
+      if (seats == nullptr || !seats->tryReserve(static_cast<int>(next->seats)))
+      {
+         break;
+      }
+
+      // Заявка знімається з черги до оформлення квитка. Якщо запис у
+      // журнал черги не вдався, вона лишається першою без квитка; у
+      // зворотному порядку після перезапуску та сама заявка отримала б
+      // другий квиток.
+      Result<void> left = waitlist.leave(next->username, id);
+      if (!left.ok())
+      {
+         seats->release(static_cast<int>(next->seats));
+         if (left.error().code == ErrorCode::NotFound)
+         {
+            continue; // Користувач щойно вийшов з черги сам.
+         }
+         break;
+      }
+
+      Result<Ticket> issued =
+         issueTicket(catalog, *seats, next->username, id, next->seats);
+      if (!issued.ok())
+      {
+         // Квиток не записано: заявка повертається в чергу, хоча й
+         // після рівних їй за пріоритетом.
+         waitlist.join(next->username, id, next->seats, next->priority);
+         break;
+      }
+
+      ++promoted;
+   }
+
+   return promoted;
 }
 
-TourManager::TourManager(const std::string& dataFile)
-   : dataFile(dataFile)
+Result<std::vector<Ticket>> TourManager::bookGroup(const std::string& username,
+   std::vector<BookingItem> items)
 {
+   Metrics::Scope metrics(Operation::BookGroup);
+
+   if (items.empty())
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         "Порожнє групове бронювання."});
+   }
+
+   if (username.size() > TicketStore::maxUsernameLength)
+   {
+      return metrics.fail(Error{ErrorCode::InvalidArgument,
+         "Ім'я користувача задовге для квитка."});
+   }
+
+   // Єдиний порядок резервування (за ID) для всіх груп: конкуруючі групи
+   // бачать тури в однаковій послідовності і не захоплюють місця навхрест.
+   std::sort(items.begin(), items.end(),
+      [](const BookingItem& a, const BookingItem& b)
+      {
+         return a.tourId < b.tourId;
+      });
+
+   std::vector<BookingItem> merged;
+   for (const BookingItem& item : items)
+   {
+      if (item.seats == 0
+          || item.seats > static_cast<std::uint32_t>(
+                std::numeric_limits<int>::max()))
+      {
+         return metrics.fail(Error{ErrorCode::InvalidArgument,
+            "Некоректна кількість місць у груповому бронюванні."});
+      }
+
+      if (!merged.empty() && merged.back().tourId == item.tourId)
+      {
+         if (merged.back().seats > static_cast<std::uint32_t>(
+                std::numeric_limits<int>::max()) - item.seats)
+         {
+            return metrics.fail(Error{ErrorCode::InvalidArgument,
+               "Некоректна кількість місць у груповому бронюванні."});
+         }
+         merged.back().seats += item.seats;
+      }
+      else
+      {
+         merged.push_back(item);
+      }
+   }
+
+   const CatalogSnapshot& catalog = pinSnapshot();
+   std::vector<SeatInventory*> reserved;
+   reserved.reserve(merged.size());
+
+   const auto rollback = [&]()
+   {
+      for (std::size_t i = 0; i < reserved.size(); ++i)
+      {
+         reserved[i]->release(static_cast<int>(merged[i].seats));
+      }
+   };
+
+   for (const BookingItem& item : merged)
+   {
+      SeatInventory* seats = catalog.seats(item.tourId);
+      if (seats == nullptr)
+      {
+         rollback();
+         return metrics.fail(Error{ErrorCode::NotFound,
+            "Тур з ID " + std::to_string(item.tourId) + " не існує."});
+      }
+
+      if ((!waitlist.empty() && waitlist.size(item.tourId) != 0)
+          || !seats->tryReserve(static_cast<int>(item.seats)))
+      {
+         rollback();
+         return metrics.fail(Error{ErrorCode::SoldOut,
+            "Недостатньо вільних місць на тур з ID "
+            + std::to_string(item.tourId) + "."});
+      }
+
+      reserved.push_back(seats);
+   }
+
+   // Повторна перевірка черг після резервування, як у bookTour.
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   if (!waitlist.empty())
+   {
+      for (const BookingItem& item : merged)
+      {
+         if (waitlist.size(item.tourId) == 0)
+         {
+            continue;
+         }
+
+         rollback();
+         for (const BookingItem& queued : merged)
+         {
+            promoteWaitlist(queued.tourId);
+         }
+         return metrics.fail(Error{ErrorCode::SoldOut,
+            "На тур з ID " + std::to_string(item.tourId)
+            + " є черга очікування."});
+      }
+   }
+
+   const std::int64_t bookedAt = static_cast<std::int64_t>(std::time(nullptr));
+
+   std::vector<Ticket> booked;
+   std::vector<TicketRecord> records;
+   booked.reserve(merged.size());
+   records.reserve(merged.size());
+
+   for (const BookingItem& item : merged)
+   {
+      const Tour& tour = *catalog.find(item.tourId);
+
+      Ticket ticket;
+      ticket.username = username;
+      ticket.tourId = item.tourId;
+      ticket.country = tour.getCountry();
+      ticket.city = tour.getCity();
+      ticket.departureDate = tour.getDepartureDate();
+      ticket.returnDate = tour.getReturnDate();
+      ticket.price = tour.getPrice() * item.seats;
+      ticket.bookedAt = bookedAt;
+      ticket.seats = item.seats;
+
+      records.push_back(TicketStore::makeRecord(ticket));
+      booked.push_back(std::move(ticket));
+   }
+
+   Result<void> written = ledger.append(records.data(), records.size());
+   if (!written.ok())
+   {
+      rollback();
+      return metrics.fail(written.error());
+   }
+
+   tickets.add(records.data(), records.size());
+   return booked;
 }
 
-void TourManager::load()
+Result<Ticket> TourManager::bookTour(const std::string& username, TourId id,
+   const std::string& idempotencyKey, bool* replayed)
 {
-   tours.clear();
+   if (replayed != nullptr)
+   {
+      *replayed = false;
+   }
 
-   std::ifstream file(dataFile);
-   if (!file)
+   if (idempotencyKey.empty())
    {
-      throw FileException("Не вдалося відкрити файл турів: " + dataFile);
+      return bookTour(username, id);
    }
 
-   std::string header;
-   if (!std::getline(file, header))
+   // Ключ діє в межах користувача: однакові ключі різних клієнтів
+   // не повинні повертати чужі квитки.
+   const std::string scopedKey = username + '\n' + idempotencyKey;
+
+   Ticket original;
+   switch (bookingKeys.claim(scopedKey, id, original))
    {
-      throw FileException("Файл турів порожній: " + dataFile);
+      case IdempotencyCache::Claim::Replay:
+         if (replayed != nullptr)
+         {
+            *replayed = true;
+         }
+         return original;
+
+      case IdempotencyCache::Claim::Mismatch:
+         return Error{ErrorCode::InvalidArgument,
+            "Ключ ідемпотентності вже використано для іншого туру."};
+
+      case IdempotencyCache::Claim::Acquired:
+      default:
+         break;
    }
 
-   std::string line;
-   while (std::getline(file, line))
+   // Ключ звільняється на будь-якому шляху без complete(), зокрема якщо
+   // бронювання кинуло виняток.
+   IdempotencyCache::Lease lease(bookingKeys, scopedKey);
+
+   Result<Ticket> booked = bookTour(username, id);
+   if (booked.ok())
    {
-      if (line.empty())
-      {
-         continue;
-      }
+      lease.complete(booked.value());
+   }
 
-      std::istringstream iss(line);
-      std::string type;
-      if (!std::getline(iss, type, ','))
-      {
-         std::cerr << "Пропущено рядок (немає типу).\n";
-         continue;
-      }
+   return booked;
+}
 
-      std::string rest;
-      std::getline(iss, rest);
+Result<std::size_t> TourManager::loadTickets()
+{
+   Metrics::Scope metrics(Operation::LoadTickets);
 
-      try
+   return metrics.done(tickets.load(ledger.path()));
+}
+
+Result<std::size_t> TourManager::importTickets(const std::string& path)
+{
+   Metrics::Scope metrics(Operation::ImportTickets);
+
+   // Імпорти серіалізуються з письменниками каталогу: два одночасні
+   // імпорти одного файлу не повинні обидва пройти перевірку на повтори,
+   // а тур не повинен зникнути між пошуком і списанням місць.
+   const auto lock = Metrics::acquire(writeMutex, Contention::CatalogWrite);
+   const CatalogSnapshot& catalog = pinSnapshot();
+
+   const auto resolver =
+      [&catalog](const std::string& country, const std::string& city,
+         const std::string& departureDate, const std::string& returnDate)
       {
-         if (type == "city")
-         {
-            tours.push_back(std::make_shared<CityTour>(rest));
-         }
-         else if (type == "ski")
-         {
-            tours.push_back(std::make_shared<SkiTour>(rest));
-         }
-         else
+         const auto& tours = catalog.tours();
+         const auto& values = tours.values();
+
+         for (std::size_t i = 0; i < values.size(); ++i)
          {
-            std::cerr << "Невідомий тип туру: " << type << "\n";
+            const Tour& tour = *values[i].tour;
+            if (tour.getCountry() == country && tour.getCity() == city
+                && tour.getDepartureDate() == departureDate
+                && tour.getReturnDate() == returnDate)
+            {
+               return tours.idAt(i);
+            }
          }
-      }
-      catch (const FileException& ex)
-      {
-         std::cerr << "Помилка читання туру: " << ex.what() << "\n";
-      }
-      catch (const std::exception& ex)
+
+         return CatalogSnapshot::Tours::invalidId;
+      };
+
+   Result<std::vector<TicketRecord>> imported =
+      TicketStore::importText(path, resolver);
+   if (!imported.ok())
+   {
+      return metrics.fail(imported.error());
+   }
+
+   std::vector<TicketRecord>& records = imported.value();
+   tickets.dropKnown(records);
+   if (records.empty())
+   {
+      return std::size_t{0};
+   }
+
+   Result<void> written = ledger.append(records.data(), records.size());
+   if (!written.ok())
+   {
+      return metrics.fail(written.error());
+   }
+
+   tickets.add(records.data(), records.size());
+
+   // Імпортовані квитки займають місця так само, як заброньовані. Місця
+   // списуються приростом, а не перерахунком з журналу, щоб не загубити
+   // бронювання, які вже зарезервували місця, але ще не записали квиток.
+   for (const TicketRecord& record : records)
+   {
+      if (SeatInventory* seats = catalog.seats(record.tourId))
       {
-         std::cerr << "Загальна помилка парсингу туру: "
-                   << ex.what() << "\n";
+         seats->take(static_cast<int>(record.seats));
       }
    }
+
+   return records.size();
 }
 
-void TourManager::save() const
+Ticket TourManager::makeTicket(const CatalogSnapshot& catalog,
+   const TicketRecord& record)
 {
-   std::ofstream file(dataFile, std::ios::trunc);
-   if (!file)
+   Ticket ticket;
+   ticket.username = TicketStore::usernameOf(record);
+   ticket.tourId = record.tourId;
+   ticket.price = record.price;
+   ticket.bookedAt = record.bookedAt;
+   ticket.seats = record.seats;
+
+   if (const Tour* tour = catalog.find(record.tourId))
    {
-      throw FileException(
-         "Не вдалося відкрити файл турів для запису: " + dataFile);
+      ticket.country = tour->getCountry();
+      ticket.city = tour->getCity();
+      ticket.departureDate = tour->getDepartureDate();
+      ticket.returnDate = tour->getReturnDate();
    }
 
-   file << "type,data\n";
+   return ticket;
+}
+
+std::vector<Ticket> TourManager::userTickets(const std::string& username) const
+{
+   Metrics::Scope metrics(Operation::UserTickets);
+
+   const CatalogSnapshot& catalog = pinSnapshot();
 
-   for (auto& tourPtr : tours)
+   std::vector<Ticket> result;
+   for (const TicketRecord& record : tickets.forUser(username))
    {
-      if (auto cityTour =
-              std::dynamic_pointer_cast<CityTour>(tourPtr))
-      {
-         file << "city," << cityTour->toCSV() << "\n";
-      }
-      else if (auto skiTour =
-                  std::dynamic_pointer_cast<SkiTour>(tourPtr))
-      {
-         file << "ski," << skiTour->toCSV() << "\n";
-      }
-      else
-      {
+      result.push_back(makeTicket(catalog, record));
+   }
 
-      }
+   return result;
+}
+
+std::vector<Ticket> TourManager::tourTickets(TourId id) const
+{
+   Metrics::Scope metrics(Operation::TourTickets);
+
+   const CatalogSnapshot& catalog = pinSnapshot();
+
+   std::vector<Ticket> result;
+   for (const TicketRecord& record : tickets.forTour(id))
+   {
+      result.push_back(makeTicket(catalog, record));
+   }
+
+   return result;
+}
+
+MemoryReport TourManager::memoryReport() const
+{
+   MemoryReport report;
+
+   const std::shared_ptr<const CatalogSnapshot> catalog = snapshot();
+   const auto& tours = catalog->tours();
+
+   // Кожен блок таблиці — окреме виділення.
+   report.add("catalog.table", tours.size(),
+      tours.memoryBytes()
+         + tours.allocations() * MemoryReport::allocatorOverhead);
+
+   for (const CatalogEntry& entry : tours.values())
+   {
+      entry.tour->accountMemory(report);
+   }
+
+   std::uint64_t objects = 0;
+   std::uint64_t objectBytes = 0;
+   std::uint64_t stringBlocks = 0;
+   std::uint64_t stringBytes = 0;
+   for (TypeMemory& type : report.types)
+   {
+      type.controlBlockBytes = type.objects * MemoryReport::controlBlockSize;
+      objects += type.objects;
+      objectBytes += type.objectBytes;
+      stringBlocks += type.heapBlocks();
+      stringBytes += type.heapBytes();
    }
+
+   // Тури й лічильники місць створюються через make_shared: блок керування
+   // і об'єкт — одне виділення.
+   report.add("catalog.tours", objects, objectBytes);
+   report.add("catalog.controlBlocks", objects + tours.size(),
+      (objects + tours.size()) * MemoryReport::controlBlockSize);
+   report.add("catalog.strings", stringBlocks, stringBytes);
+   report.add("catalog.seats", tours.size(),
+      tours.size() * sizeof(SeatInventory));
+   report.add("catalog.allocatorOverhead",
+      objects + tours.size() + stringBlocks,
+      (objects + tours.size() + stringBlocks)
+         * MemoryReport::allocatorOverhead);
+
+   tickets.accountMemory(report);
+   return report;
+}
+
+std::uint64_t TourManager::seatsSold(TourId id) const
+{
+   return tickets.seatsSold(id);
 }
 
 void TourManager::mainMenu()
@@ -290,18 +1594,105 @@ void TourManager::mainMenu()
 
 void TourManager::displayAll() const
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Немає турів.\n";
       return;
    }
 
-   int index = 0;
-   for (auto& tourPtr : tours)
+   browse(TourQuery::all());
+}
+
+bool TourManager::browse(const TourQuery& query) const
+{
+   TourCursor cursor = openCursor(query, menuPageSize);
+
+   const std::vector<TourId>* page = &cursor.nextPage();
+   if (page->empty())
+   {
+      return false;
+   }
+
+   while (true)
+   {
+      printTours(cursor.snapshot(), *page);
+
+      if (!cursor.hasNext() && !cursor.hasPrevious())
+      {
+         return true;
+      }
+
+      std::cout << "Сторінка " << cursor.pageNumber()
+                << ". n — наступна, p — попередня, "
+                   "інше — завершити перегляд: ";
+
+      std::string command;
+      if (!std::getline(std::cin, command))
+      {
+         return true;
+      }
+
+      if (command == "n" && cursor.hasNext())
+      {
+         page = &cursor.nextPage();
+      }
+      else if (command == "p" && cursor.hasPrevious())
+      {
+         page = &cursor.previousPage();
+      }
+      else if (command != "n" && command != "p")
+      {
+         return true;
+      }
+   }
+}
+
+void TourManager::printTours(const CatalogSnapshot& catalog,
+   const std::vector<TourId>& ids,
+   std::size_t first,
+   std::size_t count) const
+{
+   first = std::min(first, ids.size());
+   const std::size_t last =
+      count > ids.size() - first ? ids.size() : first + count;
+
+   TableRenderer table({
+      {"ID", TableRenderer::Align::Right},
+      {"Тип", TableRenderer::Align::Left},
+      {"Країна", TableRenderer::Align::Left},
+      {"Місто/курорт", TableRenderer::Align::Left},
+      {"Відправлення", TableRenderer::Align::Left},
+      {"Повернення", TableRenderer::Align::Left},
+      {"Рівень", TableRenderer::Align::Left},
+      {"Ціна, грн", TableRenderer::Align::Right},
+      {"Місця", TableRenderer::Align::Right}});
+   table.reserve(last - first);
+
+   char number[32];
+   for (std::size_t i = first; i < last; ++i)
    {
-      std::cout << index++ << ") ";
-      tourPtr->display();
+      const Tour& tour = *catalog.find(ids[i]);
+
+      table.beginRow();
+      table.addCell(std::to_string(ids[i]));
+      table.addCell(dynamic_cast<const SkiTour*>(&tour) != nullptr
+                       ? "SKI" : "CITY");
+      table.addCell(tour.getCountry());
+      table.addCell(tour.getCity());
+      table.addCell(tour.getDepartureDate());
+      table.addCell(tour.getReturnDate());
+      table.addCell(tour.getHotelLevel());
+
+      std::snprintf(number, sizeof(number), "%g", tour.getPrice());
+      table.addCell(number);
+
+      const SeatInventory::Counts seats = catalog.seats(ids[i])->counts();
+      std::snprintf(number, sizeof(number), "%d/%d",
+         seats.available, seats.capacity);
+      table.addCell(number);
    }
+
+   table.print(std::cout);
 }
 
 void TourManager::addTour()
@@ -346,15 +1737,31 @@ void TourManager::addTour()
    }
 
    tourPtr->input();
-   tours.push_back(tourPtr);
 
-   std::cout << "Тур додано в пам'ять. "
+   std::cout << "Кількість місць: ";
+   int capacity = 0;
+   if (!readStrictInt(capacity) || capacity < 0)
+   {
+      std::cin.clear();
+      std::cin.ignore(
+         std::numeric_limits<std::streamsize>::max(),
+         '\n');
+      throw ValidationException("Некоректна кількість місць.");
+   }
+
+   std::cin.ignore(
+      std::numeric_limits<std::streamsize>::max(),
+      '\n');
+
+   const TourId id = unwrap(insertTour(tourPtr, capacity));
+
+   std::cout << "Тур додано в пам'ять з ID " << id << ". "
                 "Збережіть у файл для постійного зберігання.\n";
 }
 
 void TourManager::searchMenu() const
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Список турів порожній.\n";
       return;
@@ -384,7 +1791,8 @@ void TourManager::searchMenu() const
    std::cin.ignore(
       std::numeric_limits<std::streamsize>::max(), '\n');
 
-   int foundCount = 0;
+   TourQuery query;
+   std::string notFoundMessage;
 
    if (searchChoice == 1)
    {
@@ -392,23 +1800,9 @@ void TourManager::searchMenu() const
       std::cout << "\nКраїна: ";
       std::getline(std::cin, country);
 
-      int index = 0;
-      for (const auto& tourPtr : tours)
-      {
-         if (tourPtr->getCountry() == country)
-         {
-            std::cout << index << ") ";
-            tourPtr->display();
-            ++foundCount;
-         }
-         ++index;
-      }
-
-      if (foundCount == 0)
-      {
-         throw NotFoundException(
-            "Помилка введення: Турів для країни '" + country + "' не знайдено.");
-      }
+      query = TourQuery::byCountry(country);
+      notFoundMessage =
+         "Помилка введення: Турів для країни '" + country + "' не знайдено.";
    }
    else if (searchChoice == 2)
    {
@@ -416,28 +1810,12 @@ void TourManager::searchMenu() const
       std::cout << "\nМісто/курорт: ";
       std::getline(std::cin, city);
 
-      int index = 0;
-      for (const auto& tourPtr : tours)
-      {
-         if (tourPtr->getCity() == city)
-         {
-            std::cout << index << ") ";
-            tourPtr->display();
-            ++foundCount;
-         }
-         ++index;
-      }
-
-      if (foundCount == 0)
-      {
-         throw NotFoundException(
-            "Помилка введення: Турів для міста/курорту '" + city + "' не знайдено.");
-      }
+      query = TourQuery::byCity(city);
+      notFoundMessage =
+         "Помилка введення: Турів для міста/курорту '" + city + "' не знайдено.";
    }
    else if (searchChoice == 3)
    {
-
-
       std::string fromDate;
       std::string toDate;
 
@@ -447,40 +1825,26 @@ void TourManager::searchMenu() const
       std::cout << "Кінцева дата   (YYYY-MM-DD, можна залишити порожньою): ";
       std::getline(std::cin, toDate);
 
-      int index = 0;
-      for (const auto& tourPtr : tours)
-      {
-         const std::string date = tourPtr->getDepartureDate();
-
-         bool okFrom = fromDate.empty() || date >= fromDate;
-         bool okTo   = toDate.empty()   || date <= toDate;
-
-         if (okFrom && okTo)
-         {
-            std::cout << index << ") ";
-            tourPtr->display();
-            ++foundCount;
-         }
-         ++index;
-      }
-
-      if (foundCount == 0)
-      {
-         throw NotFoundException(
-            "Помилка введення: Турів у вказаному діапазоні дат не знайдено.");
-      }
+      query = TourQuery::byDateRange(fromDate, toDate);
+      notFoundMessage =
+         "Помилка введення: Турів у вказаному діапазоні дат не знайдено.";
    }
    else
    {
       throw ValidationException(
          "Помилка введення: Некоректне введення пункту меню пошуку.");
    }
+
+   if (!browse(query))
+   {
+      throw NotFoundException(notFoundMessage);
+   }
 }
 
 
 void TourManager::sortMenu()
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Список турів порожній.\n";
       return;
@@ -512,29 +1876,14 @@ void TourManager::sortMenu()
 
    if (sortChoice == 1)
    {
-      std::sort(
-         tours.begin(),
-         tours.end(),
-         [](const std::shared_ptr<Tour>& a,
-            const std::shared_ptr<Tour>& b)
-         {
-            return a->getPrice() < b->getPrice();
-         });
+      unwrap(sortTours(SortKey::Price));
 
       std::cout << "Відсортовано за ціною.\n";
       displayAll();
    }
    else if (sortChoice == 2)
    {
-      std::sort(
-         tours.begin(),
-         tours.end(),
-         [](const std::shared_ptr<Tour>& a,
-            const std::shared_ptr<Tour>& b)
-         {
-            return a->getDepartureDate()
-                 < b->getDepartureDate();
-         });
+      unwrap(sortTours(SortKey::DepartureDate));
 
       std::cout << "Відсортовано за датою відправлення.\n";
       displayAll();
@@ -548,7 +1897,7 @@ void TourManager::sortMenu()
 
 void TourManager::filterMenu() const
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Список турів порожній.\n";
       return;
@@ -584,16 +1933,7 @@ void TourManager::filterMenu() const
                    "(наприклад 3* або Hard): ";
       std::getline(std::cin, level);
 
-      int index = 0;
-      for (const auto& tourPtr : tours)
-      {
-         if (tourPtr->getHotelLevel() == level)
-         {
-            std::cout << index << ") ";
-            tourPtr->display();
-         }
-         ++index;
-      }
+      browse(TourQuery::byHotelLevel(level));
    }
    else if (filterChoice == 2)
    {
@@ -611,16 +1951,7 @@ void TourManager::filterMenu() const
          throw ValidationException("Некоректна максимальна ціна.");
       }
 
-      int index = 0;
-      for (const auto& tourPtr : tours)
-      {
-         if (tourPtr->getPrice() <= maxPrice)
-         {
-            std::cout << index << ") ";
-            tourPtr->display();
-         }
-         ++index;
-      }
+      browse(TourQuery::byMaxPrice(maxPrice));
    }
    else
    {
@@ -631,39 +1962,23 @@ void TourManager::filterMenu() const
 
 void TourManager::editTour()
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Немає турів для редагування.\n";
       return;
    }
 
    displayAll();
-   std::cout << "Введіть індекс туру для редагування: ";
-
-   int index = 0;
-
-   if (!readStrictInt(index))
-   {
-      std::cin.clear();
-      std::cin.ignore(
-         std::numeric_limits<std::streamsize>::max(),
-         '\n');
-      throw ValidationException("Некоректний формат індексу.");
-   }
-
-   if (index < 0 || index >= static_cast<int>(tours.size()))
-   {
-      std::cin.ignore(
-         std::numeric_limits<std::streamsize>::max(),
-         '\n');
-      throw NotFoundException("Тур з таким індексом не існує.");
-   }
+   std::cout << "Введіть ID туру для редагування: ";
 
-   std::cin.ignore(
-      std::numeric_limits<std::streamsize>::max(),
-      '\n');
+   const TourId id = readTourId("Некоректний формат ID туру.");
 
-   tours[static_cast<std::size_t>(index)]->editInteractive();
+   // Тур замінюється, лише якщо за час редагування його ніхто не змінив;
+   // інакше чужу зміну було б мовчки перезаписано.
+   const std::shared_ptr<const Tour> original = unwrap(getTour(id));
+   std::shared_ptr<Tour> edited = original->clone();
+   edited->editInteractive();
+   unwrap(replaceTour(id, edited, original));
 
    std::cout << "Тур оновлено в пам'яті. "
                 "Не забудьте зберегти у файл.\n";
@@ -671,64 +1986,46 @@ void TourManager::editTour()
 
 void TourManager::deleteTour()
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Немає турів для видалення.\n";
       return;
    }
 
    displayAll();
-   std::cout << "Введіть індекс туру для видалення: ";
+   std::cout << "Введіть ID туру для видалення: ";
 
-   int index = 0;
+   const TourId id = readTourId("Некоректний формат ID туру.");
 
-   if (!readStrictInt(index))
-   {
-      std::cin.clear();
-      std::cin.ignore(
-         std::numeric_limits<std::streamsize>::max(),
-         '\n');
-      throw ValidationException("Некоректний формат індексу.");
-   }
+   unwrap(removeTour(id));
+
+   std::cout << "Тур видалено з пам'яті. "
+                "Не забудьте зберегти у файл.\n";
+}
+
+TourId TourManager::readTourId(const std::string& errorMessage) const
+{
+   TourId id = 0;
 
-   if (index < 0 || index >= static_cast<int>(tours.size()))
+   if (!readStrictId(id))
    {
+      std::cin.clear();
       std::cin.ignore(
          std::numeric_limits<std::streamsize>::max(),
          '\n');
-      throw NotFoundException("Тур з таким індексом не існує.");
+      throw ValidationException(errorMessage);
    }
 
    std::cin.ignore(
       std::numeric_limits<std::streamsize>::max(),
       '\n');
 
-   tours.erase(tours.begin() + index);
-
-   std::cout << "Тур видалено з пам'яті. "
-                "Не забудьте зберегти у файл.\n";
-}
-
-bool TourManager::dateInRange(const std::string& date,
-   const std::string& from,
-   const std::string& to)
-{
-   if (from.empty() && to.empty())
-   {
-      return true;
-   }
-
-   if (!from.empty() && date < from)
-   {
-      return false;
-   }
-
-   if (!to.empty() && date > to)
+   if (pinSnapshot().find(id) == nullptr)
    {
-      return false;
+      throw NotFoundException("Тур з таким ID не існує.");
    }
 
-   return true;
+   return id;
 }
 
 void TourManager::userMenu(const std::string& username)
@@ -754,6 +2051,7 @@ void TourManager::userMenu(const std::string& username)
       std::cout <<   "| 3. Фільтрувати тури      |\n";
       std::cout <<   "| 4. Замовити квиток       |\n";
       std::cout <<   "| 5. Допомога              |\n";
+      std::cout <<   "| 6. Мої квитки            |\n";
       std::cout <<   "| 0. Вийти                 |\n";
       std::cout <<   "|                          |\n";
       std::cout <<   "____________________________\n";
@@ -796,6 +2094,10 @@ void TourManager::userMenu(const std::string& username)
                helpInfoUser();
                break;
 
+            case 6:
+               showTickets(username);
+               break;
+
             case 0:
                std::cout << "Вихід у головне меню...\n";
                return;
@@ -825,7 +2127,7 @@ void TourManager::userMenu(const std::string& username)
 
 void TourManager::bookTicket(const std::string& username)
 {
-   if (tours.empty())
+   if (pinSnapshot().tours().empty())
    {
       std::cout << "Немає доступних турів для замовлення.\n";
       return;
@@ -834,65 +2136,83 @@ void TourManager::bookTicket(const std::string& username)
    std::cout << "\n=== Замовлення квитка ===\n";
    displayAll();
 
-   std::cout
-      << "Введіть індекс туру для бронювання (починаючи з 0): ";
+   std::cout << "Введіть ID туру для бронювання: ";
 
-   int index = 0;
+   const TourId id =
+      readTourId("Некоректний формат ID туру для бронювання.");
 
-   if (!readStrictInt(index))
+   Result<Ticket> booked = bookTour(username, id);
+   if (!booked.ok() && booked.error().code == ErrorCode::IoError)
    {
-      std::cin.clear();
-      std::cin.ignore(
-         std::numeric_limits<std::streamsize>::max(),
-         '\n');
-      throw ValidationException(
-         "Некоректний формат індексу для бронювання.");
+      std::cerr << FileException(booked.error().message).what() << "\n";
+      return;
    }
 
-   if (index < 0 || index >= static_cast<int>(tours.size()))
+   if (!booked.ok() && booked.error().code == ErrorCode::SoldOut)
    {
-      std::cin.ignore(
-         std::numeric_limits<std::streamsize>::max(),
-         '\n');
-      throw NotFoundException("Тур з таким індексом не існує.");
-   }
-
-   std::cin.ignore(
-      std::numeric_limits<std::streamsize>::max(),
-      '\n');
+      std::cout << booked.error().message
+                << "\nСтати в чергу очікування? (y/n): ";
 
-   try
-   {
-      std::ofstream file("data/tickets.txt", std::ios::app);
-      if (!file)
+      std::string answer;
+      std::getline(std::cin, answer);
+      if (answer != "y" && answer != "Y")
       {
-         throw FileException(
-            "Помилка відкриття файлу data/tickets.txt.");
+         return;
       }
 
-      file.seekp(0, std::ios::end);
-      if (file.tellp() == 0)
+      unwrap(joinWaitlist(username, id));
+
+      const std::size_t position = waitlistPosition(username, id);
+      if (position == 0)
       {
-         file << "username,country,city,"
-                 "departureDate,returnDate,price\n";
+         std::cout << "Місце звільнилося, квиток оформлено!\n";
       }
+      else
+      {
+         std::cout << "Ви в черзі очікування, позиція " << position << ".\n";
+      }
+      return;
+   }
 
-      auto& tour = tours[static_cast<std::size_t>(index)];
+   const Ticket ticket = unwrap(std::move(booked));
 
-      file << username << ","
-           << tour->getCountry() << ","
-           << tour->getCity() << ","
-           << tour->getDepartureDate() << ","
-           << tour->getReturnDate() << ","
-           << tour->getPrice() << "\n";
+   std::cout << "Тур \"" << ticket.city
+             << "\" успішно заброньовано!\n";
+}
 
-      std::cout << "Тур \"" << tour->getCity()
-                << "\" успішно заброньовано!\n";
+void TourManager::showTickets(const std::string& username) const
+{
+   const std::vector<Ticket> booked = userTickets(username);
+   if (booked.empty())
+   {
+      std::cout << "У вас ще немає заброньованих турів.\n";
+      return;
    }
-   catch (const FileException& ex)
+
+   TableRenderer table({
+      {"ID туру", TableRenderer::Align::Right},
+      {"Країна", TableRenderer::Align::Left},
+      {"Місто/курорт", TableRenderer::Align::Left},
+      {"Відправлення", TableRenderer::Align::Left},
+      {"Повернення", TableRenderer::Align::Left},
+      {"Ціна, грн", TableRenderer::Align::Right}});
+   table.reserve(booked.size());
+
+   char number[32];
+   for (const Ticket& ticket : booked)
    {
-      std::cerr << ex.what() << "\n";
+      table.beginRow();
+      table.addCell(std::to_string(ticket.tourId));
+      table.addCell(ticket.country.empty() ? "(тур видалено)" : ticket.country);
+      table.addCell(ticket.city);
+      table.addCell(ticket.departureDate);
+      table.addCell(ticket.returnDate);
+
+      std::snprintf(number, sizeof(number), "%g", ticket.price);
+      table.addCell(number);
    }
+
+   table.print(std::cout);
 }
 
 void TourManager::helpInfoAdmin() const
@@ -932,9 +2252,10 @@ void TourManager::helpInfoUser() const
    std::cout <<  "| або датою.                                     |\n";
    std::cout <<  "| 3. Фільтрувати тури — відбір за рівнем         |\n";
    std::cout <<  "| готелю/складністю чи ціною.                    |\n";
-   std::cout <<  "| 4. Замовити квиток — бронювання туру, дані     |\n";
-   std::cout <<  "| записуються у tickets.txt.                     |\n";
+   std::cout <<  "| 4. Замовити квиток — бронювання туру за ID,    |\n";
+   std::cout <<  "| дані записуються у tickets.bin.                |\n";
    std::cout <<  "| 5. Допомога — це пояснення.                    |\n";
+   std::cout <<  "| 6. Мої квитки — список ваших бронювань.        |\n";
    std::cout <<  "| 0. Вийти — повернення у головне меню           |\n";
    std::cout <<  "| програми.                                      |\n";
    std::cout <<  "|                                                |\n";
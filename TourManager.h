@@ -2,14 +2,35 @@
 #pragma once
 
 #include "Tour.h"
+#include "BookingLedger.h"
+#include "SlotMap.h"
+#include "CatalogSnapshot.h"
+#include "IdempotencyCache.h"
+#include "MemoryReport.h"
+#include "Result.h"
+#include "Ticket.h"
+#include "TicketStore.h"
+#include "TourCursor.h"
+#include "TourPatch.h"
+#include "TourQuery.h"
+#include "Waitlist.h"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 /// \file TourManager.h
 /// \brief Оголошення класу TourManager для керування списком турів.
 
+/// \brief Стабільний ідентифікатор туру в каталозі.
+/// \details Не змінюється при сортуванні чи видаленні інших турів;
+/// після видалення туру його ідентифікатор стає недійсним.
+using TourId = SlotId;
+
 /// \class TourManager
 /// \brief Клас для керування списком турів.
 /// \details Відповідає за:
@@ -18,18 +39,42 @@
 /// - редагування та видалення турів;
 /// - роботу меню адміністратора та користувача;
 /// - бронювання турів.
+///
+/// Програмний API (findTours, createTour, bookTour тощо) не звертається
+/// до консолі й повертає помилки як значення Result; консольні меню
+/// є тонкими обгортками над ним.
+///
+/// Каталог безпечний для одночасного використання з багатьох потоків.
+/// Читачі працюють з незмінним знімком CatalogSnapshot і ніколи не чекають
+/// на письменників. Письменники серіалізуються між собою, будують нову
+/// версію каталогу та атомарно публікують її.
 class TourManager
 {
 public:
    /// \brief Створює менеджер турів із вказаним файлом даних.
    /// \param dataFile Шлях до CSV-файлу зі списком турів.
-   explicit TourManager(const std::string& dataFile = "data/tours.csv");
+   /// \param ticketsFile Шлях до двійкового файлу оформлених квитків.
+   /// \param waitlistFile Шлях до журналу черг очікування.
+   /// \param ledgerOptions Політика групової фіксації квитків.
+   explicit TourManager(const std::string& dataFile = "data/tours.csv",
+      const std::string& ticketsFile = "data/tickets.bin",
+      const std::string& waitlistFile = "data/waitlist.log",
+      LedgerOptions ledgerOptions = {});
+
+   /// \brief Звільняє знімок каталогу, закріплений поточним потоком.
+   ~TourManager();
 
-   /// \brief Завантажує тури з файлу у пам’ять.
-   /// \throws FileException Якщо файл не вдається відкрити або прочитати.
+   /// \brief Завантажує тури з файлу у пам’ять, а також сховище квитків
+   /// і черги очікування.
+   /// \details Продані місця кожного туру перераховуються за сховищем
+   /// квитків; колонка sold файлу турів враховується, лише якщо сховище
+   /// не вдалося прочитати.
+   /// \throws FileException Якщо файл турів не вдається відкрити або прочитати.
    void load();
 
    /// \brief Зберігає всі тури з пам’яті у файл.
+   /// \details Вільні слоти записуються рядками `free,<ID>`, щоб після
+   /// перезапуску ID видалених турів не видавалися новим турам.
    /// \throws FileException Якщо файл не вдається відкрити для запису.
    void save() const;
 
@@ -44,13 +89,276 @@ public:
    /// \param username Ім’я користувача, який бронює тур.
    void bookTicket(const std::string& username);
 
+   /// \brief Виводить квитки користувача.
+   /// \param username Ім’я користувача.
+   void showTickets(const std::string& username) const;
+
+   // --- Програмний API без консольного введення/виведення. ---
+
+   /// \brief Повертає поточну опубліковану версію каталогу.
+   /// \details Знімок залишається незмінним, скільки б його не тримали.
+   std::shared_ptr<const CatalogSnapshot> snapshot() const;
+
+   /// \brief Повертає кількість турів у каталозі.
+   std::size_t size() const;
+
+   /// \brief Повертає тур за ідентифікатором.
+   /// \param id Ідентифікатор туру.
+   /// \return Тур або помилка NotFound.
+   Result<std::shared_ptr<const Tour>> getTour(TourId id) const;
+
+   /// \brief Повертає місткість туру та кількість вільних місць.
+   /// \param id Ідентифікатор туру.
+   /// \return Лічильники місць або помилка NotFound.
+   Result<SeatInventory::Counts> getSeats(TourId id) const;
+
+   /// \brief Шукає тури за критерієм.
+   /// \param query Критерій пошуку або фільтрації.
+   /// \return Ідентифікатори знайдених турів у поточному порядку каталогу.
+   std::vector<TourId> findTours(const TourQuery& query) const;
+
+   /// \brief Сканує каталог з указаної позиції до накопичення limit збігів.
+   /// \details Позиції відносяться до поточної версії каталогу; для
+   /// стабільного посторінкового перегляду використовуйте openCursor().
+   /// \param query Критерій відбору.
+   /// \param position Позиція в поточному порядку каталогу, з якої почати.
+   /// \param limit Максимальна кількість знайдених турів.
+   /// \param out Вектор, до якого дописуються ідентифікатори знайдених турів.
+   /// \return Позиція, з якої слід продовжити сканування.
+   std::size_t scanTours(const TourQuery& query,
+      std::size_t position,
+      std::size_t limit,
+      std::vector<TourId>& out) const;
+
+   /// \brief Відкриває курсор для посторінкового перегляду результатів.
+   /// \details Курсор тримає знімок каталогу, тому зміни, опубліковані
+   /// після відкриття, не зсувають його сторінки.
+   /// \param query Критерій відбору.
+   /// \param pageSize Кількість турів на сторінці.
+   /// \return Курсор, що ще не завантажив жодної сторінки.
+   TourCursor openCursor(const TourQuery& query, std::size_t pageSize) const;
+
+   /// \brief Впорядковує каталог.
+   /// \param key Критерій сортування.
+   /// \return Порожній результат або помилка InvalidArgument.
+   Result<void> sortTours(SortKey key);
+
+   /// \brief Створює новий тур з типізованих полів.
+   /// \param kind Вид туру.
+   /// \param fields Поля туру; country, city, дати, hotelLevel і price обов'язкові,
+   /// без capacity тур отримує SeatInventory::defaultCapacity місць.
+   /// \return Ідентифікатор нового туру або помилка InvalidArgument.
+   Result<TourId> createTour(TourKind kind, const TourPatch& fields);
+
+   /// \brief Додає готовий об'єкт туру до каталогу.
+   /// \param tour Тур для додавання.
+   /// \param capacity Кількість місць.
+   /// \return Ідентифікатор нового туру або помилка InvalidArgument.
+   Result<TourId> insertTour(std::shared_ptr<Tour> tour,
+      int capacity = SeatInventory::defaultCapacity);
+
+   /// \brief Замінює тур новим об'єктом під тим самим ідентифікатором.
+   /// \details Місткість і продані місця туру зберігаються.
+   /// \param id Ідентифікатор туру.
+   /// \param tour Новий вміст туру.
+   /// \param expected Якщо задано, тур замінюється лише тоді, коли в
+   /// каталозі досі цей самий об'єкт (тобто тур не змінювали після
+   /// прочитання через getTour).
+   /// \return Порожній результат, NotFound, Conflict або InvalidArgument.
+   Result<void> replaceTour(TourId id, std::shared_ptr<Tour> tour,
+      const std::shared_ptr<const Tour>& expected = nullptr);
+
+   /// \brief Змінює поля туру.
+   /// \details Зменшити capacity нижче кількості проданих місць не можна.
+   /// \param id Ідентифікатор туру.
+   /// \param patch Поля, які потрібно змінити.
+   /// \return Порожній результат, NotFound або InvalidArgument.
+   Result<void> updateTour(TourId id, const TourPatch& patch);
+
+   /// \brief Видаляє тур.
+   /// \details Як і будь-яка зміна каталогу, публікує нову версію таблиці:
+   /// O(n / ChunkedVector::chunkSize) на копію вказівників на блоки плюс
+   /// кілька змінених блоків.
+   /// \param id Ідентифікатор туру.
+   /// \return Порожній результат або помилка NotFound.
+   Result<void> removeTour(TourId id);
+
+   /// \brief Бронює місце в турі і записує квиток у файл квитків.
+   /// \details Місце резервується атомарно без глобального блокування;
+   /// квиток записується через BookingLedger, і виклик повертається після
+   /// фіксації його групи. Якщо квиток не вдалося записати, місце
+   /// повертається.
+   /// \param username Ім’я користувача, який бронює тур.
+   /// \param id Ідентифікатор туру.
+   /// \return Оформлений квиток, NotFound, SoldOut, InvalidArgument
+   /// (задовге ім'я користувача) або IoError. Поки на тур є черга
+   /// очікування, нові бронювання повертають SoldOut.
+   Result<Ticket> bookTour(const std::string& username, TourId id);
+
+   /// \brief Бронює тур з ключем ідемпотентності.
+   /// \details Повторний запит того самого користувача з тим самим ключем
+   /// не створює нового квитка, а повертає початковий. Ключі зберігаються
+   /// в пам'яті обмежений час (див. IdempotencyCache).
+   /// \param username Ім’я користувача, який бронює тур.
+   /// \param id Ідентифікатор туру.
+   /// \param idempotencyKey Ключ запиту; порожній ключ вимикає перевірку.
+   /// \param replayed Якщо не nullptr, отримує true для повторного запиту.
+   /// \return Квиток, NotFound, SoldOut, IoError або InvalidArgument, якщо
+   /// ключ уже використано для іншого туру.
+   Result<Ticket> bookTour(const std::string& username, TourId id,
+      const std::string& idempotencyKey, bool* replayed = nullptr);
+
+   /// \brief Бронює кілька турів або місць як одне ціле.
+   /// \details Або всі місця заброньовано, або жодне. Місця резервуються
+   /// через CAS у порядку зростання ідентифікаторів туру, а при нестачі
+   /// вже зарезервовані повертаються; усі квитки групи записуються одним
+   /// записом журналу. Однакові тури в items об'єднуються.
+   /// \param username Ім’я користувача, який бронює тури.
+   /// \param items Тури та кількість місць.
+   /// \return Квитки по одному на тур, NotFound, SoldOut, InvalidArgument
+   /// або IoError.
+   Result<std::vector<Ticket>> bookGroup(const std::string& username,
+      std::vector<BookingItem> items);
+
+   /// \brief Скасовує останній активний квиток користувача на тур.
+   /// \details Звільнені місця одразу пропонуються черзі очікування.
+   /// \param username Ім’я користувача.
+   /// \param id Ідентифікатор туру.
+   /// \return Скасований квиток, NotFound або IoError.
+   Result<Ticket> cancelBooking(const std::string& username, TourId id);
+
+   /// \brief Додає користувача в чергу очікування на тур.
+   /// \details Якщо місця є вже зараз, заявка одразу обслуговується.
+   /// \param username Ім’я користувача.
+   /// \param id Ідентифікатор туру.
+   /// \param seats Кількість потрібних місць.
+   /// \param priority Пріоритет; більший обслуговується раніше.
+   /// \return Заявка, NotFound, InvalidArgument або IoError.
+   Result<WaitlistEntry> joinWaitlist(const std::string& username, TourId id,
+      std::uint32_t seats = 1, int priority = 0);
+
+   /// \brief Вилучає користувача з черги очікування на тур.
+   /// \return Порожній результат, NotFound або IoError.
+   Result<void> leaveWaitlist(const std::string& username, TourId id);
+
+   /// \brief Повертає чергу очікування туру в порядку обслуговування.
+   std::vector<WaitlistEntry> waitlistFor(TourId id) const;
+
+   /// \brief Повертає позицію користувача в черзі туру (з 1) або 0.
+   std::size_t waitlistPosition(const std::string& username, TourId id) const;
+
+   /// \brief Перечитує сховище квитків з двійкового файлу.
+   /// \return Кількість квитків або IoError.
+   Result<std::size_t> loadTickets();
+
+   /// \brief Імпортує квитки з текстового tickets.txt у двійкове сховище.
+   /// \details Імпортовані квитки займають місця своїх турів, навіть якщо
+   /// місць не вистачає. Квитки, які вже є у сховищі, пропускаються, тож
+   /// повторний імпорт файлу нічого не змінює. Рядки старого формату без tourId зіставляються з туром
+   /// поточного каталогу за країною, містом і датами.
+   /// \param path Шлях до текстового файлу.
+   /// \return Кількість нових квитків, IoError або InvalidArgument.
+   Result<std::size_t> importTickets(const std::string& path);
+
+   /// \brief Повертає квитки користувача в порядку бронювання.
+   /// \details Дані туру беруться з поточного каталогу; для видаленого
+   /// туру вони порожні.
+   std::vector<Ticket> userTickets(const std::string& username) const;
+
+   /// \brief Повертає квитки, оформлені на тур.
+   std::vector<Ticket> tourTickets(TourId id) const;
+
+   /// \brief Повертає кількість місць туру, проданих за сховищем квитків.
+   std::uint64_t seatsSold(TourId id) const;
+
+   /// \brief Оцінює пам'ять, яку займає каталог і сховище квитків.
+   /// \details Обходить поточний знімок без блокування письменників і
+   /// підсумовує таблицю каталогу, об'єкти турів, блоки керування
+   /// shared_ptr, довгі рядкові поля, лічильники місць та індекси квитків.
+   /// Тури, які утримують лише старі знімки читачів, не враховуються.
+   /// \return Звіт за складовими та за типами турів.
+   MemoryReport memoryReport() const;
+
 private:
-   std::string                        dataFile;
-   std::vector<std::shared_ptr<Tour>> tours;
+   /// \brief Кількість турів на сторінці в консольних меню.
+   static constexpr std::size_t menuPageSize = 20;
+
+   /// \brief Запас номерів слотів понад кількість рядків файлу турів.
+   static constexpr std::size_t slotSlack = 1024;
+
+   std::string                            dataFile;
+   std::shared_ptr<const CatalogSnapshot> current;
+   std::atomic<std::uint64_t>             publishedVersion{0};
+   std::uint64_t                          instanceId = 0;
+   std::mutex                             writeMutex;
+   BookingLedger                          ledger;
+   TicketStore                            tickets;
+   IdempotencyCache                       bookingKeys;
+   Waitlist                               waitlist;
+   std::mutex                             promotionMutex;
+
+   /// \brief Повертає поточний знімок без зміни лічильника посилань.
+   /// \details Знімок кешується у потоці й оновлюється лише після
+   /// публікації нової версії, тож читачі не конкурують за спільний
+   /// лічильник. Посилання дійсне до наступного виклику в цьому потоці.
+   const CatalogSnapshot& pinSnapshot() const;
+
+   /// \brief Застосовує зміну до копії каталогу та публікує її.
+   /// \details Копія ділить з поточною версією незмінені блоки таблиці.
+   /// \param change Зміна; при помилці нова версія не публікується.
+   /// \return Результат зміни.
+   Result<void> commit(
+      const std::function<Result<void>(CatalogSnapshot::Tours&)>& change);
+
+   /// \brief Публікує нову версію каталогу; викликається під writeMutex.
+   /// \param tours Таблиця турів нової версії.
+   void publish(CatalogSnapshot::Tours tours);
+
+   /// \brief Записує квиток на вже зарезервовані місця.
+   /// \details Якщо запис не вдався, місця повертаються.
+   /// \param catalog Знімок, у якому існує тур.
+   /// \param inventory Лічильник, з якого зарезервовано місця.
+   /// \param username Ім’я користувача.
+   /// \param id Ідентифікатор туру.
+   /// \param seats Кількість зарезервованих місць.
+   /// \return Квиток або IoError.
+   Result<Ticket> issueTicket(const CatalogSnapshot& catalog,
+      SeatInventory& inventory,
+      const std::string& username,
+      TourId id,
+      std::uint32_t seats);
+
+   /// \brief Бронює місця для заявок з черги очікування, поки їх вистачає.
+   /// \param id Ідентифікатор туру.
+   /// \return Кількість обслужених заявок.
+   std::size_t promoteWaitlist(TourId id);
+
+   /// \brief Перетворює запис сховища на квиток з даними туру.
+   /// \param catalog Знімок, з якого беруться дані туру.
+   /// \param record Запис квитка.
+   static Ticket makeTicket(const CatalogSnapshot& catalog,
+      const TicketRecord& record);
 
    /// \brief Виводить у консоль усі тури з поточного списку.
    void displayAll() const;
 
+   /// \brief Виводить таблицю турів з указаними ідентифікаторами.
+   /// \details Форматуються лише рядки [first, first + count); таблиця
+   /// збирається в один буфер і виводиться одним записом.
+   /// \param catalog Знімок, у якому існують тури.
+   /// \param ids Ідентифікатори турів знімка.
+   /// \param first Перший рядок сторінки.
+   /// \param count Кількість рядків сторінки.
+   void printTours(const CatalogSnapshot& catalog,
+      const std::vector<TourId>& ids,
+      std::size_t first = 0,
+      std::size_t count = static_cast<std::size_t>(-1)) const;
+
+   /// \brief Показує результати запиту посторінково з навігацією.
+   /// \param query Критерій відбору.
+   /// \return false, якщо жодного туру не знайдено.
+   bool browse(const TourQuery& query) const;
+
    /// \brief Додає новий тур (міський або гірськолижний).
    void addTour();
 
@@ -63,20 +371,18 @@ private:
    /// \brief Відкриває меню фільтрації турів.
    void filterMenu() const;
 
-   /// \brief Редагує обраний тур за індексом.
+   /// \brief Редагує обраний тур за ідентифікатором.
    void editTour();
 
-   /// \brief Видаляє обраний тур за індексом.
+   /// \brief Видаляє обраний тур за ідентифікатором.
    void deleteTour();
 
-   /// \brief Перевіряє, чи входить дата у заданий діапазон.
-   /// \param date Дата для перевірки.
-   /// \param from Початок інтервалу (може бути порожнім).
-   /// \param to Кінець інтервалу (може бути порожнім).
-   /// \return true, якщо дата входить у діапазон або діапазон не заданий.
-   static bool dateInRange(const std::string& date,
-      const std::string& from,
-      const std::string& to);
+   /// \brief Зчитує з консолі ідентифікатор туру та шукає тур.
+   /// \param errorMessage Текст помилки для некоректного формату.
+   /// \return Ідентифікатор існуючого туру.
+   /// \throws ValidationException Якщо введено не число.
+   /// \throws NotFoundException Якщо туру з таким ідентифікатором немає.
+   TourId readTourId(const std::string& errorMessage) const;
 
    // Обгортки для меню користувача.
 
@@ -0,0 +1,40 @@
+// TourPatch.h
+#pragma once
+
+#include <optional>
+#include <string>
+
+/// \file TourPatch.h
+/// \brief Типізований набір змін полів туру для програмного API.
+
+/// \brief Вид туру.
+enum class TourKind
+{
+   City, ///< Міський тур (CityTour).
+   Ski   ///< Гірськолижний тур (SkiTour).
+};
+
+/// \struct TourPatch
+/// \brief Набір полів туру, які потрібно встановити.
+/// \details Незаповнені поля залишаються без змін. Поля, специфічні
+/// для іншого виду туру, вважаються помилкою.
+struct TourPatch
+{
+   std::optional<std::string> country;
+   std::optional<std::string> city;          ///< Місто або курорт.
+   std::optional<std::string> departureDate; ///< Формат YYYY-MM-DD.
+   std::optional<std::string> returnDate;    ///< Формат YYYY-MM-DD.
+   std::optional<std::string> hotelLevel;    ///< Рівень готелю або складність.
+   std::optional<double>      price;
+   std::optional<int>         capacity;      ///< Кількість місць; застосовує каталог, а не тур.
+
+   // Лише для міського туру.
+   std::optional<std::string> accommodation;
+   std::optional<std::string> transport;
+   std::optional<std::string> food;
+   std::optional<std::string> extras;
+
+   // Лише для гірськолижного туру.
+   std::optional<bool> equipmentIncluded;
+   std::optional<bool> insuranceIncluded;
+};
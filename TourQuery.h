@@ -0,0 +1,123 @@
+// TourQuery.h
+#pragma once
+
+#include "Tour.h"
+
+#include <string>
+
+/// \file TourQuery.h
+/// \brief Параметри пошуку та фільтрації турів для програмного API.
+
+/// \brief Критерій сортування каталогу.
+enum class SortKey
+{
+   Price,        ///< За ціною.
+   DepartureDate ///< За датою відправлення.
+};
+
+/// \struct TourQuery
+/// \brief Один критерій пошуку або фільтрації турів.
+struct TourQuery
+{
+   /// \brief Вид критерію.
+   enum class Kind
+   {
+      All,        ///< Усі тури.
+      Country,    ///< Точний збіг країни.
+      City,       ///< Точний збіг міста або курорту.
+      DateRange,  ///< Дата відправлення в межах [from, to].
+      HotelLevel, ///< Точний збіг рівня готелю або складності.
+      MaxPrice    ///< Ціна не більша за maxPrice.
+   };
+
+   Kind        kind = Kind::All;
+   std::string text;       ///< Значення для Country, City, HotelLevel.
+   std::string from;       ///< Початок інтервалу дат (може бути порожнім).
+   std::string to;         ///< Кінець інтервалу дат (може бути порожнім).
+   double      maxPrice = 0.0;
+
+   /// \brief Запит усіх турів.
+   static TourQuery all()
+   {
+      return TourQuery{};
+   }
+
+   /// \brief Пошук за країною.
+   static TourQuery byCountry(const std::string& country)
+   {
+      TourQuery q;
+      q.kind = Kind::Country;
+      q.text = country;
+      return q;
+   }
+
+   /// \brief Пошук за містом або курортом.
+   static TourQuery byCity(const std::string& city)
+   {
+      TourQuery q;
+      q.kind = Kind::City;
+      q.text = city;
+      return q;
+   }
+
+   /// \brief Пошук за інтервалом дат відправлення.
+   static TourQuery byDateRange(const std::string& from, const std::string& to)
+   {
+      TourQuery q;
+      q.kind = Kind::DateRange;
+      q.from = from;
+      q.to = to;
+      return q;
+   }
+
+   /// \brief Фільтр за рівнем готелю або складністю.
+   static TourQuery byHotelLevel(const std::string& level)
+   {
+      TourQuery q;
+      q.kind = Kind::HotelLevel;
+      q.text = level;
+      return q;
+   }
+
+   /// \brief Фільтр за максимальною ціною.
+   static TourQuery byMaxPrice(double maxPrice)
+   {
+      TourQuery q;
+      q.kind = Kind::MaxPrice;
+      q.maxPrice = maxPrice;
+      return q;
+   }
+
+   /// \brief Перевіряє, чи відповідає тур критерію.
+   /// \param tour Тур для перевірки.
+   /// \return true, якщо тур задовольняє запит.
+   bool matches(const Tour& tour) const
+   {
+      switch (kind)
+      {
+         case Kind::All:
+            return true;
+
+         case Kind::Country:
+            return tour.getCountry() == text;
+
+         case Kind::City:
+            return tour.getCity() == text;
+
+         case Kind::DateRange:
+         {
+            const std::string date = tour.getDepartureDate();
+            return (from.empty() || date >= from)
+                && (to.empty()   || date <= to);
+         }
+
+         case Kind::HotelLevel:
+            return tour.getHotelLevel() == text;
+
+         case Kind::MaxPrice:
+            return tour.getPrice() <= maxPrice;
+      }
+
+      return false;
+   }
+};
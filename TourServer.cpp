@@ -0,0 +1,579 @@
+// TourServer.cpp
+
+#include "TourServer.h"
+#include "BatchRunner.h"
+#include "ServerException.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/// \brief Стан однієї клієнтської сесії.
+struct TourServer::Connection
+{
+   Connection(int fd, TourManager& tourManager, const AuthManager& auth)
+      : fd(fd),
+        runner(tourManager, auth)
+   {
+   }
+
+   ~Connection()
+   {
+#ifdef __linux__
+      ::close(fd);
+#endif
+   }
+
+   const int   fd;
+   BatchRunner runner;      ///< Використовується лише потоком, що обробляє сесію.
+   std::string inBuffer;    ///< Лише для потоку циклу подій.
+
+   std::mutex              mutex;
+   std::deque<std::string> pending;        ///< Прийняті, але ще не виконані команди.
+   std::string             outBuffer;      ///< Невідправлені відповіді.
+   std::size_t             outOffset = 0;  ///< Скільки байтів outBuffer уже відправлено.
+   bool                    busy = false;   ///< Сесія вже стоїть у черзі пулу.
+   bool                    readClosed = false;
+   bool                    readPaused = false; ///< Черга повна; EPOLLIN вимкнено.
+   bool                    wantWrite = false;
+   bool                    broken = false;
+};
+
+TourServer::TourServer(TourManager& tourManager,
+   const AuthManager& auth,
+   ServerOptions options)
+   : tourManager(tourManager),
+     auth(auth),
+     options(std::move(options))
+{
+}
+
+#ifdef __linux__
+
+namespace
+{
+std::string lastError(const std::string& action)
+{
+   return action + ": " + std::strerror(errno);
+}
+
+/// Позначка задовгого рядка в черзі сесії. Справжній рядок команди не
+/// містить переносу, тож сплутати їх неможливо; відповідь про помилку
+/// йде після відповідей на всі попередні команди.
+const char* const tooLongMarker = "\n";
+}
+
+TourServer::~TourServer()
+{
+   connections.clear();
+
+   if (listenFd >= 0)
+   {
+      ::close(listenFd);
+      if (!options.unixPath.empty())
+      {
+         ::unlink(options.unixPath.c_str());
+      }
+   }
+
+   if (epollFd >= 0)
+   {
+      ::close(epollFd);
+   }
+
+   if (wakeFd >= 0)
+   {
+      ::close(wakeFd);
+   }
+}
+
+void TourServer::stop()
+{
+   stopRequested.store(true);
+
+   if (wakeFd >= 0)
+   {
+      const std::uint64_t one = 1;
+      const ssize_t written = ::write(wakeFd, &one, sizeof(one));
+      (void)written;
+   }
+}
+
+void TourServer::openListener()
+{
+   if (!options.unixPath.empty())
+   {
+      listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (listenFd < 0)
+      {
+         throw ServerException(lastError("socket"));
+      }
+
+      sockaddr_un address{};
+      address.sun_family = AF_UNIX;
+      if (options.unixPath.size() >= sizeof(address.sun_path))
+      {
+         throw ServerException("Задовгий шлях Unix-сокета: " + options.unixPath);
+      }
+      std::strncpy(address.sun_path, options.unixPath.c_str(),
+         sizeof(address.sun_path) - 1);
+
+      ::unlink(options.unixPath.c_str());
+      if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) < 0)
+      {
+         throw ServerException(lastError("bind " + options.unixPath));
+      }
+   }
+   else
+   {
+      listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (listenFd < 0)
+      {
+         throw ServerException(lastError("socket"));
+      }
+
+      const int reuse = 1;
+      ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+      sockaddr_in address{};
+      address.sin_family = AF_INET;
+      address.sin_port = htons(options.tcpPort);
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+      if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) < 0)
+      {
+         throw ServerException(
+            lastError("bind 127.0.0.1:" + std::to_string(options.tcpPort)));
+      }
+   }
+
+   if (::listen(listenFd, SOMAXCONN) < 0)
+   {
+      throw ServerException(lastError("listen"));
+   }
+}
+
+void TourServer::run()
+{
+   openListener();
+
+   epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+   wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if (epollFd < 0 || wakeFd < 0)
+   {
+      throw ServerException(lastError("epoll/eventfd"));
+   }
+
+   epoll_event event{};
+   event.events = EPOLLIN;
+   event.data.fd = listenFd;
+   ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+   event.data.fd = wakeFd;
+   ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+   std::size_t workers = options.workers;
+   if (workers == 0)
+   {
+      workers = std::max(1u, std::thread::hardware_concurrency());
+   }
+
+   ThreadPool pool(workers);
+   epoll_event events[256];
+
+   while (!stopRequested.load())
+   {
+      const int ready = ::epoll_wait(epollFd, events, 256, -1);
+      if (ready < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+         throw ServerException(lastError("epoll_wait"));
+      }
+
+      for (int i = 0; i < ready; ++i)
+      {
+         const int fd = events[i].data.fd;
+         const std::uint32_t flags = events[i].events;
+
+         if (fd == listenFd)
+         {
+            acceptClients();
+            continue;
+         }
+
+         if (fd == wakeFd)
+         {
+            std::uint64_t value = 0;
+            const ssize_t got = ::read(wakeFd, &value, sizeof(value));
+            (void)got;
+            continue;
+         }
+
+         auto found = connections.find(fd);
+         if (found == connections.end())
+         {
+            continue;
+         }
+
+         std::shared_ptr<Connection> connection = found->second;
+
+         if (flags & EPOLLIN)
+         {
+            readClient(connection, pool);
+         }
+
+         if (flags & EPOLLOUT)
+         {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            flushLocked(*connection);
+         }
+
+         bool finished = false;
+         {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            finished = connection->broken
+               || ((flags & (EPOLLHUP | EPOLLERR)) != 0)
+               || (connection->readClosed && !connection->busy
+                   && connection->outOffset == connection->outBuffer.size());
+         }
+
+         if (finished)
+         {
+            closeClient(fd);
+         }
+      }
+   }
+
+   connections.clear();
+}
+
+void TourServer::acceptClients()
+{
+   while (true)
+   {
+      const int fd = ::accept4(listenFd, nullptr, nullptr,
+         SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0)
+      {
+         // EAGAIN — черга очікування вичерпана; інші помилки стосуються
+         // лише одного з'єднання і не зупиняють сервер.
+         return;
+      }
+
+      auto connection = std::make_shared<Connection>(fd, tourManager, auth);
+
+      epoll_event event{};
+      event.events = EPOLLIN | EPOLLRDHUP;
+      event.data.fd = fd;
+      if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+      {
+         continue;
+      }
+
+      connections.emplace(fd, std::move(connection));
+      sessions.fetch_add(1, std::memory_order_relaxed);
+   }
+}
+
+void TourServer::readClient(const std::shared_ptr<Connection>& connection,
+   ThreadPool& pool)
+{
+   char chunk[16 * 1024];
+   std::deque<std::string> lines;
+   std::string& buffer = connection->inBuffer;
+   bool closed = false;
+   bool tooLong = false;
+   bool paused = false;
+
+   std::size_t queued = 0;
+   {
+      std::lock_guard<std::mutex> lock(connection->mutex);
+      queued = connection->pending.size();
+   }
+
+   while (true)
+   {
+      // Повна черга: решта даних лишається в сокеті, доки пул не
+      // розбере прийняті команди. Черга може перевищити ліміт не більше
+      // ніж на рядки одного прочитаного блоку.
+      if (queued + lines.size() >= options.maxPendingRequests)
+      {
+         paused = true;
+         break;
+      }
+
+      const ssize_t got = ::recv(connection->fd, chunk, sizeof(chunk), 0);
+      if (got > 0)
+      {
+         // Переноси шукаються лише в нових байтах.
+         const std::size_t scanned = buffer.size();
+         buffer.append(chunk, static_cast<std::size_t>(got));
+
+         std::size_t start = 0;
+         for (std::size_t end = buffer.find('\n', scanned);
+              end != std::string::npos;
+              end = buffer.find('\n', start))
+         {
+            if (end - start > options.maxLineLength)
+            {
+               tooLong = true;
+               break;
+            }
+
+            lines.emplace_back(buffer, start, end - start);
+            start = end + 1;
+         }
+         buffer.erase(0, start);
+
+         // Ліміт діє на байти після останнього переносу, а не на весь
+         // прочитаний обсяг: клієнт без переносів не може необмежено
+         // збільшувати буфер.
+         if (tooLong || buffer.size() > options.maxLineLength)
+         {
+            tooLong = true;
+            break;
+         }
+         continue;
+      }
+
+      if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+      {
+         closed = true;
+      }
+
+      if (got < 0 && errno == EINTR)
+      {
+         continue;
+      }
+      break;
+   }
+
+   if (tooLong)
+   {
+      buffer.clear();
+      buffer.shrink_to_fit();
+      closed = true;
+      paused = false;
+   }
+
+   bool schedule = false;
+   {
+      std::lock_guard<std::mutex> lock(connection->mutex);
+
+      for (auto& line : lines)
+      {
+         connection->pending.push_back(std::move(line));
+      }
+
+      if (tooLong)
+      {
+         connection->pending.push_back(tooLongMarker);
+      }
+
+      if (closed && !connection->readClosed)
+      {
+         connection->readClosed = true;
+         updateInterestLocked(*connection);
+      }
+      else if (paused && !connection->readPaused)
+      {
+         connection->readPaused = true;
+         updateInterestLocked(*connection);
+      }
+
+      if (!connection->pending.empty() && !connection->busy)
+      {
+         connection->busy = true;
+         schedule = true;
+      }
+   }
+
+   if (schedule)
+   {
+      pool.submit(
+         [this, connection]
+         {
+            processRequests(connection);
+         });
+   }
+}
+
+void TourServer::processRequests(const std::shared_ptr<Connection>& connection)
+{
+   std::ostringstream out;
+
+   while (true)
+   {
+      std::deque<std::string> batch;
+      {
+         std::lock_guard<std::mutex> lock(connection->mutex);
+
+         // Прапорець busy знімається під тим самим блокуванням, під яким
+         // цикл подій додає нові рядки, тому жоден рядок не загубиться.
+         if (connection->pending.empty())
+         {
+            connection->busy = false;
+
+            if (connection->readClosed
+                && connection->outOffset == connection->outBuffer.size())
+            {
+               // Клієнт закрив запис, відповіді надіслано: EPOLLHUP
+               // повідомить циклу подій, що з'єднання можна закрити.
+               ::shutdown(connection->fd, SHUT_RDWR);
+            }
+            return;
+         }
+
+         batch.swap(connection->pending);
+
+         // Черга звільнилася: читання призупиненої сесії відновлюється.
+         if (connection->readPaused)
+         {
+            connection->readPaused = false;
+            updateInterestLocked(*connection);
+         }
+      }
+
+      for (const auto& line : batch)
+      {
+         if (line == tooLongMarker)
+         {
+            out << "{\"ok\":false,\"error\":\"invalid_argument\","
+                   "\"message\":\"Задовгий рядок запиту.\"}\n";
+            continue;
+         }
+         connection->runner.execute(line, out);
+      }
+
+      const std::string responses = out.str();
+      out.str(std::string());
+
+      std::lock_guard<std::mutex> lock(connection->mutex);
+      connection->outBuffer += responses;
+      flushLocked(*connection);
+   }
+}
+
+void TourServer::flushLocked(Connection& connection)
+{
+   while (connection.outOffset < connection.outBuffer.size())
+   {
+      const ssize_t sent = ::send(connection.fd,
+         connection.outBuffer.data() + connection.outOffset,
+         connection.outBuffer.size() - connection.outOffset,
+         MSG_NOSIGNAL);
+
+      if (sent > 0)
+      {
+         connection.outOffset += static_cast<std::size_t>(sent);
+         continue;
+      }
+
+      if (sent < 0 && errno == EINTR)
+      {
+         continue;
+      }
+
+      if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+         if (connection.outBuffer.size() - connection.outOffset
+             > options.maxPendingOutput)
+         {
+            connection.broken = true;
+            ::shutdown(connection.fd, SHUT_RDWR);
+            return;
+         }
+
+         if (!connection.wantWrite)
+         {
+            connection.wantWrite = true;
+            updateInterestLocked(connection);
+         }
+         return;
+      }
+
+      connection.broken = true;
+      ::shutdown(connection.fd, SHUT_RDWR);
+      return;
+   }
+
+   connection.outBuffer.clear();
+   connection.outOffset = 0;
+
+   if (connection.wantWrite)
+   {
+      connection.wantWrite = false;
+      updateInterestLocked(connection);
+   }
+}
+
+void TourServer::updateInterestLocked(Connection& connection)
+{
+   epoll_event event{};
+   event.events = 0;
+   event.data.fd = connection.fd;
+
+   // Після закриття запису клієнтом EPOLLIN більше не відстежується,
+   // інакше рівневий epoll постійно повідомляв би про кінець потоку.
+   if (!connection.readClosed && !connection.readPaused)
+   {
+      event.events |= EPOLLIN | EPOLLRDHUP;
+   }
+
+   if (connection.wantWrite)
+   {
+      event.events |= EPOLLOUT;
+   }
+
+   ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void TourServer::closeClient(int fd)
+{
+   auto found = connections.find(fd);
+   if (found == connections.end())
+   {
+      return;
+   }
+
+   ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+   connections.erase(found);
+   sessions.fetch_sub(1, std::memory_order_relaxed);
+}
+
+#else
+
+TourServer::~TourServer() = default;
+
+void TourServer::stop()
+{
+   stopRequested.store(true);
+}
+
+void TourServer::run()
+{
+   throw ServerException("Серверний режим підтримується лише в Linux.");
+}
+
+#endif
@@ -0,0 +1,98 @@
+// TourServer.h
+#pragma once
+
+#include "AuthManager.h"
+#include "TourManager.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class ThreadPool;
+
+/// \file TourServer.h
+/// \brief Серверний режим: один спільний каталог для багатьох клієнтів.
+
+/// \brief Параметри серверного режиму.
+struct ServerOptions
+{
+   std::string   unixPath;            ///< Шлях Unix-сокета; якщо порожній, використовується TCP.
+   std::uint16_t tcpPort = 0;         ///< Порт на 127.0.0.1 для TCP.
+   std::size_t   workers = 0;         ///< Кількість робочих потоків; 0 — за кількістю ядер.
+   std::size_t   maxLineLength = 64 * 1024; ///< Максимальна довжина одного запиту.
+   std::size_t   maxPendingRequests = 1024; ///< Прийнятих, але не виконаних команд сесії, після яких читання призупиняється.
+   std::size_t   maxPendingOutput = 16 * 1024 * 1024; ///< Ліміт невідправлених відповідей.
+};
+
+/// \class TourServer
+/// \brief Обслуговує клієнтів через Unix-сокет або localhost TCP.
+/// \details Протокол рядковий і збігається з пакетним режимом (BatchRunner):
+/// кожен рядок — команда, на кожну команду сервер відповідає одним рядком
+/// JSON. Кожне з'єднання — окрема сесія зі своїм входом користувача.
+///
+/// Один потік обслуговує epoll-цикл (прийом з'єднань, читання, дозапис
+/// відповідей), а команди виконуються в пулі робочих потоків. Команди
+/// однієї сесії виконуються послідовно і в порядку надходження, різні
+/// сесії — паралельно над спільним TourManager.
+///
+/// Пам'ять сесії обмежена: незавершений рядок довший за maxLineLength
+/// закриває сесію, а коли в черзі сесії накопичується maxPendingRequests
+/// команд, сервер перестає читати її сокет, доки пул не розбере чергу
+/// (клієнт відчуває це як зворотний тиск TCP).
+class TourServer
+{
+public:
+   /// \brief Створює сервер над спільним каталогом.
+   /// \param tourManager Каталог турів, спільний для всіх сесій.
+   /// \param auth Менеджер користувачів для перевірки входу.
+   /// \param options Параметри сервера.
+   TourServer(TourManager& tourManager,
+      const AuthManager& auth,
+      ServerOptions options);
+
+   /// \brief Закриває сокети сервера.
+   ~TourServer();
+
+   TourServer(const TourServer&) = delete;
+   TourServer& operator=(const TourServer&) = delete;
+
+   /// \brief Запускає цикл обробки подій і блокується до виклику stop().
+   /// \throws ServerException Якщо сокет не вдається створити або прив'язати.
+   void run();
+
+   /// \brief Просить сервер зупинитися.
+   /// \details Безпечний для виклику з іншого потоку та з обробника сигналу.
+   void stop();
+
+   /// \brief Повертає кількість відкритих сесій.
+   std::size_t sessionCount() const
+   {
+      return sessions.load(std::memory_order_relaxed);
+   }
+
+private:
+   struct Connection;
+
+   TourManager&             tourManager;
+   const AuthManager&       auth;
+   ServerOptions            options;
+   int                      listenFd = -1;
+   int                      epollFd = -1;
+   int                      wakeFd = -1;
+   std::atomic<bool>        stopRequested{false};
+   std::atomic<std::size_t> sessions{0};
+
+   std::unordered_map<int, std::shared_ptr<Connection>> connections;
+
+   void openListener();
+   void acceptClients();
+   void readClient(const std::shared_ptr<Connection>& connection,
+      ThreadPool& pool);
+   void closeClient(int fd);
+   void processRequests(const std::shared_ptr<Connection>& connection);
+   void flushLocked(Connection& connection);
+   void updateInterestLocked(Connection& connection);
+};
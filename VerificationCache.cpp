@@ -0,0 +1,68 @@
+// VerificationCache.cpp
+
+#include "VerificationCache.h"
+
+VerificationCache::VerificationCache(std::size_t capacity,
+   std::chrono::seconds ttl)
+   : capacity(capacity),
+     ttl(ttl)
+{
+}
+
+bool VerificationCache::contains(const std::string& token,
+   const std::string& stored)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   auto found = entries.find(token);
+   if (found == entries.end())
+   {
+      return false;
+   }
+
+   if (found->second.expires <= Clock::now() || found->second.stored != stored)
+   {
+      recent.erase(found->second.position);
+      entries.erase(found);
+      return false;
+   }
+
+   recent.splice(recent.begin(), recent, found->second.position);
+   return true;
+}
+
+void VerificationCache::remember(const std::string& token,
+   const std::string& stored)
+{
+   if (capacity == 0)
+   {
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock(mutex);
+   const Clock::time_point expires = Clock::now() + ttl;
+
+   auto found = entries.find(token);
+   if (found != entries.end())
+   {
+      found->second.stored = stored;
+      found->second.expires = expires;
+      recent.splice(recent.begin(), recent, found->second.position);
+      return;
+   }
+
+   while (entries.size() >= capacity)
+   {
+      entries.erase(recent.back());
+      recent.pop_back();
+   }
+
+   recent.push_front(token);
+   entries.emplace(token, Entry{stored, expires, recent.begin()});
+}
+
+std::size_t VerificationCache::size() const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   return entries.size();
+}
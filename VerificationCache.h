@@ -0,0 +1,62 @@
+// VerificationCache.h
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// \file VerificationCache.h
+/// \brief Кеш нещодавно перевірених облікових даних.
+
+/// \class VerificationCache
+/// \brief Пам'ятає токени успішних входів, щоб не перераховувати хеш пароля.
+/// \details Токен — HMAC від логіна й пароля з секретом процесу, тож у кеші
+/// немає ні паролів, ні придатних для перебору хешів. Разом з токеном
+/// зберігається поле пароля, проти якого його перевірено: після зміни
+/// пароля чи видалення користувача запис просто перестає збігатися.
+///
+/// Розмір обмежений capacity (найдавніше використані витісняються), а запис
+/// забувається через ttl після перевірки.
+class VerificationCache
+{
+public:
+   /// \brief Створює кеш.
+   /// \param capacity Максимальна кількість токенів.
+   /// \param ttl Скільки довіряти перевіреному токену.
+   explicit VerificationCache(std::size_t capacity = 4096,
+      std::chrono::seconds ttl = std::chrono::minutes(10));
+
+   /// \brief Перевіряє, чи токен нещодавно перевірено проти того самого запису.
+   /// \param token Токен облікових даних.
+   /// \param stored Поточне поле пароля користувача.
+   /// \return true, якщо повторна перевірка пароля не потрібна.
+   bool contains(const std::string& token, const std::string& stored);
+
+   /// \brief Запам'ятовує успішно перевірений токен.
+   /// \param token Токен облікових даних.
+   /// \param stored Поле пароля, проти якого виконано перевірку.
+   void remember(const std::string& token, const std::string& stored);
+
+   /// \brief Повертає кількість токенів у кеші.
+   std::size_t size() const;
+
+private:
+   using Clock = std::chrono::steady_clock;
+   using Order = std::list<std::string>;
+
+   struct Entry
+   {
+      std::string       stored;
+      Clock::time_point expires;
+      Order::iterator   position;
+   };
+
+   std::size_t                            capacity;
+   std::chrono::seconds                   ttl;
+   mutable std::mutex                     mutex;
+   std::unordered_map<std::string, Entry> entries;
+   Order                                  recent; ///< Від найсвіжішого до найдавнішого.
+};
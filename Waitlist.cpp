@@ -0,0 +1,330 @@
+// Waitlist.cpp
+
+#include "Waitlist.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+std::string joinLine(const WaitlistEntry& entry)
+{
+   return "join," + std::to_string(entry.tourId) + ','
+      + entry.username + ',' + std::to_string(entry.seats) + ','
+      + std::to_string(entry.priority) + '\n';
+}
+}
+
+Waitlist::Waitlist(std::string path)
+   : logPath(std::move(path))
+{
+}
+
+Waitlist::~Waitlist()
+{
+   if (log != nullptr)
+   {
+      std::fclose(log);
+   }
+}
+
+Result<std::size_t> Waitlist::load()
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   tours.clear();
+   nextSequence = 1;
+   waiting.store(0, std::memory_order_release);
+
+   std::ifstream file(logPath);
+   std::string line;
+
+   while (file && std::getline(file, line))
+   {
+      if (!line.empty() && line.back() == '\r')
+      {
+         line.pop_back();
+      }
+
+      std::istringstream iss(line);
+      std::string action;
+      std::string tourText;
+      WaitlistEntry entry;
+
+      if (!std::getline(iss, action, ',')
+          || !std::getline(iss, tourText, ',')
+          || !std::getline(iss, entry.username, ','))
+      {
+         continue;
+      }
+
+      try
+      {
+         entry.tourId = static_cast<SlotId>(std::stoull(tourText));
+
+         if (action == "join")
+         {
+            std::string seatsText;
+            std::string priorityText;
+            std::getline(iss, seatsText, ',');
+            std::getline(iss, priorityText, ',');
+
+            entry.seats = static_cast<std::uint32_t>(std::stoul(seatsText));
+            entry.priority = std::stoi(priorityText);
+            insertLocked(std::move(entry));
+         }
+         else if (action == "leave")
+         {
+            eraseLocked(entry.username, entry.tourId);
+         }
+      }
+      catch (...)
+      {
+         // Пошкоджений рядок (наприклад, обірваний під час збою) пропускається.
+      }
+   }
+   file.close();
+
+   if (!compactLocked())
+   {
+      return Error{ErrorCode::IoError,
+         "Не вдалося переписати журнал черг очікування: " + logPath};
+   }
+
+   return waiting.load(std::memory_order_relaxed);
+}
+
+Result<WaitlistEntry> Waitlist::join(const std::string& username,
+   SlotId tourId,
+   std::uint32_t seats,
+   int priority)
+{
+   if (seats == 0 || username.empty()
+       || username.find_first_of(",\n") != std::string::npos)
+   {
+      return Error{ErrorCode::InvalidArgument, "Некоректна заявка в чергу."};
+   }
+
+   std::lock_guard<std::mutex> lock(mutex);
+
+   WaitlistEntry entry;
+   entry.username = username;
+   entry.tourId = tourId;
+   entry.seats = seats;
+   entry.priority = priority;
+   entry.sequence = nextSequence;
+
+   if (!insertLocked(entry))
+   {
+      return Error{ErrorCode::InvalidArgument,
+         "Користувач уже в черзі очікування на цей тур."};
+   }
+
+   if (!appendLocked(joinLine(entry)))
+   {
+      eraseLocked(username, tourId);
+      return Error{ErrorCode::IoError,
+         "Помилка запису у файл " + logPath + "."};
+   }
+
+   return entry;
+}
+
+Result<void> Waitlist::leave(const std::string& username, SlotId tourId)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   auto found = tours.find(tourId);
+   if (found == tours.end() || found->second.byUser.count(username) == 0)
+   {
+      return Error{ErrorCode::NotFound,
+         "Користувача немає в черзі очікування на цей тур."};
+   }
+
+   // Спершу журнал: якщо запис не вдався, заявка лишається і в пам'яті,
+   // і після перезапуску, а не зникає лише до наступного відтворення.
+   if (!appendLocked("leave," + std::to_string(tourId) + ',' + username + '\n'))
+   {
+      return Error{ErrorCode::IoError,
+         "Помилка запису у файл " + logPath + "."};
+   }
+
+   eraseLocked(username, tourId);
+   return {};
+}
+
+std::optional<WaitlistEntry> Waitlist::front(SlotId tourId) const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   auto found = tours.find(tourId);
+   if (found == tours.end() || found->second.queue.empty())
+   {
+      return std::nullopt;
+   }
+
+   return found->second.queue.begin()->second;
+}
+
+std::size_t Waitlist::position(const std::string& username, SlotId tourId) const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   auto found = tours.find(tourId);
+   if (found == tours.end())
+   {
+      return 0;
+   }
+
+   auto user = found->second.byUser.find(username);
+   if (user == found->second.byUser.end())
+   {
+      return 0;
+   }
+
+   const auto& queue = found->second.queue;
+   return static_cast<std::size_t>(
+      std::distance(queue.begin(), queue.find(user->second))) + 1;
+}
+
+std::vector<WaitlistEntry> Waitlist::entries(SlotId tourId) const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   std::vector<WaitlistEntry> result;
+   auto found = tours.find(tourId);
+   if (found != tours.end())
+   {
+      result.reserve(found->second.queue.size());
+      for (const auto& item : found->second.queue)
+      {
+         result.push_back(item.second);
+      }
+   }
+
+   return result;
+}
+
+std::size_t Waitlist::size(SlotId tourId) const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+
+   auto found = tours.find(tourId);
+   return found == tours.end() ? 0 : found->second.queue.size();
+}
+
+bool Waitlist::insertLocked(WaitlistEntry entry)
+{
+   TourQueue& tour = tours[entry.tourId];
+   if (tour.byUser.count(entry.username) != 0)
+   {
+      return false;
+   }
+
+   entry.sequence = nextSequence++;
+   const Order order{entry.priority, entry.sequence};
+
+   tour.byUser.emplace(entry.username, order);
+   tour.queue.emplace(order, std::move(entry));
+   waiting.fetch_add(1, std::memory_order_acq_rel);
+   return true;
+}
+
+bool Waitlist::eraseLocked(const std::string& username, SlotId tourId)
+{
+   auto found = tours.find(tourId);
+   if (found == tours.end())
+   {
+      return false;
+   }
+
+   TourQueue& tour = found->second;
+   auto user = tour.byUser.find(username);
+   if (user == tour.byUser.end())
+   {
+      return false;
+   }
+
+   tour.queue.erase(user->second);
+   tour.byUser.erase(user);
+   waiting.fetch_sub(1, std::memory_order_acq_rel);
+
+   if (tour.queue.empty())
+   {
+      tours.erase(found);
+   }
+
+   return true;
+}
+
+bool Waitlist::appendLocked(const std::string& line)
+{
+   if (log == nullptr)
+   {
+      log = std::fopen(logPath.c_str(), "ab");
+      if (log == nullptr)
+      {
+         return false;
+      }
+   }
+
+   return std::fwrite(line.data(), 1, line.size(), log) == line.size()
+      && std::fflush(log) == 0;
+}
+
+bool Waitlist::compactLocked()
+{
+   if (log != nullptr)
+   {
+      std::fclose(log);
+      log = nullptr;
+   }
+
+   // Новий журнал пишеться поруч і атомарно замінює старий через rename,
+   // тож збій під час стиснення не втрачає жодної заявки.
+   const std::string tempPath = logPath + ".tmp";
+   std::FILE* out = std::fopen(tempPath.c_str(), "wb");
+   if (out == nullptr)
+   {
+      return false;
+   }
+
+   std::vector<const WaitlistEntry*> ordered;
+   ordered.reserve(waiting.load(std::memory_order_relaxed));
+   for (const auto& tour : tours)
+   {
+      for (const auto& item : tour.second.queue)
+      {
+         ordered.push_back(&item.second);
+      }
+   }
+
+   // Порядок рядків задає порядок надходження після відтворення.
+   std::sort(ordered.begin(), ordered.end(),
+      [](const WaitlistEntry* a, const WaitlistEntry* b)
+      {
+         return a->sequence < b->sequence;
+      });
+
+   bool ok = true;
+   for (const WaitlistEntry* entry : ordered)
+   {
+      const std::string line = joinLine(*entry);
+      ok = ok && std::fwrite(line.data(), 1, line.size(), out) == line.size();
+   }
+
+   ok = std::fclose(out) == 0 && ok;
+   if (!ok)
+   {
+      std::remove(tempPath.c_str());
+      return false;
+   }
+
+#ifdef _WIN32
+   std::remove(logPath.c_str());
+#endif
+   return std::rename(tempPath.c_str(), logPath.c_str()) == 0;
+}
@@ -0,0 +1,125 @@
+// Waitlist.h
+#pragma once
+
+#include "Result.h"
+#include "SlotMap.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// \file Waitlist.h
+/// \brief Черги очікування на розпродані тури.
+
+/// \brief Заявка в черзі очікування.
+struct WaitlistEntry
+{
+   std::string   username;
+   SlotId        tourId = 0;
+   std::uint32_t seats = 1;
+   int           priority = 0;  ///< Більший пріоритет обслуговується раніше.
+   std::uint64_t sequence = 0;  ///< Порядок надходження серед рівних пріоритетів.
+};
+
+/// \class Waitlist
+/// \brief Черги очікування для всіх турів.
+/// \details Для кожного туру заявки впорядковані за пріоритетом, а
+/// серед рівних — за часом надходження. Додавання, вилучення і пошук
+/// першої заявки — O(log n) навіть для тисяч заявок на популярний тур;
+/// один користувач має не більше однієї заявки на тур.
+///
+/// Зміни дописуються в текстовий журнал (`join,...` / `leave,...`), який
+/// під час load() відтворюється і стискається до поточного стану.
+class Waitlist
+{
+public:
+   /// \brief Створює порожні черги з журналом за вказаним шляхом.
+   /// \param path Шлях до файлу журналу черг.
+   explicit Waitlist(std::string path);
+
+   /// \brief Закриває журнал.
+   ~Waitlist();
+
+   Waitlist(const Waitlist&) = delete;
+   Waitlist& operator=(const Waitlist&) = delete;
+
+   /// \brief Відновлює черги з журналу і переписує його стиснутим.
+   /// \details Відсутній журнал означає порожні черги.
+   /// \return Кількість заявок або IoError.
+   Result<std::size_t> load();
+
+   /// \brief Додає заявку в чергу туру.
+   /// \return Заявка з призначеним порядковим номером, InvalidArgument
+   /// (користувач уже в черзі) або IoError.
+   Result<WaitlistEntry> join(const std::string& username,
+      SlotId tourId,
+      std::uint32_t seats,
+      int priority);
+
+   /// \brief Вилучає заявку користувача з черги туру.
+   /// \details Заявка вилучається лише після запису в журнал; при IoError
+   /// вона лишається в черзі.
+   /// \return Порожній результат, NotFound або IoError.
+   Result<void> leave(const std::string& username, SlotId tourId);
+
+   /// \brief Повертає першу заявку в черзі туру.
+   std::optional<WaitlistEntry> front(SlotId tourId) const;
+
+   /// \brief Повертає позицію користувача в черзі туру (з 1) або 0.
+   std::size_t position(const std::string& username, SlotId tourId) const;
+
+   /// \brief Повертає заявки туру в порядку обслуговування.
+   std::vector<WaitlistEntry> entries(SlotId tourId) const;
+
+   /// \brief Повертає кількість заявок у черзі туру.
+   std::size_t size(SlotId tourId) const;
+
+   /// \brief Повертає true, якщо в жодній черзі немає заявок.
+   /// \details Не блокує; призначено для швидкої перевірки при бронюванні.
+   bool empty() const
+   {
+      return waiting.load(std::memory_order_acquire) == 0;
+   }
+
+private:
+   /// \brief Ключ порядку обслуговування в межах туру.
+   struct Order
+   {
+      int           priority;
+      std::uint64_t sequence;
+
+      bool operator<(const Order& other) const
+      {
+         if (priority != other.priority)
+         {
+            return priority > other.priority;
+         }
+         return sequence < other.sequence;
+      }
+   };
+
+   struct TourQueue
+   {
+      std::map<Order, WaitlistEntry>         queue;
+      std::unordered_map<std::string, Order> byUser;
+   };
+
+   std::string                           logPath;
+   std::FILE*                            log = nullptr;
+   mutable std::mutex                    mutex;
+   std::unordered_map<SlotId, TourQueue> tours;
+   std::uint64_t                         nextSequence = 1;
+   std::atomic<std::size_t>              waiting{0};
+
+   bool insertLocked(WaitlistEntry entry);
+   bool eraseLocked(const std::string& username, SlotId tourId);
+   bool appendLocked(const std::string& line);
+   bool compactLocked();
+};
@@ -1,15 +1,29 @@
 /// \file main.cpp
 /// \brief Точка входу до програми «Довідник туриста».
 
+#include <algorithm>
+#include <csignal>
+#include <fstream>
 #include <iostream>
 #include <locale>
 #include <limits>
+#include <memory>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <cctype>
 #include <string>
 
 #include "AuthManager.h"
+#include "BatchRunner.h"
+#include "Benchmark.h"
+#include "DataGenerator.h"
+#include "LoadGenerator.h"
+#include "ServerException.h"
+#include "SessionLog.h"
+#include "SessionReplay.h"
 #include "TourManager.h"
+#include "TourServer.h"
 #include "ValidationException.h"
 #include "FileException.h"
 
@@ -61,16 +75,590 @@ bool readStrictInt(int& value)
 
    return true;
 }
+
+int runBatch(const std::string& scriptPath)
+{
+   std::ios::sync_with_stdio(false);
+
+   AuthManager auth("data/users.txt");
+   TourManager tourManager("data/tours.csv");
+
+   try
+   {
+      tourManager.load();
+   }
+   catch (const FileException& ex)
+   {
+      std::cerr << ex.what() << "\n";
+   }
+
+   BatchRunner runner(tourManager, auth);
+   std::size_t failures = 0;
+
+   if (scriptPath == "-")
+   {
+      failures = runner.run(std::cin, std::cout);
+   }
+   else
+   {
+      std::ifstream script(scriptPath);
+      if (!script)
+      {
+         std::cerr << FileException(
+            "Не вдалося відкрити сценарій: " + scriptPath).what() << "\n";
+         return 1;
+      }
+
+      failures = runner.run(script, std::cout);
+   }
+
+   return failures == 0 ? 0 : 2;
 }
 
-/// \brief Головна функція, що запускає застосунок.
-/// \return Код завершення програми.
-int main()
+bool parseGeneratorOptions(int argc, char* argv[], GeneratorOptions& options)
 {
-   SetConsoleCP(CP_UTF8);
-   SetConsoleOutputCP(CP_UTF8);
-   std::setlocale(LC_ALL, ".UTF8");
+   options.directory = argv[2];
+
+   for (int i = 3; i < argc; ++i)
+   {
+      const std::string arg = argv[i];
+      const std::size_t eq = arg.find('=');
+      if (eq == std::string::npos)
+      {
+         return false;
+      }
+
+      const std::string key = arg.substr(0, eq);
+      const std::string value = arg.substr(eq + 1);
+
+      try
+      {
+         std::size_t used = 0;
+
+         if (key == "dirty" || key == "skew" || key == "ski")
+         {
+            const double number = std::stod(value, &used);
+            if (used != value.size() || number < 0.0
+                || (key != "skew" && number > 1.0))
+            {
+               return false;
+            }
+
+            (key == "dirty" ? options.dirtyRate
+               : key == "skew" ? options.skew : options.skiShare) = number;
+            continue;
+         }
+
+         if (value.empty() || value[0] == '-')
+         {
+            return false;
+         }
+
+         const unsigned long long number = std::stoull(value, &used);
+         if (used != value.size())
+         {
+            return false;
+         }
+
+         if (key == "tours")
+         {
+            options.tours = static_cast<std::size_t>(number);
+         }
+         else if (key == "users")
+         {
+            options.users = static_cast<std::size_t>(number);
+         }
+         else if (key == "tickets")
+         {
+            options.tickets = static_cast<std::size_t>(number);
+         }
+         else if (key == "sessions")
+         {
+            options.sessions = static_cast<std::size_t>(number);
+         }
+         else if (key == "length")
+         {
+            options.sessionLength = static_cast<std::size_t>(number);
+         }
+         else if (key == "seed")
+         {
+            options.seed = number;
+         }
+         else
+         {
+            return false;
+         }
+      }
+      catch (...)
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+int runGenerator(const GeneratorOptions& options)
+{
+   try
+   {
+      const GeneratorReport report = DataGenerator(options).run();
+
+      std::cout << "Згенеровано в " << options.directory << ": турів "
+                << report.tours << ", користувачів " << report.users
+                << ", квитків " << report.tickets << ", команд "
+                << report.commands << ", зіпсованих рядків "
+                << report.dirtyRows << ".\n";
+   }
+   catch (const FileException& ex)
+   {
+      std::cerr << ex.what() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
+
+bool parseBenchOptions(int argc, char* argv[], BenchOptions& options)
+{
+   for (int i = 2; i < argc; ++i)
+   {
+      const std::string arg = argv[i];
+      const std::size_t eq = arg.find('=');
+      if (eq == std::string::npos)
+      {
+         return false;
+      }
+
+      const std::string key = arg.substr(0, eq);
+      const std::string value = arg.substr(eq + 1);
+
+      try
+      {
+         std::size_t used = 0;
+
+         if (key == "dir" && !value.empty())
+         {
+            options.directory = value;
+         }
+         else if (key == "filter")
+         {
+            options.filter = value;
+         }
+         else if (key == "sizes")
+         {
+            options.sizes.clear();
+
+            std::size_t start = 0;
+            while (start <= value.size())
+            {
+               std::size_t comma = value.find(',', start);
+               if (comma == std::string::npos)
+               {
+                  comma = value.size();
+               }
+
+               const std::string item = value.substr(start, comma - start);
+               if (item.empty() || item[0] == '-')
+               {
+                  return false;
+               }
+
+               options.sizes.push_back(
+                  static_cast<std::size_t>(std::stoull(item, &used)));
+               if (used != item.size() || options.sizes.back() == 0)
+               {
+                  return false;
+               }
+
+               start = comma + 1;
+            }
+         }
+         else if (key == "time")
+         {
+            options.secondsPerCase = std::stod(value, &used);
+            if (used != value.size() || options.secondsPerCase < 0.0)
+            {
+               return false;
+            }
+         }
+         else if (key == "seed" || key == "samples")
+         {
+            if (value.empty() || value[0] == '-')
+            {
+               return false;
+            }
+
+            const unsigned long long number = std::stoull(value, &used);
+            if (used != value.size())
+            {
+               return false;
+            }
+
+            if (key == "seed")
+            {
+               options.seed = number;
+            }
+            else
+            {
+               options.minSamples =
+                  std::max<std::size_t>(static_cast<std::size_t>(number), 1);
+            }
+         }
+         else
+         {
+            return false;
+         }
+      }
+      catch (...)
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+int runBenchmark(const BenchOptions& options)
+{
+   try
+   {
+      Benchmark(options).run(std::cout);
+   }
+   catch (const FileException& ex)
+   {
+      std::cerr << ex.what() << "\n";
+      return 1;
+   }
+   catch (const std::exception& ex)
+   {
+      std::cerr << ex.what() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
+
+bool parseSpeed(const std::string& value, double& speed)
+{
+   if (value == "max")
+   {
+      speed = 0.0;
+      return true;
+   }
 
+   try
+   {
+      std::size_t used = 0;
+      speed = std::stod(value, &used);
+      return used == value.size() && speed > 0.0;
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool parseReplayOptions(int argc, char* argv[], ReplayOptions& options)
+{
+   for (int i = 2; i < argc; ++i)
+   {
+      const std::string arg = argv[i];
+      const std::size_t eq = arg.find('=');
+      if (eq == std::string::npos)
+      {
+         options.sessions.push_back(arg);
+         continue;
+      }
+
+      const std::string key = arg.substr(0, eq);
+      const std::string value = arg.substr(eq + 1);
+
+      if (key == "speed")
+      {
+         if (!parseSpeed(value, options.speed))
+         {
+            return false;
+         }
+      }
+      else if (key == "dir" && !value.empty())
+      {
+         options.directory = value;
+      }
+      else if (key == "data" && !value.empty())
+      {
+         options.dataDirectory = value;
+      }
+      else if (key == "parallel" || key == "repeat")
+      {
+         if (value.empty() || value[0] == '-')
+         {
+            return false;
+         }
+
+         try
+         {
+            std::size_t used = 0;
+            const unsigned long long number = std::stoull(value, &used);
+            if (used != value.size() || number == 0)
+            {
+               return false;
+            }
+
+            (key == "parallel" ? options.parallel : options.repeat) =
+               static_cast<std::size_t>(number);
+         }
+         catch (...)
+         {
+            return false;
+         }
+      }
+      else
+      {
+         return false;
+      }
+   }
+
+   return !options.sessions.empty();
+}
+
+int runReplay(const ReplayOptions& options)
+{
+   try
+   {
+      return SessionReplay(options).run(std::cout) == 0 ? 0 : 1;
+   }
+   catch (const FileException& ex)
+   {
+      std::cerr << ex.what() << "\n";
+      return 1;
+   }
+}
+
+bool parseLoadOptions(int argc, char* argv[], LoadOptions& options)
+{
+   for (int i = 2; i < argc; ++i)
+   {
+      const std::string arg = argv[i];
+      const std::size_t eq = arg.find('=');
+      if (eq == std::string::npos)
+      {
+         return false;
+      }
+
+      const std::string key = arg.substr(0, eq);
+      const std::string value = arg.substr(eq + 1);
+
+      try
+      {
+         std::size_t used = 0;
+
+         if (key == "dir" && !value.empty())
+         {
+            options.directory = value;
+         }
+         else if (key == "sync")
+         {
+            if (value == "batch")
+            {
+               options.sync = SyncPolicy::EveryBatch;
+            }
+            else if (value == "interval")
+            {
+               options.sync = SyncPolicy::Interval;
+            }
+            else if (value == "never")
+            {
+               options.sync = SyncPolicy::Never;
+            }
+            else
+            {
+               return false;
+            }
+         }
+         else if (key == "time" || key == "rate" || key == "skew")
+         {
+            const double number = std::stod(value, &used);
+            if (used != value.size() || number < 0.0)
+            {
+               return false;
+            }
+
+            (key == "time" ? options.seconds
+               : key == "rate" ? options.rate : options.skew) = number;
+         }
+         else
+         {
+            if (value.empty() || value[0] == '-')
+            {
+               return false;
+            }
+
+            const unsigned long long number = std::stoull(value, &used);
+            if (used != value.size())
+            {
+               return false;
+            }
+
+            unsigned* weight = key == "query" ? &options.query
+               : key == "filter" ? &options.filter
+               : key == "get" ? &options.get
+               : key == "sort" ? &options.sort
+               : key == "edit" ? &options.edit
+               : key == "book" ? &options.book
+               : nullptr;
+
+            if (weight != nullptr)
+            {
+               *weight = static_cast<unsigned>(std::min<unsigned long long>(
+                  number, 1000000));
+            }
+            else if (key == "tours" && number != 0)
+            {
+               options.tours = static_cast<std::size_t>(number);
+            }
+            else if (key == "threads" && number != 0)
+            {
+               options.threads = static_cast<std::size_t>(number);
+            }
+            else if (key == "seed")
+            {
+               options.seed = number;
+            }
+            else
+            {
+               return false;
+            }
+         }
+      }
+      catch (...)
+      {
+         return false;
+      }
+   }
+
+   return options.query + options.filter + options.get + options.sort
+      + options.edit + options.book != 0;
+}
+
+int runLoad(const LoadOptions& options)
+{
+   try
+   {
+      return LoadGenerator(options).run(std::cout) == 0 ? 0 : 1;
+   }
+   catch (const std::exception& ex)
+   {
+      std::cerr << ex.what() << "\n";
+      return 1;
+   }
+}
+
+TourServer* activeServer = nullptr;
+
+void onStopSignal(int)
+{
+   if (activeServer != nullptr)
+   {
+      activeServer->stop();
+   }
+}
+
+bool parseServerOptions(int argc, char* argv[], ServerOptions& options)
+{
+   const std::string endpoint = argv[2];
+
+   if (endpoint.rfind("unix:", 0) == 0 && endpoint.size() > 5)
+   {
+      options.unixPath = endpoint.substr(5);
+   }
+   else if (endpoint.rfind("tcp:", 0) == 0)
+   {
+      try
+      {
+         const int port = std::stoi(endpoint.substr(4));
+         if (port <= 0 || port > 65535)
+         {
+            return false;
+         }
+         options.tcpPort = static_cast<std::uint16_t>(port);
+      }
+      catch (...)
+      {
+         return false;
+      }
+   }
+   else
+   {
+      return false;
+   }
+
+   if (argc == 5 && std::string(argv[3]) == "--workers")
+   {
+      try
+      {
+         const int workers = std::stoi(argv[4]);
+         if (workers <= 0)
+         {
+            return false;
+         }
+         options.workers = static_cast<std::size_t>(workers);
+      }
+      catch (...)
+      {
+         return false;
+      }
+   }
+   else if (argc != 3)
+   {
+      return false;
+   }
+
+   return true;
+}
+
+int runServer(const ServerOptions& options)
+{
+   AuthManager auth("data/users.txt");
+   TourManager tourManager("data/tours.csv");
+
+   try
+   {
+      tourManager.load();
+   }
+   catch (const FileException& ex)
+   {
+      std::cerr << ex.what() << "\n";
+   }
+
+   try
+   {
+      TourServer server(tourManager, auth, options);
+
+      activeServer = &server;
+      std::signal(SIGINT, onStopSignal);
+      std::signal(SIGTERM, onStopSignal);
+
+      server.run();
+
+      std::signal(SIGINT, SIG_DFL);
+      std::signal(SIGTERM, SIG_DFL);
+      activeServer = nullptr;
+   }
+   catch (const ServerException& ex)
+   {
+      activeServer = nullptr;
+      std::cerr << ex.what() << "\n";
+      return 1;
+   }
+
+   return 0;
+}
+
+/// \brief Інтерактивна сесія: вхід і меню адміністратора або користувача.
+/// \return Код завершення програми.
+int runMenus()
+{
    AuthManager auth("data/users.txt");
 
    try
@@ -116,6 +704,7 @@ int main()
          std::cout <<   "| 2. Список користувачів  |\n";
          std::cout <<   "| 3. Додати користувача   |\n";
          std::cout <<   "| 4. Видалити користувача |\n";
+         std::cout <<   "| 5. Змінити пароль       |\n";
          std::cout <<   "| 0. Вийти                |\n";
          std::cout <<   "|                         |\n";
          std::cout <<   "___________________________\n";
@@ -197,6 +786,29 @@ int main()
                   break;
                }
 
+               case 5:
+               {
+                  std::string login;
+                  std::string pass;
+
+                  std::cout << "Логін: ";
+                  std::getline(std::cin, login);
+
+                  std::cout << "Новий пароль: ";
+                  std::getline(std::cin, pass);
+
+                  if (auth.changePassword(login, pass))
+                  {
+                     std::cout << "Пароль змінено.\n";
+                  }
+                  else
+                  {
+                     lastErrorMessage =
+                        "Не вдалося змінити пароль (можливо, користувача не існує).";
+                  }
+                  break;
+               }
+
                case 0:
                   done = true;
                   break;
@@ -242,3 +854,179 @@ int main()
 
    return 0;
 }
+}
+
+/// \brief Головна функція, що запускає застосунок.
+/// \details Аргумент `--batch <файл|->` запускає пакетний режим: команди
+/// читаються з файлу або stdin, результати виводяться у JSON Lines.
+/// Аргумент `--server unix:<шлях>|tcp:<порт> [--workers N]` запускає
+/// серверний режим із тим самим протоколом для багатьох клієнтів.
+/// Аргумент `--generate <каталог> [ключ=значення...]` генерує синтетичні
+/// файли даних (див. DataGenerator), а `--bench [ключ=значення...]` запускає
+/// мікробенчмарки з JSON-звітом у stdout (див. Benchmark).
+/// Аргумент `--record <файл>` веде звичайну інтерактивну сесію і записує
+/// все введення з часом роздумів; `--play <файл> [speed=X|max]` відтворює
+/// таку сесію без виведення меню і друкує підсумок із часом відповідей
+/// (див. SessionLog.h), а `--replay <файл>... [parallel=N] [repeat=N]
+/// [speed=X|max] [dir=<каталог>] [data=<каталог>]` відтворює багато сесій
+/// паралельно в окремих процесах (див. SessionReplay).
+/// Аргумент `--load [ключ=значення...]` запускає багатопотокове
+/// навантаження на каталог у цьому процесі з JSON-звітом у stdout і
+/// кодом 1, якщо знайдено порушення узгодженості (див. LoadGenerator).
+/// \param argc Кількість аргументів командного рядка.
+/// \param argv Аргументи командного рядка.
+/// \return Код завершення програми.
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+   SetConsoleCP(CP_UTF8);
+   SetConsoleOutputCP(CP_UTF8);
+#endif
+   std::setlocale(LC_ALL, ".UTF8");
+
+   if (argc >= 2 && std::string(argv[1]) == "--batch")
+   {
+      if (argc != 3)
+      {
+         std::cerr << "Використання: " << argv[0] << " --batch <файл|->\n";
+         return 1;
+      }
+
+      return runBatch(argv[2]);
+   }
+
+   if (argc >= 2 && std::string(argv[1]) == "--generate")
+   {
+      GeneratorOptions options;
+      if (argc < 3 || !parseGeneratorOptions(argc, argv, options))
+      {
+         std::cerr << "Використання: " << argv[0]
+                   << " --generate <каталог> [tours=N] [users=N] [tickets=N]"
+                      " [sessions=N] [length=N] [seed=N] [skew=X] [ski=P]"
+                      " [dirty=P]\n";
+         return 1;
+      }
+
+      return runGenerator(options);
+   }
+
+   if (argc >= 2 && std::string(argv[1]) == "--bench")
+   {
+      BenchOptions options;
+      if (!parseBenchOptions(argc, argv, options))
+      {
+         std::cerr << "Використання: " << argv[0]
+                   << " --bench [dir=<каталог>] [sizes=10000,1000000]"
+                      " [seed=N] [time=<секунд>] [samples=N] [filter=<назва>]\n";
+         return 1;
+      }
+
+      return runBenchmark(options);
+   }
+
+   if (argc >= 2 && std::string(argv[1]) == "--server")
+   {
+      ServerOptions options;
+      if (argc < 3 || !parseServerOptions(argc, argv, options))
+      {
+         std::cerr << "Використання: " << argv[0]
+                   << " --server unix:<шлях>|tcp:<порт> [--workers N]\n";
+         return 1;
+      }
+
+      return runServer(options);
+   }
+
+   if (argc >= 2 && std::string(argv[1]) == "--replay")
+   {
+      ReplayOptions options;
+      if (!parseReplayOptions(argc, argv, options))
+      {
+         std::cerr << "Використання: " << argv[0]
+                   << " --replay <файл>... [parallel=N] [repeat=N]"
+                      " [speed=X|max] [dir=<каталог>] [data=<каталог>]\n";
+         return 1;
+      }
+
+      return runReplay(options);
+   }
+
+   if (argc >= 2 && std::string(argv[1]) == "--load")
+   {
+      LoadOptions options;
+      if (!parseLoadOptions(argc, argv, options))
+      {
+         std::cerr << "Використання: " << argv[0]
+                   << " --load [dir=<каталог>] [tours=N] [threads=N]"
+                      " [time=<секунд>] [rate=<операцій/с>] [seed=N] [skew=X]"
+                      " [sync=batch|interval|never] [query=W] [filter=W]"
+                      " [get=W] [sort=W] [edit=W] [book=W]\n";
+         return 1;
+      }
+
+      return runLoad(options);
+   }
+
+   // Запис або відтворення підміняють буфер std::cin до початку сесії
+   // і повертають його після її завершення.
+   std::unique_ptr<SessionRecorder> recorder;
+   std::unique_ptr<SessionPlayer> player;
+
+   if (argc >= 2 && std::string(argv[1]) == "--record")
+   {
+      if (argc != 3)
+      {
+         std::cerr << "Використання: " << argv[0] << " --record <файл>\n";
+         return 1;
+      }
+
+      try
+      {
+         recorder = std::make_unique<SessionRecorder>(std::cin, argv[2]);
+      }
+      catch (const FileException& ex)
+      {
+         std::cerr << ex.what() << "\n";
+         return 1;
+      }
+
+      std::cerr << "Запис сесії у " << argv[2]
+                << " (введення, зокрема паролі, зберігається у файлі).\n";
+   }
+   else if (argc >= 2 && std::string(argv[1]) == "--play")
+   {
+      double speed = 1.0;
+      const std::string speedArgument = argc == 4 ? argv[3] : "";
+
+      if (argc < 3 || argc > 4
+          || (argc == 4 && (speedArgument.rfind("speed=", 0) != 0
+                            || !parseSpeed(speedArgument.substr(6), speed))))
+      {
+         std::cerr << "Використання: " << argv[0]
+                   << " --play <файл> [speed=X|max]\n";
+         return 1;
+      }
+
+      try
+      {
+         player = std::make_unique<SessionPlayer>(std::cin, std::cout,
+            argv[2], speed);
+      }
+      catch (const FileException& ex)
+      {
+         std::cerr << ex.what() << "\n";
+         return 1;
+      }
+   }
+
+   try
+   {
+      return runMenus();
+   }
+   catch (const SessionEnded&)
+   {
+      // Відтворена сесія скінчилася там, де оригінал. Менеджери вже
+      // знищено розгортанням стеку, підсумок виведе деструктор player.
+      return 0;
+   }
+}
@@ -0,0 +1,60 @@
+// AllocationStatsTest.cpp
+
+#include "../AllocationStats.h"
+#include "../CityTour.h"
+#include "Check.h"
+
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace
+{
+   constexpr std::size_t cityTour = static_cast<std::size_t>(TrackedType::CityTour);
+
+   // Виділення рахуються в потоці, що їх зробив, разом із розміром.
+   void allocationsArePerThread()
+   {
+      const AllocationCounts before = AllocationStats::thisThread();
+      auto block = std::make_unique<char[]>(1000);
+      const AllocationCounts after = AllocationStats::thisThread();
+
+      CHECK(after.allocations == before.allocations + 1);
+      CHECK(after.bytes >= before.bytes + 1000);
+
+      // Запуск потоку сам виділяє пам'ять у цьому потоці, але не 4000 байтів.
+      std::thread([]
+         {
+            auto other = std::make_unique<char[]>(4000);
+         }).join();
+
+      const AllocationCounts joined = AllocationStats::thisThread();
+      CHECK(joined.bytes - after.bytes < 4000);
+   }
+
+   void tourLifecycleIsCounted()
+   {
+      const AllocationCounts before = AllocationStats::thisThread();
+      {
+         CityTour original;
+         CityTour copy(original);
+         CityTour moved(std::move(copy));
+      }
+      const AllocationCounts after = AllocationStats::thisThread();
+
+      const LifecycleCounts& was = before.lifecycle[cityTour];
+      const LifecycleCounts& now = after.lifecycle[cityTour];
+      CHECK(now.copies == was.copies + 1);
+      CHECK(now.moves == was.moves + 1);
+      CHECK(now.destroyed == was.destroyed + 3);
+   }
+}
+
+int main()
+{
+#if TOUR_METRICS
+   allocationsArePerThread();
+   tourLifecycleIsCounted();
+#endif
+   return check::result();
+}
@@ -0,0 +1,164 @@
+// AuthManagerTest.cpp
+
+#include "../AuthManager.h"
+#include "../TicketStore.h"
+#include "Check.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+   std::string emptyUsersFile(const std::string& name)
+   {
+      const std::string path = check::freshDirectory(name) + "users.txt";
+      std::ofstream(path, std::ios::trunc);
+      return path;
+   }
+
+   // Логін, який не вміщається в запис квитка, відхиляється під час
+   // реєстрації, а не обрізається під час бронювання.
+   void longUsernameIsRejected()
+   {
+      const std::string path = emptyUsersFile("auth-test-names");
+      AuthManager auth(path, AuthOptions{1000});
+
+      const std::string longest(TicketStore::maxUsernameLength, 'a');
+      CHECK(auth.addUser(longest, "secret"));
+      CHECK(!auth.addUser(longest + "b", "secret"));
+      CHECK(auth.authenticate(longest, "secret"));
+   }
+
+   void invalidUsernamesAreRejected()
+   {
+      const std::string path = emptyUsersFile("auth-test-invalid");
+      AuthManager auth(path, AuthOptions{1000});
+
+      CHECK(!auth.addUser("", "secret"));
+      CHECK(!auth.addUser("-bob", "secret"));
+      CHECK(!auth.addUser("bob:admin", "secret"));
+      CHECK(auth.addUser("bob", "secret"));
+      CHECK(!auth.addUser("bob", "other"));
+   }
+
+   // Індекс одного екземпляра бачить записи, які додав інший процес.
+   void externalChangesAreSeen()
+   {
+      const std::string path = emptyUsersFile("auth-test-external");
+      AuthManager first(path, AuthOptions{1000});
+      AuthManager second(path, AuthOptions{1000});
+
+      CHECK(first.addUser("bob", "secret"));
+      CHECK(second.authenticate("bob", "secret"));
+      CHECK(!second.addUser("bob", "other"));
+
+      // Запис із відкритим паролем, доданий ззовні, теж дійсний.
+      std::ofstream(path, std::ios::app) << "carl:plain\n";
+      CHECK(first.authenticate("carl", "plain"));
+      CHECK(!first.authenticate("carl", "wrong"));
+   }
+
+   std::string readFile(const std::string& path)
+   {
+      std::ifstream file(path);
+      return std::string(std::istreambuf_iterator<char>(file),
+         std::istreambuf_iterator<char>());
+   }
+
+   // Видалення й зміна пароля дописуються в журнал, а стиснення лишає
+   // по одному запису на живого користувача.
+   void deletionSurvivesCompaction()
+   {
+      const std::string path = emptyUsersFile("auth-test-compact");
+
+      {
+         AuthManager auth(path, AuthOptions{1000});
+         CHECK(auth.addUser("bob", "secret"));
+         CHECK(auth.addUser("eve", "secret"));
+         CHECK(auth.addUser("dan", "secret"));
+
+         CHECK(auth.deleteUser("bob"));
+         CHECK(!auth.deleteUser("bob"));
+         CHECK(auth.changePassword("eve", "changed"));
+         CHECK(readFile(path).find("-bob") != std::string::npos);
+
+         CHECK(auth.compact());
+         const std::string text = readFile(path);
+         CHECK(text.find("bob") == std::string::npos);
+         CHECK(text.find("eve:") == text.rfind("eve:"));
+      }
+
+      AuthManager auth(path, AuthOptions{1000});
+      CHECK((auth.listUsers() == std::vector<std::string>{"eve", "dan"}));
+      CHECK(!auth.authenticate("bob", "secret"));
+      CHECK(!auth.authenticate("eve", "secret"));
+      CHECK(auth.authenticate("eve", "changed"));
+   }
+
+#ifndef _WIN32
+   // Запис, який інший процес дописує під блокуванням журналу, не губиться
+   // під час одночасного стиснення.
+   void compactionWaitsForOtherProcess()
+   {
+      const std::string path = emptyUsersFile("auth-test-lock");
+      AuthManager auth(path, AuthOptions{1000});
+      CHECK(auth.addUser("bob", "secret"));
+      CHECK(auth.deleteUser("bob"));
+      CHECK(auth.addUser("eve", "secret"));
+
+      int ready[2];
+      CHECK(::pipe(ready) == 0);
+
+      const pid_t child = ::fork();
+      if (child == 0)
+      {
+         // Файл журналу відкривається до стиснення, а пишеться після.
+         const int lock = ::open((path + ".lock").c_str(), O_RDWR | O_CREAT, 0600);
+         ::flock(lock, LOCK_EX);
+         const int file = ::open(path.c_str(), O_WRONLY | O_APPEND);
+         (void)!::write(ready[1], "x", 1);
+         ::usleep(200 * 1000);
+         (void)!::write(file, "kim:plain\n", 10);
+         ::close(file);
+         ::close(lock);
+         ::_exit(0);
+      }
+
+      char signal = 0;
+      CHECK(::read(ready[0], &signal, 1) == 1);
+      CHECK(auth.compact());
+
+      int status = 0;
+      ::waitpid(child, &status, 0);
+      ::close(ready[0]);
+      ::close(ready[1]);
+
+      const std::string text = readFile(path);
+      CHECK(text.find("kim:plain") != std::string::npos);
+      CHECK(text.find("bob") == std::string::npos);
+      CHECK(auth.authenticate("kim", "plain"));
+      CHECK(!std::ifstream(path + ".tmp").good());
+   }
+#endif
+}
+
+int main()
+{
+   longUsernameIsRejected();
+   invalidUsernamesAreRejected();
+   externalChangesAreSeen();
+   deletionSurvivesCompaction();
+#ifndef _WIN32
+   compactionWaitsForOtherProcess();
+#endif
+   return check::result();
+}
@@ -0,0 +1,127 @@
+// BatchRunnerTest.cpp
+
+#include "../BatchRunner.h"
+#include "Check.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   struct Fixture
+   {
+      std::string directory = check::freshDirectory("batch-test");
+      AuthManager auth;
+      TourManager manager;
+
+      Fixture()
+         : auth(writeUsers(directory), AuthOptions{1000}),
+           manager(writeTours(directory), directory + "tickets.bin",
+              directory + "waitlist.log")
+      {
+         manager.load();
+      }
+
+      static std::string writeUsers(const std::string& directory)
+      {
+         const std::string path = directory + "users.txt";
+         std::ofstream(path, std::ios::trunc) << "admin:pw\nbob:pw\n";
+         return path;
+      }
+
+      static std::string writeTours(const std::string& directory)
+      {
+         const std::string path = directory + "tours.csv";
+         std::ofstream(path, std::ios::trunc)
+            << "type,id,capacity,sold,data\n"
+               "city,0,2,0,Poland,Warsaw,Hotel,Bus,2025-01-01,2025-01-05,"
+               "3*,Breakfast,None,100\n";
+         return path;
+      }
+   };
+
+   std::vector<std::string> runScript(BatchRunner& runner,
+      const std::string& script, std::size_t& failed)
+   {
+      std::istringstream in(script);
+      std::ostringstream out;
+      failed = runner.run(in, out);
+
+      std::vector<std::string> lines;
+      std::istringstream result(out.str());
+      for (std::string line; std::getline(result, line);)
+      {
+         lines.push_back(line);
+      }
+      return lines;
+   }
+
+   bool contains(const std::string& line, const std::string& part)
+   {
+      return line.find(part) != std::string::npos;
+   }
+
+   // На кожну команду — рядок JSON з номером рядка сценарію; коментарі
+   // й порожні рядки відповіді не мають.
+   void oneLinePerCommand()
+   {
+      Fixture fixture;
+      BatchRunner runner(fixture.manager, fixture.auth);
+
+      std::size_t failed = 0;
+      const std::vector<std::string> lines = runScript(runner,
+         "book 0\n"
+         "login bob pw\n"
+         "# коментар\n"
+         "\n"
+         "query city \"Warsaw\"\n"
+         "bogus\n",
+         failed);
+
+      CHECK(failed == 2);
+      CHECK(lines.size() == 4);
+      CHECK(contains(lines[0], "\"n\":1,\"op\":\"book\",\"ok\":false"));
+      CHECK(contains(lines[0], "\"error\":\"unauthorized\""));
+      CHECK(contains(lines[1], "\"user\":\"bob\""));
+      CHECK(contains(lines[2], "\"n\":5,\"op\":\"query\",\"ok\":true"));
+      CHECK(contains(lines[2], "\"ids\":[0]"));
+      CHECK(contains(lines[3], "\"error\":\"unknown_command\""));
+   }
+
+   // Повтор бронювання з тим самим ключем не створює другого квитка, а
+   // адміністративні команди недоступні звичайному користувачеві.
+   void bookingAndPermissions()
+   {
+      Fixture fixture;
+      BatchRunner runner(fixture.manager, fixture.auth);
+
+      std::size_t failed = 0;
+      const std::vector<std::string> lines = runScript(runner,
+         "login bob pw\n"
+         "book 0 key=a\n"
+         "book 0 key=a\n"
+         "edit 0 price=5\n"
+         "login admin pw\n"
+         "edit 0 price=5\n",
+         failed);
+
+      CHECK(failed == 1);
+      CHECK(lines.size() == 6);
+      CHECK(!contains(lines[1], "replayed"));
+      CHECK(contains(lines[2], "\"replayed\":true"));
+      CHECK(contains(lines[3], "\"error\":\"forbidden\""));
+      CHECK(contains(lines[5], "\"ok\":true"));
+
+      CHECK(fixture.manager.tourTickets(0).size() == 1);
+      CHECK(fixture.manager.getTour(0).value()->getPrice() == 5.0);
+   }
+}
+
+int main()
+{
+   oneLinePerCommand();
+   bookingAndPermissions();
+   return check::result();
+}
@@ -0,0 +1,112 @@
+// BenchmarkTest.cpp
+
+#include "../Benchmark.h"
+#include "Check.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+namespace
+{
+   bool contains(const std::string& text, const std::string& part)
+   {
+      return text.find(part) != std::string::npos;
+   }
+
+   // Кожен рядок результату має щонайменше minSamples вимірювань.
+   bool everyCaseHasSamples(const std::string& report, std::size_t minimum)
+   {
+      const std::string key = "\"samples\":";
+      std::size_t found = 0;
+
+      for (std::size_t at = report.find(key); at != std::string::npos;
+           at = report.find(key, at + 1))
+      {
+         if (std::strtoul(report.c_str() + at + key.size(), nullptr, 10)
+             < minimum)
+         {
+            return false;
+         }
+         ++found;
+      }
+      return found != 0;
+   }
+
+   BenchOptions smallOptions(const std::string& directory)
+   {
+      BenchOptions options;
+      options.directory = directory;
+      options.sizes = {200};
+      options.secondsPerCase = 0.01;
+      options.minSamples = 3;
+      return options;
+   }
+
+   // Фільтр лишає тільки випадки з підрядком у назві.
+   void filterSelectsCases()
+   {
+      const std::string directory = check::freshDirectory("bench-test-filter");
+      BenchOptions options = smallOptions(directory);
+      options.filter = "search_c";
+
+      std::ostringstream out;
+      Benchmark(options).run(out);
+      const std::string report = out.str();
+
+      CHECK(contains(report, "\"name\":\"search_country\""));
+      CHECK(contains(report, "\"name\":\"search_city\""));
+      CHECK(!contains(report, "\"name\":\"load\""));
+      CHECK(!contains(report, "\"name\":\"search_dates\""));
+      CHECK(contains(report, "\"rows\":200"));
+      CHECK(everyCaseHasSamples(report, options.minSamples));
+   }
+
+   // Каталог з тим самим розміром і зерном не генерується вдруге.
+   void generatedDataIsReused()
+   {
+      const std::string directory = check::freshDirectory("bench-test-reuse");
+      BenchOptions options = smallOptions(directory);
+      options.filter = "sort_price";
+
+      std::ostringstream first;
+      Benchmark(options).run(first);
+
+      const std::string marker = directory + "/rows-200/generated.txt";
+      CHECK(std::filesystem::exists(marker));
+      const auto generated = std::filesystem::last_write_time(marker);
+
+      std::ostringstream second;
+      Benchmark(options).run(second);
+      CHECK(std::filesystem::last_write_time(marker) == generated);
+      CHECK(contains(second.str(), "\"name\":\"sort_price\""));
+      CHECK(everyCaseHasSamples(second.str(), options.minSamples));
+   }
+
+   // Бронювання не впирається в розпродані тури ні в межах запуску,
+   // ні через квитки попереднього запуску.
+   void bookingsSucceed()
+   {
+      const std::string directory = check::freshDirectory("bench-test-book");
+      BenchOptions options = smallOptions(directory);
+      options.filter = "book";
+      options.minSamples = 10;
+
+      for (int run = 0; run < 2; ++run)
+      {
+         std::ostringstream out;
+         Benchmark(options).run(out);
+         CHECK(contains(out.str(), "\"name\":\"book\""));
+         CHECK(contains(out.str(), "\"failedOps\":0}"));
+      }
+   }
+}
+
+int main()
+{
+   filterSelectsCases();
+   generatedDataIsReused();
+   bookingsSucceed();
+   return check::result();
+}
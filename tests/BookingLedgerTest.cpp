@@ -0,0 +1,126 @@
+// BookingLedgerTest.cpp
+
+#include "../BookingLedger.h"
+#include "../TicketStore.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+   TicketRecord makeRecord(const std::string& username, SlotId tourId)
+   {
+      Ticket ticket;
+      ticket.username = username;
+      ticket.tourId = tourId;
+      ticket.price = 100.0;
+      return TicketStore::makeRecord(ticket);
+   }
+
+   // Записане журналом читається сховищем у тому ж порядку.
+   void recordsReplayAfterRestart()
+   {
+      const std::string path =
+         check::freshDirectory("ledger-test-replay") + "tickets.bin";
+
+      {
+         BookingLedger ledger(path);
+         CHECK(ledger.append(makeRecord("bob", 1)).ok());
+
+         const std::vector<TicketRecord> batch{
+            makeRecord("eve", 2), makeRecord("dan", 2)};
+         CHECK(ledger.append(batch.data(), batch.size()).ok());
+      }
+
+      TicketStore store;
+      CHECK(store.load(path).ok());
+      CHECK(store.size() == 3);
+      CHECK(store.seatsSold(2) == 2);
+      CHECK(store.forUser("bob").size() == 1);
+   }
+
+   // Обірваний під час збою запис не зсуває наступні записи.
+   void tornTailIsTrimmed()
+   {
+      const std::string path =
+         check::freshDirectory("ledger-test-torn") + "tickets.bin";
+
+      {
+         BookingLedger ledger(path);
+         CHECK(ledger.append(makeRecord("bob", 1)).ok());
+      }
+
+      {
+         std::FILE* file = std::fopen(path.c_str(), "ab");
+         std::fputs("torn", file);
+         std::fclose(file);
+      }
+
+      {
+         BookingLedger ledger(path);
+         CHECK(ledger.append(makeRecord("eve", 1)).ok());
+      }
+
+      TicketStore store;
+      CHECK(store.load(path).ok());
+      CHECK(store.size() == 2);
+      CHECK(store.forUser("eve").size() == 1);
+   }
+
+#ifndef _WIN32
+   // Група, записана лише частково, не залишає квитків у файлі.
+   void failedBatchLeavesNoRecords()
+   {
+      const std::string path =
+         check::freshDirectory("ledger-test-partial") + "tickets.bin";
+
+      BookingLedger ledger(path, LedgerOptions{SyncPolicy::Never});
+      CHECK(ledger.append(makeRecord("bob", 1)).ok());
+
+      // Ліміт розміру файлу пропускає лише частину наступної групи.
+      const std::uintmax_t committed = std::filesystem::file_size(path);
+      std::signal(SIGXFSZ, SIG_IGN);
+
+      rlimit previous{};
+      ::getrlimit(RLIMIT_FSIZE, &previous);
+      rlimit limited = previous;
+      limited.rlim_cur = static_cast<rlim_t>(committed + 100);
+      ::setrlimit(RLIMIT_FSIZE, &limited);
+
+      const std::vector<TicketRecord> batch{
+         makeRecord("eve", 1), makeRecord("dan", 1), makeRecord("ann", 1)};
+      const Result<void> failed = ledger.append(batch.data(), batch.size());
+
+      ::setrlimit(RLIMIT_FSIZE, &previous);
+
+      CHECK(!failed.ok());
+      CHECK(std::filesystem::file_size(path) == committed);
+
+      CHECK(ledger.append(makeRecord("kim", 1)).ok());
+
+      TicketStore store;
+      CHECK(store.load(path).ok());
+      CHECK(store.size() == 2);
+      CHECK(store.forUser("eve").empty());
+      CHECK(store.forUser("kim").size() == 1);
+   }
+#endif
+}
+
+int main()
+{
+   recordsReplayAfterRestart();
+   tornTailIsTrimmed();
+#ifndef _WIN32
+   failedBatchLeavesNoRecords();
+#endif
+   return check::result();
+}
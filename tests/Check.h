@@ -0,0 +1,60 @@
+// Check.h
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+/// \file Check.h
+/// \brief Мінімальні засоби перевірки для тестових програм.
+/// \details Кожен тест — окрема програма з main(), яка повертає 0, якщо всі
+/// перевірки пройшли. Тести не мають зовнішніх залежностей.
+
+namespace check
+{
+   /// \brief Кількість невдалих перевірок у поточній програмі.
+   inline int failures = 0;
+
+   /// \brief Повідомляє про невдалу перевірку.
+   inline void fail(const char* expression, const char* file, int line)
+   {
+      std::cerr << file << ':' << line << ": перевірка не пройшла: "
+                << expression << "\n";
+      ++failures;
+   }
+
+   /// \brief Повертає код завершення тестової програми.
+   inline int result()
+   {
+      if (failures == 0)
+      {
+         std::cout << "OK\n";
+         return 0;
+      }
+
+      std::cerr << failures << " перевірок не пройшли.\n";
+      return 1;
+   }
+
+   /// \brief Створює порожній тимчасовий каталог для даних тесту.
+   /// \param name Назва каталогу всередині системного тимчасового каталогу.
+   /// \return Шлях до каталогу з роздільником у кінці.
+   inline std::string freshDirectory(const std::string& name)
+   {
+      const std::filesystem::path directory =
+         std::filesystem::temp_directory_path() / name;
+      std::filesystem::remove_all(directory);
+      std::filesystem::create_directories(directory);
+      return directory.string() + "/";
+   }
+}
+
+/// \brief Перевіряє умову й продовжує тест, якщо вона хибна.
+#define CHECK(condition)                                  \
+   do                                                     \
+   {                                                      \
+      if (!(condition))                                   \
+      {                                                   \
+         ::check::fail(#condition, __FILE__, __LINE__);   \
+      }                                                   \
+   } while (false)
@@ -0,0 +1,106 @@
+// ChunkedVectorTest.cpp
+
+#include "../ChunkedVector.h"
+#include "Check.h"
+
+#include <cstddef>
+
+namespace
+{
+   constexpr std::size_t chunk = ChunkedVector<int>::chunkSize;
+
+   ChunkedVector<int> sequence(std::size_t count)
+   {
+      ChunkedVector<int> values;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         values.push_back(static_cast<int>(i));
+      }
+      return values;
+   }
+
+   void pushAndPopAcrossChunks()
+   {
+      ChunkedVector<int> values = sequence(3 * chunk + 1);
+      CHECK(values.size() == 3 * chunk + 1);
+      CHECK(values[chunk - 1] == static_cast<int>(chunk - 1));
+      CHECK(values[chunk] == static_cast<int>(chunk));
+      CHECK(values.back() == static_cast<int>(3 * chunk));
+
+      while (values.size() > chunk - 1)
+      {
+         values.pop_back();
+      }
+      CHECK(values.back() == static_cast<int>(chunk - 2));
+
+      values.push_back(-1);
+      values.push_back(-2);
+      CHECK(values[chunk - 1] == -1);
+      CHECK(values[chunk] == -2);
+   }
+
+   // Зміна копії не повинна бути видимою в оригіналі, і навпаки.
+   void copiesAreIndependent()
+   {
+      ChunkedVector<int> original = sequence(2 * chunk + 5);
+      ChunkedVector<int> copy = original;
+
+      copy.mutableAt(3) = -3;
+      copy.mutableAt(chunk + 1) = -4;
+      copy.pop_back();
+      copy.push_back(-5);
+
+      CHECK(original[3] == 3);
+      CHECK(original[chunk + 1] == static_cast<int>(chunk + 1));
+      CHECK(original.back() == static_cast<int>(2 * chunk + 4));
+      CHECK(copy[3] == -3);
+      CHECK(copy[chunk + 1] == -4);
+      CHECK(copy.back() == -5);
+
+      original.mutableAt(4) = -6;
+      CHECK(copy[4] == 4);
+   }
+
+   void runCoversWholeVector()
+   {
+      const ChunkedVector<int> values = sequence(2 * chunk + 7);
+
+      std::size_t position = 3;
+      bool ordered = true;
+      while (position < values.size())
+      {
+         std::size_t length = 0;
+         const int* items = values.run(position, length);
+         CHECK(length != 0);
+         for (std::size_t i = 0; i < length; ++i, ++position)
+         {
+            ordered = ordered && items[i] == static_cast<int>(position);
+         }
+      }
+
+      CHECK(ordered);
+      CHECK(position == values.size());
+   }
+
+   void iteratorVisitsEveryElement()
+   {
+      const ChunkedVector<int> values = sequence(chunk + 3);
+
+      std::size_t visited = 0;
+      for (const int value : values)
+      {
+         CHECK(value == static_cast<int>(visited));
+         ++visited;
+      }
+      CHECK(visited == values.size());
+   }
+}
+
+int main()
+{
+   pushAndPopAcrossChunks();
+   copiesAreIndependent();
+   runCoversWholeVector();
+   iteratorVisitsEveryElement();
+   return check::result();
+}
@@ -0,0 +1,171 @@
+// CsvScannerTest.cpp
+
+#include "../CsvScanner.h"
+#include "../Random.h"
+#include "Check.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   using Rows = std::vector<std::vector<std::string>>;
+
+   Rows scan(const std::string& text)
+   {
+      Rows rows;
+      CsvScanner scanner(text.data(), text.size());
+      CsvRow row;
+      while (scanner.next(row))
+      {
+         std::vector<std::string> fields;
+         for (std::size_t i = 0; i < row.size(); ++i)
+         {
+            fields.push_back(row.field(i));
+         }
+         rows.push_back(fields);
+      }
+      return rows;
+   }
+
+   /// \brief Посимвольний розбір рядків без лапок для порівняння.
+   Rows splitPlain(const std::string& text)
+   {
+      Rows rows;
+      std::size_t start = 0;
+      while (start < text.size())
+      {
+         std::size_t end = text.find('\n', start);
+         if (end == std::string::npos)
+         {
+            end = text.size();
+         }
+
+         std::vector<std::string> fields;
+         std::size_t field = start;
+         while (fields.size() + 1 < CsvRow::maxFields)
+         {
+            const std::size_t comma = text.find(',', field);
+            if (comma == std::string::npos || comma >= end)
+            {
+               break;
+            }
+            fields.push_back(text.substr(field, comma - field));
+            field = comma + 1;
+         }
+         fields.push_back(text.substr(field, end - field));
+
+         rows.push_back(fields);
+         start = end + 1;
+      }
+      return rows;
+   }
+
+   // Рядки й поля будь-якої довжини, що перетинають межі 64-байтових
+   // блоків, розбираються так само, як посимвольно.
+   void blockEdgesMatchPlainSplit()
+   {
+      Random random(42);
+
+      for (int round = 0; round < 500; ++round)
+      {
+         std::string text;
+         const std::size_t length = random.below(300);
+         for (std::size_t i = 0; i < length; ++i)
+         {
+            const std::size_t roll = random.below(20);
+            text += roll == 0 ? '\n' : roll < 4 ? ',' : char('a' + roll);
+         }
+
+         const Rows expected = splitPlain(text);
+         const Rows actual = scan(text);
+         CHECK(actual == expected);
+         if (actual != expected)
+         {
+            std::cerr << "Текст: [" << text << "]\n";
+            break;
+         }
+      }
+   }
+
+   void quotedFieldsKeepSeparators()
+   {
+      const std::string text =
+         "city,\"Lviv, Old Town\",\"say \"\"hi\"\"\"\n"
+         "ski,\"two\nlines\",x\n"
+         "plain,a\"b,c\n";
+
+      const Rows rows = scan(text);
+      CHECK(rows.size() == 3);
+      CHECK((rows[0] == std::vector<std::string>{
+         "city", "Lviv, Old Town", "say \"hi\""}));
+      CHECK((rows[1] == std::vector<std::string>{"ski", "two\nlines", "x"}));
+      CHECK((rows[2] == std::vector<std::string>{"plain", "a\"b", "c"}));
+   }
+
+   // Поле в лапках, що перетинає межу блоку, не зсуває наступні рядки.
+   void quotedFieldAcrossBlocks()
+   {
+      for (std::size_t pad = 0; pad < 130; ++pad)
+      {
+         const std::string text = "a,\"" + std::string(pad, 'q') + ",\n\"\"z\",b\n"
+            + "next," + std::string(pad % 70, 'n') + "\n";
+
+         const Rows rows = scan(text);
+         CHECK(rows.size() == 2);
+         if (rows.size() == 2)
+         {
+            CHECK((rows[0] == std::vector<std::string>{"a",
+               std::string(pad, 'q') + ",\n\"z", "b"}));
+            CHECK(rows[1].size() == 2 && rows[1][0] == "next");
+         }
+      }
+   }
+
+   void extraFieldsStayInLast()
+   {
+      std::string text;
+      for (std::size_t i = 0; i < CsvRow::maxFields + 3; ++i)
+      {
+         text += (i == 0 ? "" : ",") + std::to_string(i);
+      }
+
+      const Rows rows = scan(text);
+      CHECK(rows.size() == 1 && rows[0].size() == CsvRow::maxFields);
+      CHECK(rows[0].back() == "15,16,17,18");
+   }
+
+   void writeFieldRoundTrips()
+   {
+      const std::vector<std::string> values{"plain", "with,comma",
+         "quote\"inside", "line\nbreak", "cr\r", ""};
+
+      std::ostringstream out;
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+         if (i != 0)
+         {
+            out << ',';
+         }
+         CsvScanner::writeField(out, values[i]);
+      }
+      out << '\n';
+
+      const std::string text = out.str();
+      CHECK(text.rfind("plain,\"with,comma\",\"quote\"\"inside\"", 0) == 0);
+
+      const Rows rows = scan(text);
+      CHECK(rows.size() == 1 && rows[0] == values);
+   }
+}
+
+int main()
+{
+   blockEdgesMatchPlainSplit();
+   quotedFieldsKeepSeparators();
+   quotedFieldAcrossBlocks();
+   extraFieldsStayInLast();
+   writeFieldRoundTrips();
+   return check::result();
+}
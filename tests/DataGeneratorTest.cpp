@@ -0,0 +1,99 @@
+// DataGeneratorTest.cpp
+
+#include "../AuthManager.h"
+#include "../CsvScanner.h"
+#include "../DataGenerator.h"
+#include "../TourManager.h"
+#include "Check.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+   std::string readFile(const std::string& path)
+   {
+      std::ifstream file(path, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(file),
+         std::istreambuf_iterator<char>());
+   }
+
+   GeneratorOptions smallOptions(const std::string& name, std::uint64_t seed)
+   {
+      GeneratorOptions options;
+      options.directory = check::freshDirectory(name);
+      options.tours = 200;
+      options.users = 10;
+      options.tickets = 500;
+      options.sessions = 5;
+      options.seed = seed;
+      return options;
+   }
+
+   // Однакове зерно дає однакові файли, інше — інші.
+   void seedDeterminesOutput()
+   {
+      const GeneratorOptions first = smallOptions("generator-test-a", 7);
+      const GeneratorOptions second = smallOptions("generator-test-b", 7);
+      const GeneratorOptions other = smallOptions("generator-test-c", 8);
+      DataGenerator(first).run();
+      DataGenerator(second).run();
+      DataGenerator(other).run();
+
+      for (const char* name : {"tours.csv", "users.txt", "tickets.txt",
+              "workload.txt"})
+      {
+         CHECK(readFile(first.directory + name)
+            == readFile(second.directory + name));
+      }
+      CHECK(readFile(first.directory + "tours.csv")
+         != readFile(other.directory + "tours.csv"));
+   }
+
+   // Згенеровані файли читаються без втрат, а імпорт квитків дає ті самі
+   // продані місця, що записані в tours.csv.
+   void filesLoadConsistently()
+   {
+      const GeneratorOptions options = smallOptions("generator-test-load", 3);
+      const GeneratorReport report = DataGenerator(options).run();
+      CHECK(report.tours == options.tours);
+
+      const std::string dir = options.directory;
+      TourManager manager(dir + "tours.csv", dir + "tickets.bin",
+         dir + "waitlist.log");
+      manager.load();
+      CHECK(manager.size() == options.tours);
+
+      Result<std::size_t> imported = manager.importTickets(dir + "tickets.txt");
+      CHECK(imported.ok() && imported.value() == report.tickets);
+
+      const std::string text = readFile(dir + "tours.csv");
+      CsvScanner scanner(text.data(), text.size());
+      CsvRow row;
+      scanner.next(row); // Заголовок.
+
+      std::size_t mismatches = 0;
+      while (scanner.next(row))
+      {
+         const TourId id = static_cast<TourId>(std::stoul(row.field(1)));
+         const SeatInventory::Counts seats = manager.getSeats(id).value();
+         if (std::to_string(seats.capacity - seats.available) != row.field(3))
+         {
+            ++mismatches;
+         }
+      }
+      CHECK(mismatches == 0);
+
+      AuthManager auth(dir + "users.txt", AuthOptions{1000});
+      CHECK(auth.authenticate("admin", "admin"));
+      CHECK(auth.authenticate("user3", "pw3"));
+   }
+}
+
+int main()
+{
+   seedDeterminesOutput();
+   filesLoadConsistently();
+   return check::result();
+}
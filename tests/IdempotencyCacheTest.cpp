@@ -0,0 +1,95 @@
+// IdempotencyCacheTest.cpp
+
+#include "../IdempotencyCache.h"
+#include "Check.h"
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+namespace
+{
+   Ticket makeTicket(SlotId tourId)
+   {
+      Ticket ticket;
+      ticket.username = "bob";
+      ticket.tourId = tourId;
+      ticket.price = 100.0;
+      return ticket;
+   }
+
+   // Повторний запит з ключем повертає перший квиток.
+   void completedKeyReplays()
+   {
+      IdempotencyCache cache;
+      Ticket original;
+
+      CHECK(cache.claim("k", 1, original) == IdempotencyCache::Claim::Acquired);
+      {
+         IdempotencyCache::Lease lease(cache, "k");
+         lease.complete(makeTicket(1));
+      }
+
+      CHECK(cache.claim("k", 1, original) == IdempotencyCache::Claim::Replay);
+      CHECK(original.tourId == 1);
+      CHECK(cache.claim("k", 2, original) == IdempotencyCache::Claim::Mismatch);
+   }
+
+   // Виняток під час бронювання звільняє ключ, і наступний запит не чекає
+   // вічно на незавершений ключ.
+   void exceptionAbandonsKey()
+   {
+      IdempotencyCache cache;
+      Ticket original;
+
+      CHECK(cache.claim("k", 1, original) == IdempotencyCache::Claim::Acquired);
+      try
+      {
+         IdempotencyCache::Lease lease(cache, "k");
+         throw std::runtime_error("збій бронювання");
+      }
+      catch (const std::runtime_error&)
+      {
+      }
+
+      std::future<IdempotencyCache::Claim> retry = std::async(
+         std::launch::async, [&cache]
+         {
+            Ticket ignored;
+            return cache.claim("k", 1, ignored);
+         });
+
+      CHECK(retry.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+      CHECK(retry.get() == IdempotencyCache::Claim::Acquired);
+   }
+
+   // Запит з тим самим ключем чекає на незавершений і отримує його квиток.
+   void waiterSeesCompletion()
+   {
+      IdempotencyCache cache;
+      Ticket original;
+
+      CHECK(cache.claim("k", 1, original) == IdempotencyCache::Claim::Acquired);
+      IdempotencyCache::Lease lease(cache, "k");
+
+      std::future<IdempotencyCache::Claim> waiter = std::async(
+         std::launch::async, [&cache]
+         {
+            Ticket replayed;
+            return cache.claim("k", 1, replayed);
+         });
+
+      CHECK(waiter.wait_for(std::chrono::milliseconds(50))
+         == std::future_status::timeout);
+      lease.complete(makeTicket(1));
+      CHECK(waiter.get() == IdempotencyCache::Claim::Replay);
+   }
+}
+
+int main()
+{
+   completedKeyReplays();
+   exceptionAbandonsKey();
+   waiterSeesCompletion();
+   return check::result();
+}
@@ -0,0 +1,42 @@
+// LoadGeneratorTest.cpp
+
+#include "../LoadGenerator.h"
+#include "Check.h"
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+   bool contains(const std::string& text, const std::string& part)
+   {
+      return text.find(part) != std::string::npos;
+   }
+
+   // Короткий замкнений цикл на малому каталозі не знаходить порушень, а
+   // звіт містить розділи з результатами правок і бронювань.
+   void closedLoopIsConsistent()
+   {
+      LoadOptions options;
+      options.directory = check::freshDirectory("load-test-closed");
+      options.tours = 300;
+      options.threads = 4;
+      options.seconds = 0.2;
+      options.sync = SyncPolicy::Never;
+
+      std::ostringstream out;
+      const std::size_t violations = LoadGenerator(options).run(out);
+      const std::string report = out.str();
+
+      CHECK(violations == 0);
+      CHECK(contains(report, "\"edits\":{\"applied\":"));
+      CHECK(contains(report, "\"bookings\":{\"booked\":"));
+      CHECK(contains(report, "\"ok\":true"));
+   }
+}
+
+int main()
+{
+   closedLoopIsConsistent();
+   return check::result();
+}
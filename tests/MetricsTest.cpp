@@ -0,0 +1,98 @@
+// MetricsTest.cpp
+
+#include "../Metrics.h"
+#include "../TourManager.h"
+#include "Check.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+   std::string report()
+   {
+      std::ostringstream out;
+      Metrics::writeJson(out);
+      return out.str();
+   }
+
+   bool contains(const std::string& text, const std::string& part)
+   {
+      return text.find(part) != std::string::npos;
+   }
+
+   // Виклик, що завершився винятком, рахується як невдалий, а байти
+   // зараховуються операції, в межах якої їх записано.
+   void scopesCountCallsAndFailures()
+   {
+      Metrics::reset();
+
+      {
+         Metrics::Scope scope(Operation::Save);
+         Metrics::bytesWritten(100);
+      }
+
+      try
+      {
+         Metrics::Scope scope(Operation::Save);
+         throw std::runtime_error("збій");
+      }
+      catch (const std::runtime_error&)
+      {
+      }
+
+      Metrics::bytesWritten(5); // Поза операцією не враховується.
+
+      const std::string text = report();
+      CHECK(contains(text, "\"save\":{\"calls\":2,\"failures\":1"));
+      CHECK(contains(text, "\"bytesWritten\":100,"));
+   }
+
+   void contentionAndReset()
+   {
+      Metrics::reset();
+      Metrics::retried(Contention::SeatCounter, 3);
+      CHECK(Metrics::contention(Contention::SeatCounter).events == 3);
+
+      Metrics::reset();
+      CHECK(Metrics::contention(Contention::SeatCounter).events == 0);
+      CHECK(contains(report(), "\"operations\":{}"));
+   }
+
+   // Помилка, повернена як Result, рахується так само, як виняток.
+   void errorResultsCountAsFailures()
+   {
+      const std::string directory = check::freshDirectory("metrics-test-book");
+      std::ofstream(directory + "tours.csv", std::ios::trunc)
+         << "type,id,capacity,sold,data\n"
+            "city,0,1,0,Poland,Warsaw,Hotel,Bus,2025-01-01,2025-01-05,"
+            "3*,Breakfast,None,100\n";
+
+      TourManager manager(directory + "tours.csv", directory + "tickets.bin",
+         directory + "waitlist.log");
+      manager.load();
+
+      Metrics::reset();
+      CHECK(manager.bookTour("bob", 0).ok());
+      CHECK(!manager.bookTour("eve", 0).ok());
+      CHECK(!manager.bookTour("eve", 7).ok());
+      CHECK(!manager.cancelBooking("eve", 0).ok());
+
+      const std::string text = report();
+      CHECK(contains(text, "\"bookTour\":{\"calls\":3,\"failures\":2"));
+      CHECK(contains(text, "\"cancelBooking\":{\"calls\":1,\"failures\":1"));
+   }
+}
+
+int main()
+{
+   if (Metrics::enabled)
+   {
+      scopesCountCallsAndFailures();
+      contentionAndReset();
+      errorResultsCountAsFailures();
+   }
+   return check::result();
+}
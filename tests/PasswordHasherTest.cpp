@@ -0,0 +1,98 @@
+// PasswordHasherTest.cpp
+
+#include "../PasswordHasher.h"
+#include "Check.h"
+
+#include <string>
+
+namespace
+{
+   std::string toHex(const std::string& bytes)
+   {
+      const char digits[] = "0123456789abcdef";
+      std::string text;
+      for (unsigned char byte : bytes)
+      {
+         text += digits[byte >> 4];
+         text += digits[byte & 0xf];
+      }
+      return text;
+   }
+
+   std::string stored(unsigned iterations, const std::string& saltHex,
+      const std::string& keyHex)
+   {
+      return "$pbkdf2-sha256$" + std::to_string(iterations) + '$' + saltHex
+         + '$' + keyHex;
+   }
+
+   // Контрольні значення RFC 4231 (тести 2 і 6).
+   void hmacMatchesRfc4231()
+   {
+      CHECK(toHex(PasswordHasher::hmac("Jefe", "what do ya want for nothing?"))
+         == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+      CHECK(toHex(PasswordHasher::hmac(std::string(131, '\xaa'),
+               "Test Using Larger Than Block-Size Key - Hash Key First"))
+         == "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+   }
+
+   // Відомі значення PBKDF2-HMAC-SHA256 з 32-байтовим ключем.
+   void pbkdf2MatchesKnownVectors()
+   {
+      const std::string salt = "73616c74"; // "salt"
+      CHECK(PasswordHasher::verify(stored(1, salt,
+         "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b"),
+         "password"));
+      CHECK(PasswordHasher::verify(stored(2, salt,
+         "ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43"),
+         "password"));
+      CHECK(PasswordHasher::verify(stored(4096, salt,
+         "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"),
+         "password"));
+      CHECK(PasswordHasher::verify(stored(4096,
+         "73616c7453414c5473616c7453414c5473616c7453414c5473616c7453414c54"
+         "73616c74",
+         "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1"),
+         "passwordPASSWORDpassword"));
+
+      CHECK(!PasswordHasher::verify(stored(2, salt,
+         "ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43"),
+         "Password"));
+   }
+
+   void hashRoundTripsWithCost()
+   {
+      const PasswordHasher cheap(10);
+      const PasswordHasher dear(20);
+
+      const std::string hashed = cheap.hash("secret");
+      CHECK(PasswordHasher::isHashed(hashed));
+      CHECK(hashed.rfind("$pbkdf2-sha256$10$", 0) == 0);
+      CHECK(PasswordHasher::verify(hashed, "secret"));
+      CHECK(!PasswordHasher::verify(hashed, "secret2"));
+      CHECK(cheap.hash("secret") != hashed);
+
+      CHECK(!cheap.needsRehash(hashed));
+      CHECK(dear.needsRehash(hashed));
+      CHECK(dear.needsRehash("plain-text"));
+   }
+
+   void malformedHashesAreRejected()
+   {
+      CHECK(!PasswordHasher::isHashed("secret"));
+      CHECK(!PasswordHasher::verify("secret", "secret"));
+      CHECK(!PasswordHasher::verify("$pbkdf2-sha256$0$73616c74$00", "x"));
+      CHECK(!PasswordHasher::verify("$pbkdf2-sha256$1$zz$00", "x"));
+      CHECK(!PasswordHasher::verify("$pbkdf2-sha256$1$73616c74$0011", "x"));
+      CHECK(!PasswordHasher::verify("$pbkdf2-sha256$x1$73616c74$00", "x"));
+   }
+}
+
+int main()
+{
+   hmacMatchesRfc4231();
+   pbkdf2MatchesKnownVectors();
+   hashRoundTripsWithCost();
+   malformedHashesAreRejected();
+   return check::result();
+}
@@ -0,0 +1,51 @@
+// ReportFormatTest.cpp
+
+#include "../ReportFormat.h"
+#include "Check.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   std::string json(const std::string& text)
+   {
+      std::ostringstream out;
+      writeJsonString(out, text);
+      return out.str();
+   }
+
+   // Керівні символи не потрапляють у JSON сирими.
+   void controlCharactersAreEscaped()
+   {
+      CHECK(json("Київ") == "\"Київ\"");
+      CHECK(json("a\"b\\c") == "\"a\\\"b\\\\c\"");
+      CHECK(json("1\n2\r3\t4") == "\"1\\n2\\r3\\t4\"");
+      CHECK(json(std::string("\x01\x1f", 2)) == "\"\\u0001\\u001f\"");
+   }
+
+   void percentileUsesNearestRank()
+   {
+      const std::vector<std::uint64_t> empty;
+      CHECK(percentile(empty, 0.5) == 0);
+
+      std::vector<double> values;
+      for (int i = 1; i <= 101; ++i)
+      {
+         values.push_back(i);
+      }
+      CHECK(percentile(values, 0.0) == 1.0);
+      CHECK(percentile(values, 0.5) == 51.0);
+      CHECK(percentile(values, 0.99) == 100.0);
+      CHECK(percentile(values, 1.0) == 101.0);
+   }
+}
+
+int main()
+{
+   controlCharactersAreEscaped();
+   percentileUsesNearestRank();
+   return check::result();
+}
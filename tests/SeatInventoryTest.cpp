@@ -0,0 +1,89 @@
+// SeatInventoryTest.cpp
+
+#include "../SeatInventory.h"
+#include "Check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+   // Одночасні бронювання не можуть продати більше місць, ніж є.
+   void concurrentReservationsDoNotOversell()
+   {
+      SeatInventory seats(1000);
+      std::atomic<int> reserved{0};
+      std::vector<std::thread> threads;
+
+      for (int t = 0; t < 8; ++t)
+      {
+         threads.emplace_back([&seats, &reserved]
+            {
+               for (int i = 0; i < 500; ++i)
+               {
+                  if (seats.tryReserve())
+                  {
+                     reserved.fetch_add(1);
+                  }
+               }
+            });
+      }
+
+      for (std::thread& thread : threads)
+      {
+         thread.join();
+      }
+
+      CHECK(reserved.load() == 1000);
+      CHECK(seats.available() == 0);
+      CHECK(seats.sold() == 1000);
+   }
+
+   void reserveNeedsEnoughSeats()
+   {
+      SeatInventory seats(3, 1);
+      CHECK(!seats.tryReserve(3));
+      CHECK(!seats.tryReserve(0));
+      CHECK(seats.tryReserve(2));
+      CHECK(!seats.tryReserve());
+
+      seats.release(2);
+      CHECK(seats.available() == 2);
+   }
+
+   void resizeKeepsSoldSeats()
+   {
+      SeatInventory seats(5, 3);
+      CHECK(!seats.resize(2).ok());
+      CHECK(seats.resize(4).ok());
+      CHECK(seats.counts().capacity == 4);
+      CHECK(seats.counts().available == 1);
+   }
+
+   // Перепродаж понад місткість покривається скасуваннями по черзі.
+   void oversoldSeatsStayTaken()
+   {
+      SeatInventory seats(2);
+      seats.setSold(4);
+      CHECK(seats.counts().available == 0);
+      CHECK(seats.sold() == 2);
+
+      seats.release();
+      CHECK(!seats.tryReserve());
+
+      seats.take(1);
+      seats.release(3);
+      CHECK(seats.available() == 1);
+      CHECK(seats.tryReserve());
+   }
+}
+
+int main()
+{
+   concurrentReservationsDoNotOversell();
+   reserveNeedsEnoughSeats();
+   resizeKeepsSoldSeats();
+   oversoldSeatsStayTaken();
+   return check::result();
+}
@@ -0,0 +1,150 @@
+// SessionLogTest.cpp
+
+#include "../FileException.h"
+#include "../SessionLog.h"
+#include "Check.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   const std::vector<std::string> typed{
+      "1", "C:\\tours\\list.csv", "пароль\rз кареткою", "останній"};
+
+   // Записує введення, останній рядок якого не має переносу.
+   std::string recordSession(const std::string& name)
+   {
+      const std::string path = check::freshDirectory(name) + "session.txt";
+
+      std::istringstream input(
+         typed[0] + "\n" + typed[1] + "\n" + typed[2] + "\n" + typed[3]);
+      {
+         SessionRecorder recorder(input, path);
+
+         std::string line;
+         for (const std::string& expected : typed)
+         {
+            CHECK(std::getline(input, line));
+            CHECK(line == expected);
+         }
+         CHECK(!std::getline(input, line));
+      }
+      return path;
+   }
+
+   // Відтворена сесія подає програмі ті самі рядки, а виведення відкидає.
+   void playedSessionMatchesRecorded()
+   {
+      const std::string path = recordSession("session-test-replay");
+
+      std::istringstream input;
+      std::ostringstream output;
+      {
+         SessionPlayer player(input, output, path, 0.0);
+
+         std::string line;
+         for (const std::string& expected : typed)
+         {
+            output << "Меню\n> ";
+            CHECK(std::getline(input, line));
+            CHECK(line == expected);
+         }
+         CHECK(output.str().empty());
+      }
+
+      const std::string summary = output.str();
+      CHECK(summary.find("\"inputs\":4") != std::string::npos);
+      CHECK(summary.find("\"consumed\":4") != std::string::npos);
+      CHECK(summary.find("Меню") == std::string::npos);
+   }
+
+   // Запит введення після останнього рядка завершує сесію винятком, а не
+   // виходом з процесу: деструктори встигають відпрацювати.
+   void exhaustedSessionThrows()
+   {
+      const std::string path = recordSession("session-test-end");
+
+      std::istringstream input("не з сесії\n");
+      std::ostringstream output;
+      bool ended = false;
+
+      try
+      {
+         SessionPlayer player(input, output, path, 0.0);
+
+         std::string line;
+         for (std::size_t i = 0; i <= typed.size(); ++i)
+         {
+            std::getline(input, line);
+         }
+      }
+      catch (const SessionEnded&)
+      {
+         ended = true;
+      }
+
+      CHECK(ended);
+      CHECK(output.str().find("\"consumed\":4") != std::string::npos);
+
+      // Потік введення повернуто з початковою маскою винятків.
+      std::string line;
+      CHECK(input.exceptions() == std::ios::goodbit);
+      CHECK(std::getline(input, line) && line == "не з сесії");
+   }
+
+   void damagedSessionIsRejected()
+   {
+      const std::string path =
+         check::freshDirectory("session-test-damaged") + "session.txt";
+
+      std::istringstream input;
+      std::ostringstream output;
+
+      {
+         std::ofstream file(path);
+         file << "not a session\n";
+      }
+
+      bool thrown = false;
+      try
+      {
+         SessionPlayer player(input, output, path, 0.0);
+      }
+      catch (const FileException&)
+      {
+         thrown = true;
+      }
+      CHECK(thrown);
+
+      {
+         std::ofstream file(path);
+         file << "# tours-session 1\n12 ok\nx bad\n";
+      }
+
+      thrown = false;
+      try
+      {
+         SessionPlayer player(input, output, path, 0.0);
+      }
+      catch (const FileException&)
+      {
+         thrown = true;
+      }
+      CHECK(thrown);
+
+      // Невдале завантаження не підміняє буфери потоків.
+      output << "видно";
+      CHECK(output.str() == "видно");
+   }
+}
+
+int main()
+{
+   playedSessionMatchesRecorded();
+   exhaustedSessionThrows();
+   damagedSessionIsRejected();
+   return check::result();
+}
@@ -0,0 +1,91 @@
+// SessionReplayTest.cpp
+
+#include "../SessionLog.h"
+#include "../SessionReplay.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+   // Дочірній процес відтворення: SessionReplay запускає /proc/self/exe,
+   // тобто цей тест, з `--play`. Команда `inc` збільшує лічильник у
+   // data/counter.txt і пише в stderr значення, з якого почала.
+   int play(const std::string& session)
+   {
+      try
+      {
+         SessionPlayer player(std::cin, std::cout, session, 0.0);
+
+         std::string line;
+         while (std::getline(std::cin, line))
+         {
+            if (line != "inc")
+            {
+               continue;
+            }
+
+            int counter = 0;
+            std::ifstream("data/counter.txt") >> counter;
+            std::ofstream("data/counter.txt", std::ios::trunc) << counter + 1;
+            std::cerr << "seen " << counter << "\n";
+         }
+      }
+      catch (const SessionEnded&)
+      {
+      }
+      return 0;
+   }
+
+#ifdef __linux__
+   // Кожен запуск у тому самому слоті починає з вихідних даних, а не з
+   // того, що зберегла попередня сесія.
+   void everyLaunchStartsFromSourceData()
+   {
+      const std::string directory = check::freshDirectory("replay-test-reset");
+      const std::string data = directory + "source";
+      std::filesystem::create_directories(data);
+      std::ofstream(data + "/counter.txt") << 0;
+      std::ofstream(directory + "session.txt")
+         << "# tours-session 1\n0 inc\n0 inc\n";
+
+      ReplayOptions options;
+      options.sessions = {directory + "session.txt"};
+      options.parallel = 1;
+      options.repeat = 3;
+      options.speed = 0.0;
+      options.directory = directory + "slots";
+      options.dataDirectory = data;
+
+      std::ostringstream report;
+      CHECK(SessionReplay(options).run(report) == 0);
+      CHECK(report.str().find("\"consumed\":2") != std::string::npos);
+
+      std::ifstream log(options.directory + "/0/stderr.log");
+      std::ostringstream seen;
+      seen << log.rdbuf();
+      CHECK(seen.str() == "seen 0\nseen 1\nseen 0\nseen 1\nseen 0\nseen 1\n");
+
+      int source = -1;
+      std::ifstream(data + "/counter.txt") >> source;
+      CHECK(source == 0);
+   }
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+   if (argc >= 3 && std::string(argv[1]) == "--play")
+   {
+      return play(argv[2]);
+   }
+
+#ifdef __linux__
+   everyLaunchStartsFromSourceData();
+#endif
+   return check::result();
+}
@@ -0,0 +1,118 @@
+// SlotMapTest.cpp
+
+#include "../SlotMap.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+   void erasedIdIsNotReissued()
+   {
+      SlotMap<int> map;
+      const SlotId first = map.insert(1);
+      const SlotId second = map.insert(2);
+
+      CHECK(map.erase(first));
+      CHECK(!map.contains(first));
+      CHECK(!map.erase(first));
+
+      const SlotId reused = map.insert(3);
+      CHECK(SlotMap<int>::indexOf(reused) == SlotMap<int>::indexOf(first));
+      CHECK(reused != first);
+      CHECK(map.find(first) == nullptr);
+      CHECK(*map.find(reused) == 3);
+      CHECK(*map.find(second) == 2);
+   }
+
+   void eraseKeepsOtherIdsValid()
+   {
+      SlotMap<int> map;
+      std::vector<SlotId> ids;
+      for (int i = 0; i < 10; ++i)
+      {
+         ids.push_back(map.insert(i));
+      }
+
+      CHECK(map.erase(ids[0]));
+      CHECK(map.erase(ids[5]));
+      CHECK(map.size() == 8);
+
+      for (int i = 0; i < 10; ++i)
+      {
+         if (i != 0 && i != 5)
+         {
+            CHECK(map.find(ids[i]) != nullptr && *map.find(ids[i]) == i);
+         }
+      }
+   }
+
+   void sortKeepsIds()
+   {
+      SlotMap<int> map;
+      const SlotId a = map.insert(30);
+      const SlotId b = map.insert(10);
+      const SlotId c = map.insert(20);
+
+      map.sort([](int x, int y) { return x < y; });
+
+      CHECK(map.values()[0] == 10);
+      CHECK(map.values()[1] == 20);
+      CHECK(map.values()[2] == 30);
+      CHECK(*map.find(a) == 30);
+      CHECK(*map.find(b) == 10);
+      CHECK(*map.find(c) == 20);
+      CHECK(map.idAt(0) == b);
+   }
+
+   // Відновлення після перезапуску: живі елементи через insertAt, вільні
+   // слоти через reserveAt.
+   void restoredVacantSlotsKeepGeneration()
+   {
+      SlotMap<int> original;
+      const SlotId kept = original.insert(1);
+      const SlotId removed = original.insert(2);
+      const SlotId tail = original.insert(3);
+      original.erase(removed);
+      original.erase(tail);
+
+      SlotMap<int> restored;
+      CHECK(restored.insertAt(kept, 1));
+      for (const SlotId vacant : original.vacantIds())
+      {
+         CHECK(restored.reserveAt(vacant));
+      }
+
+      const SlotId first = restored.insert(4);
+      const SlotId second = restored.insert(5);
+      const SlotId third = restored.insert(6);
+
+      for (const SlotId id : {first, second, third})
+      {
+         CHECK(id != kept && id != removed && id != tail);
+      }
+      CHECK(*restored.find(kept) == 1);
+   }
+
+   void insertAtRejectsOccupiedSlot()
+   {
+      SlotMap<int> map;
+      const SlotId id = map.insert(1);
+
+      CHECK(!map.insertAt(id, 2));
+      CHECK(!map.reserveAt(id));
+      CHECK(!map.insertAt(SlotMap<int>::invalidId, 3));
+      CHECK(*map.find(id) == 1);
+   }
+}
+
+int main()
+{
+   erasedIdIsNotReissued();
+   eraseKeepsOtherIdsValid();
+   sortKeepsIds();
+   restoredVacantSlotsKeepGeneration();
+   insertAtRejectsOccupiedSlot();
+   return check::result();
+}
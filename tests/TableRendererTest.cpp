@@ -0,0 +1,66 @@
+// TableRendererTest.cpp
+
+#include "../TableRenderer.h"
+#include "Check.h"
+
+#include <string>
+
+namespace
+{
+   TableRenderer makeTable()
+   {
+      TableRenderer table({{"Місто"}, {"Ціна", TableRenderer::Align::Right}});
+      table.beginRow();
+      table.addCell("Київ");
+      table.addCell("100");
+      table.beginRow();
+      table.addCell("Lviv-Old-Town");
+      table.addCell("2500");
+      return table;
+   }
+
+   std::size_t width(const std::string& text)
+   {
+      return TableRenderer::displayWidth(text.data(), text.size());
+   }
+
+   void widthCountsCharactersNotBytes()
+   {
+      CHECK(width("Київ") == 4);
+      CHECK(width("Lviv") == 4);
+      CHECK(width("") == 0);
+   }
+
+   // Кирилиця вирівнюється за позиціями термінала, а не за байтами.
+   void columnsAlignAcrossScripts()
+   {
+      std::string buffer;
+      makeTable().render(buffer);
+
+      CHECK(buffer ==
+         "Місто         | Ціна\n"
+         "--------------+-----\n"
+         "Київ          |  100\n"
+         "Lviv-Old-Town | 2500\n");
+   }
+
+   // Ширина сторінки залежить лише від її рядків.
+   void pageUsesOnlyItsRows()
+   {
+      std::string buffer;
+      makeTable().render(buffer, 0, 1);
+
+      CHECK(buffer ==
+         "Місто | Ціна\n"
+         "------+-----\n"
+         "Київ  |  100\n");
+   }
+}
+
+int main()
+{
+   widthCountsCharactersNotBytes();
+   columnsAlignAcrossScripts();
+   pageUsesOnlyItsRows();
+   return check::result();
+}
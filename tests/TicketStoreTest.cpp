@@ -0,0 +1,106 @@
+// TicketStoreTest.cpp
+
+#include "../SlotMap.h"
+#include "../TicketStore.h"
+#include "Check.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   TicketRecord makeRecord(const std::string& username, SlotId tourId)
+   {
+      Ticket ticket;
+      ticket.username = username;
+      ticket.tourId = tourId;
+      ticket.price = 100.0;
+      return TicketStore::makeRecord(ticket);
+   }
+
+   void writeFile(const std::string& path, const std::string& text)
+   {
+      std::ofstream(path, std::ios::trunc) << text;
+   }
+
+   // Кожен наявний квиток поглинає лише один однаковий запис імпорту.
+   void dropKnownKeepsRepeatedTickets()
+   {
+      TicketStore store;
+      const std::vector<TicketRecord> existing{
+         makeRecord("bob", 1), makeRecord("eve", 2)};
+      store.add(existing.data(), existing.size());
+
+      std::vector<TicketRecord> imported{makeRecord("bob", 1),
+         makeRecord("bob", 1), makeRecord("eve", 3), makeRecord("dan", 1)};
+
+      CHECK(store.dropKnown(imported) == 1);
+      CHECK(imported.size() == 3);
+      CHECK(TicketStore::usernameOf(imported[0]) == "bob");
+      CHECK(imported[1].tourId == 3);
+      CHECK(TicketStore::usernameOf(imported[2]) == "dan");
+   }
+
+   // Скасування знімає останній активний квиток користувача на тур.
+   void cancellationReleasesSeats()
+   {
+      TicketStore store;
+      TicketRecord cancellation = makeRecord("bob", 1);
+      cancellation.flags = ticketCancellation;
+
+      const std::vector<TicketRecord> records{
+         makeRecord("bob", 1), makeRecord("bob", 1), cancellation};
+      store.add(records.data(), records.size());
+
+      CHECK(store.seatsSold(1) == 1);
+      CHECK(store.forUser("bob").size() == 1);
+      CHECK(store.findActive("bob", 1).has_value());
+   }
+
+   void importReadsBothFormats()
+   {
+      const std::string path =
+         check::freshDirectory("tickets-test-import") + "tickets.txt";
+      writeFile(path, "username,tourId,country,city,departureDate,returnDate,price\n"
+         "bob,4,Poland,Warsaw,2025-01-01,2025-01-05,100\n"
+         "eve,Poland,Krakow,2025-01-01,2025-01-05,200\r\n");
+
+      const auto resolver = [](const std::string&, const std::string& city,
+         const std::string&, const std::string&)
+      {
+         return city == "Krakow" ? SlotId{7} : SlotMap<int>::invalidId;
+      };
+
+      Result<std::vector<TicketRecord>> imported =
+         TicketStore::importText(path, resolver);
+      CHECK(imported.ok());
+      CHECK(imported.value().size() == 2);
+      CHECK(imported.value()[0].tourId == 4);
+      CHECK(imported.value()[1].tourId == 7);
+      CHECK(imported.value()[1].price == 200.0);
+   }
+
+   // Задовге ім'я не обрізається мовчки до чужого імені.
+   void importRejectsLongUsername()
+   {
+      const std::string path =
+         check::freshDirectory("tickets-test-long") + "tickets.txt";
+      const std::string name(TicketStore::maxUsernameLength + 1, 'a');
+      writeFile(path, name + ",4,Poland,Warsaw,2025-01-01,2025-01-05,100\n");
+
+      Result<std::vector<TicketRecord>> imported =
+         TicketStore::importText(path, nullptr);
+      CHECK(!imported.ok());
+      CHECK(imported.error().code == ErrorCode::InvalidArgument);
+   }
+}
+
+int main()
+{
+   dropKnownKeepsRepeatedTickets();
+   cancellationReleasesSeats();
+   importReadsBothFormats();
+   importRejectsLongUsername();
+   return check::result();
+}
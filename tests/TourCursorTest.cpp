@@ -0,0 +1,94 @@
+// TourCursorTest.cpp
+
+#include "../TourManager.h"
+#include "Check.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   /// \brief Створює каталог з count турів; кожен третій — у Кракові.
+   std::string writeCatalog(const std::string& name, int count)
+   {
+      const std::string path = check::freshDirectory(name) + "tours.csv";
+      std::ofstream file(path, std::ios::trunc);
+      file << "type,id,capacity,sold,data\n";
+      for (int i = 0; i < count; ++i)
+      {
+         file << "city," << i << ",2,0,Poland,"
+              << (i % 3 == 0 ? "Krakow" : "Warsaw")
+              << ",Hotel,Bus,2025-01-01,2025-01-05,3*,Breakfast,None,"
+              << 100 + i << '\n';
+      }
+      return path;
+   }
+
+   // Сторінки йдуть у порядку каталогу й разом дають весь результат.
+   void pagesCoverResultInOrder()
+   {
+      const std::string path = writeCatalog("cursor-test-pages", 30);
+      TourManager manager(path, path + ".bin", path + ".log");
+      manager.load();
+
+      const std::vector<TourId> all =
+         manager.findTours(TourQuery::byCity("Warsaw"));
+      CHECK(all.size() == 20);
+
+      TourCursor cursor = manager.openCursor(TourQuery::byCity("Warsaw"), 8);
+      CHECK(cursor.pageNumber() == 0);
+
+      std::vector<TourId> seen;
+      std::vector<std::size_t> sizes;
+      while (cursor.hasNext())
+      {
+         const std::vector<TourId>& page = cursor.nextPage();
+         sizes.push_back(page.size());
+         seen.insert(seen.end(), page.begin(), page.end());
+      }
+
+      CHECK(seen == all);
+      CHECK((sizes == std::vector<std::size_t>{8, 8, 4}));
+      CHECK(cursor.pageNumber() == 3);
+
+      CHECK(cursor.hasPrevious());
+      const std::vector<TourId> second = cursor.previousPage();
+      CHECK(cursor.pageNumber() == 2);
+      CHECK((second == std::vector<TourId>(all.begin() + 8, all.begin() + 16)));
+   }
+
+   // Зміни після відкриття курсора не зсувають його сторінок.
+   void pagesIgnoreLaterChanges()
+   {
+      const std::string path = writeCatalog("cursor-test-snapshot", 12);
+      TourManager manager(path, path + ".bin", path + ".log");
+      manager.load();
+
+      TourCursor cursor = manager.openCursor(TourQuery::all(), 5);
+      const std::vector<TourId> first = cursor.nextPage();
+
+      CHECK(manager.removeTour(first[0]).ok());
+      CHECK(manager.removeTour(7).ok());
+
+      std::vector<TourId> rest;
+      while (cursor.hasNext())
+      {
+         const std::vector<TourId>& page = cursor.nextPage();
+         rest.insert(rest.end(), page.begin(), page.end());
+      }
+
+      CHECK(rest.size() == 7);
+      const std::vector<TourId> middle = cursor.previousPage();
+      CHECK(middle.size() == 5 && middle[2] == 7);
+      CHECK(cursor.snapshot().find(7) != nullptr);
+      CHECK(manager.size() == 10);
+   }
+}
+
+int main()
+{
+   pagesCoverResultInOrder();
+   pagesIgnoreLaterChanges();
+   return check::result();
+}
@@ -0,0 +1,314 @@
+// TourManagerTest.cpp
+
+#include "../TourManager.h"
+#include "Check.h"
+
+#include <fstream>
+#include <string>
+
+namespace
+{
+   const char* const header = "type,id,capacity,sold,data\n";
+
+   void writeFile(const std::string& path, const std::string& text)
+   {
+      std::ofstream(path, std::ios::trunc) << text;
+   }
+
+   std::string cityRow(const std::string& id, const std::string& city)
+   {
+      return "city," + id + ",2,0,Poland," + city
+         + ",Hotel,Bus,2025-01-01,2025-01-05,3*,Breakfast,None,100\n";
+   }
+
+   TourPatch parisPatch()
+   {
+      TourPatch patch;
+      patch.country = "France";
+      patch.city = "Paris";
+      patch.departureDate = "2025-02-01";
+      patch.returnDate = "2025-02-05";
+      patch.hotelLevel = "4*";
+      patch.price = 500.0;
+      return patch;
+   }
+
+   struct Files
+   {
+      std::string tours;
+      std::string tickets;
+      std::string waitlist;
+   };
+
+   Files freshFiles(const std::string& name)
+   {
+      const std::string directory = check::freshDirectory(name);
+      return Files{directory + "tours.csv", directory + "tickets.bin",
+         directory + "waitlist.log"};
+   }
+
+   // Видалений тур не повинен віддати свій ID новому туру після
+   // перезапуску, інакше той успадкує чужі квитки.
+   void deletedIdSurvivesRestart()
+   {
+      const Files files = freshFiles("tours-test-ids");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw")
+         + cityRow("1", "Krakow") + cityRow("2", "Gdansk"));
+
+      {
+         TourManager manager(files.tours, files.tickets, files.waitlist);
+         manager.load();
+         CHECK(manager.bookTour("bob", 1).ok());
+         CHECK(manager.removeTour(1).ok());
+         CHECK(manager.removeTour(2).ok());
+         manager.save();
+      }
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      for (int i = 0; i < 3; ++i)
+      {
+         Result<TourId> created =
+            manager.createTour(TourKind::City, parisPatch());
+         CHECK(created.ok());
+         CHECK(created.value() != 1 && created.value() != 2);
+         CHECK(manager.tourTickets(created.value()).empty());
+      }
+   }
+
+   // Пропуски в номерах (файли без рядків free) теж не повторюють ID.
+   void gapsInOldFilesAreNotReused()
+   {
+      const Files files = freshFiles("tours-test-gaps");
+      writeFile(files.tours,
+         std::string(header) + cityRow("0", "Warsaw") + cityRow("3", "Lodz"));
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      for (int i = 0; i < 3; ++i)
+      {
+         Result<TourId> created =
+            manager.createTour(TourKind::City, parisPatch());
+         CHECK(created.ok());
+         CHECK(created.value() != 1 && created.value() != 2);
+      }
+   }
+
+   // Пошкоджений ID не повинен змушувати виділяти гігабайти під слоти.
+   void corruptIdIsRejected()
+   {
+      const Files files = freshFiles("tours-test-corrupt");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw")
+         + cityRow("4294967294", "Lodz"));
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      CHECK(manager.size() == 2);
+      CHECK(!manager.getTour(4294967294u).ok());
+   }
+
+   // Заміна на основі застарілого прочитання не повинна стерти чужу зміну.
+   void staleReplaceIsRejected()
+   {
+      const Files files = freshFiles("tours-test-replace");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw"));
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      const std::shared_ptr<const Tour> original = manager.getTour(0).value();
+      std::shared_ptr<Tour> edited = original->clone();
+
+      TourPatch price;
+      price.price = 777.0;
+      CHECK(manager.updateTour(0, price).ok());
+
+      Result<void> replaced = manager.replaceTour(0, edited, original);
+      CHECK(!replaced.ok() && replaced.error().code == ErrorCode::Conflict);
+      CHECK(manager.getTour(0).value()->getPrice() == 777.0);
+
+      const std::shared_ptr<const Tour> latest = manager.getTour(0).value();
+      CHECK(manager.replaceTour(0, latest->clone(), latest).ok());
+   }
+
+   // Квитки, заброньовані після останнього save(), займають місця і після
+   // перезапуску, хоча колонка sold про них не знає.
+   void soldSeatsComeFromTickets()
+   {
+      const Files files = freshFiles("tours-test-sold");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw"));
+
+      {
+         TourManager manager(files.tours, files.tickets, files.waitlist);
+         manager.load();
+         CHECK(manager.bookTour("bob", 0).ok());
+         CHECK(manager.bookTour("eve", 0).ok());
+      }
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      CHECK(manager.getSeats(0).value().available == 0);
+      CHECK(!manager.bookTour("dan", 0).ok());
+
+      CHECK(manager.cancelBooking("bob", 0).ok());
+      CHECK(manager.getSeats(0).value().available == 1);
+   }
+
+   // Імпортовані квитки займають місця, навіть понад місткість.
+   void importTakesSeats()
+   {
+      const Files files = freshFiles("tours-test-import-seats");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw"));
+
+      const std::string text = files.tours + ".txt";
+      writeFile(text,
+         "bob,0,Poland,Warsaw,2025-01-01,2025-01-05,100\n"
+         "eve,0,Poland,Warsaw,2025-01-01,2025-01-05,100\n"
+         "dan,0,Poland,Warsaw,2025-01-01,2025-01-05,100\n");
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      CHECK(manager.importTickets(text).ok());
+      CHECK(manager.getSeats(0).value().available == 0);
+      CHECK(!manager.bookTour("ann", 0).ok());
+
+      // Одне скасування покриває лише перепродане місце.
+      CHECK(manager.cancelBooking("bob", 0).ok());
+      CHECK(!manager.bookTour("ann", 0).ok());
+   }
+
+   // Повторний імпорт того самого файлу не додає квитків і не займає місць.
+   void reimportIsIgnored()
+   {
+      const Files files = freshFiles("tours-test-reimport");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw"));
+
+      const std::string text = files.tours + ".txt";
+      writeFile(text, "bob,0,Poland,Warsaw,2025-01-01,2025-01-05,100\n");
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      CHECK(manager.importTickets(text).value() == 1);
+      CHECK(manager.importTickets(text).value() == 0);
+      CHECK(manager.tourTickets(0).size() == 1);
+      CHECK(manager.getSeats(0).value().available == 1);
+   }
+
+   // Звільнені місця отримує перша заявка черги, а не наступний покупець.
+   void cancellationPromotesWaitlist()
+   {
+      const Files files = freshFiles("tours-test-waitlist");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw"));
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      CHECK(manager.bookTour("bob", 0).ok());
+      CHECK(manager.bookTour("eve", 0).ok());
+      CHECK(manager.joinWaitlist("dan", 0).ok());
+      CHECK(manager.joinWaitlist("ann", 0, 1, 5).ok());
+      CHECK(manager.waitlistPosition("ann", 0) == 1);
+
+      CHECK(manager.cancelBooking("bob", 0).ok());
+      CHECK(manager.userTickets("ann").size() == 1);
+      CHECK(manager.userTickets("dan").empty());
+      CHECK(manager.waitlistPosition("ann", 0) == 0);
+      CHECK(manager.waitlistPosition("dan", 0) == 1);
+      CHECK(!manager.bookTour("kim", 0).ok());
+
+      // Черга та квитки переживають перезапуск.
+      TourManager restarted(files.tours, files.tickets, files.waitlist);
+      restarted.load();
+      CHECK(restarted.waitlistPosition("dan", 0) == 1);
+      CHECK(restarted.getSeats(0).value().available == 0);
+   }
+
+   // Група бронюється повністю або не бронюється зовсім.
+   void groupBookingIsAllOrNothing()
+   {
+      const Files files = freshFiles("tours-test-group");
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw")
+         + cityRow("1", "Krakow"));
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+
+      Result<std::vector<Ticket>> tooMany =
+         manager.bookGroup("bob", {{0, 1}, {1, 2}, {1, 1}});
+      CHECK(!tooMany.ok() && tooMany.error().code == ErrorCode::SoldOut);
+      CHECK(manager.getSeats(0).value().available == 2);
+      CHECK(manager.getSeats(1).value().available == 2);
+      CHECK(manager.userTickets("bob").empty());
+
+      CHECK(!manager.bookGroup("bob", {{0, 1}, {9, 1}}).ok());
+      CHECK(manager.getSeats(0).value().available == 2);
+
+      Result<std::vector<Ticket>> booked =
+         manager.bookGroup("bob", {{0, 1}, {1, 1}, {0, 1}});
+      CHECK(booked.ok() && booked.value().size() == 2);
+      CHECK(manager.getSeats(0).value().available == 0);
+      CHECK(manager.getSeats(1).value().available == 1);
+      CHECK(manager.seatsSold(0) == 2);
+   }
+
+   // Звіт рахує кожен тур поточного знімка і лише довгі рядки як виділення.
+   void memoryReportCountsTours()
+   {
+      const Files files = freshFiles("tours-test-memory");
+      const std::string longCity(100, 'w');
+      writeFile(files.tours, std::string(header) + cityRow("0", "Warsaw")
+         + cityRow("1", longCity) + cityRow("2", "Gdansk"));
+
+      TourManager manager(files.tours, files.tickets, files.waitlist);
+      manager.load();
+      CHECK(manager.removeTour(2).ok());
+
+      const MemoryReport report = manager.memoryReport();
+      CHECK(report.types.size() == 1);
+      CHECK(report.types[0].name == "CityTour");
+      CHECK(report.types[0].objects == 2);
+
+      const FieldMemory* city = nullptr;
+      for (const FieldMemory& field : report.types[0].fields)
+      {
+         if (field.name == "city")
+         {
+            city = &field;
+         }
+      }
+      CHECK(city != nullptr);
+      CHECK(city->values == 2);
+      CHECK(city->payloadBytes == longCity.size() + 6);
+      CHECK(city->heapBlocks == 1);
+      CHECK(city->heapBytes >= longCity.size() + 1);
+
+      std::uint64_t sum = 0;
+      for (const MemoryComponent& component : report.components)
+      {
+         sum += component.bytes;
+      }
+      CHECK(report.totalBytes() == sum);
+      CHECK(MemoryReport::stringHeapBytes("Lodz") == 0);
+   }
+}
+
+int main()
+{
+   deletedIdSurvivesRestart();
+   gapsInOldFilesAreNotReused();
+   corruptIdIsRejected();
+   staleReplaceIsRejected();
+   soldSeatsComeFromTickets();
+   importTakesSeats();
+   reimportIsIgnored();
+   cancellationPromotesWaitlist();
+   groupBookingIsAllOrNothing();
+   memoryReportCountsTours();
+   return check::result();
+}
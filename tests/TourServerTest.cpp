@@ -0,0 +1,194 @@
+// TourServerTest.cpp
+
+#include "../TourServer.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+   struct Fixture
+   {
+      std::string   directory = check::freshDirectory("server-test");
+      std::string   socketPath = directory + "server.sock";
+      AuthManager   auth;
+      TourManager   manager;
+      ServerOptions options;
+
+      Fixture()
+         : auth(writeFile(directory + "users.txt", "bob:pw\n"),
+              AuthOptions{1000}),
+           manager(writeFile(directory + "tours.csv",
+              "type,id,capacity,sold,data\n"
+              "city,0,2,0,Poland,Warsaw,Hotel,Bus,2025-01-01,2025-01-05,"
+              "3*,Breakfast,None,100\n"),
+              directory + "tickets.bin", directory + "waitlist.log")
+      {
+         manager.load();
+         options.unixPath = socketPath;
+         options.workers = 2;
+         options.maxLineLength = 1024;
+         options.maxPendingRequests = 4;
+      }
+
+      static std::string writeFile(const std::string& path,
+         const std::string& text)
+      {
+         std::ofstream(path, std::ios::trunc) << text;
+         return path;
+      }
+   };
+
+   int connectTo(const std::string& path)
+   {
+      const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      sockaddr_un address{};
+      address.sun_family = AF_UNIX;
+      path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+      for (int attempt = 0; attempt < 200; ++attempt)
+      {
+         if (::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) == 0)
+         {
+            return fd;
+         }
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+
+      ::close(fd);
+      return -1;
+   }
+
+   void sendAll(int fd, const std::string& data)
+   {
+      std::size_t sent = 0;
+      while (sent < data.size())
+      {
+         const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent,
+            MSG_NOSIGNAL);
+         if (n <= 0)
+         {
+            return;
+         }
+         sent += static_cast<std::size_t>(n);
+      }
+   }
+
+   /// \brief Читає відповіді, доки не отримає lines рядків або кінець потоку.
+   std::string receiveLines(int fd, std::size_t lines)
+   {
+      std::string text;
+      char chunk[4096];
+      std::size_t seen = 0;
+
+      while (seen < lines)
+      {
+         const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+         if (n <= 0)
+         {
+            break;
+         }
+         for (ssize_t i = 0; i < n; ++i)
+         {
+            seen += chunk[i] == '\n' ? 1 : 0;
+         }
+         text.append(chunk, static_cast<std::size_t>(n));
+      }
+
+      return text;
+   }
+
+   std::size_t countOf(const std::string& text, const std::string& part)
+   {
+      std::size_t count = 0;
+      for (std::size_t at = text.find(part); at != std::string::npos;
+           at = text.find(part, at + 1))
+      {
+         ++count;
+      }
+      return count;
+   }
+
+   // Команд набагато більше, ніж ліміт черги: читання призупиняється й
+   // відновлюється, і кожна команда отримує відповідь по порядку.
+   void pipelinedCommandsAllAnswered(const std::string& path)
+   {
+      const int fd = connectTo(path);
+      CHECK(fd >= 0);
+
+      std::string script = "login bob pw\n";
+      for (int i = 0; i < 500; ++i)
+      {
+         script += "get 0\n";
+      }
+      sendAll(fd, script);
+
+      const std::string replies = receiveLines(fd, 501);
+      CHECK(countOf(replies, "\n") == 501);
+      CHECK(countOf(replies, "\"op\":\"get\",\"ok\":true") == 500);
+      CHECK(replies.rfind("{\"n\":501,", std::string::npos) != std::string::npos);
+      ::close(fd);
+   }
+
+   // Задовгий рядок закриває сесію, навіть якщо він закінчується
+   // переносом у тому самому блоці даних.
+   void longLineClosesSession(const std::string& path, bool terminated)
+   {
+      const int fd = connectTo(path);
+      CHECK(fd >= 0);
+
+      sendAll(fd, std::string(4000, 'x') + (terminated ? "\nget 0\n" : ""));
+
+      const std::string replies = receiveLines(fd, 10);
+      CHECK(countOf(replies, "\n") == 1);
+      CHECK(countOf(replies, "\"error\":\"invalid_argument\"") == 1);
+      ::close(fd);
+   }
+
+   // Помилка задовгого рядка приходить після відповідей на команди,
+   // надіслані перед ним у тому самому блоці.
+   void longLineErrorComesLast(const std::string& path)
+   {
+      const int fd = connectTo(path);
+      CHECK(fd >= 0);
+
+      sendAll(fd, "login bob pw\nget 0\nget 0\n" + std::string(4000, 'x'));
+
+      const std::string replies = receiveLines(fd, 10);
+      CHECK(countOf(replies, "\n") == 4);
+      CHECK(countOf(replies, "\"op\":\"get\",\"ok\":true") == 2);
+      CHECK(replies.find("\"error\":\"invalid_argument\"")
+         > replies.rfind("\"op\":\"get\""));
+      ::close(fd);
+   }
+#endif
+}
+
+int main()
+{
+#ifdef __linux__
+   Fixture fixture;
+   TourServer server(fixture.manager, fixture.auth, fixture.options);
+   std::thread loop([&server] { server.run(); });
+
+   pipelinedCommandsAllAnswered(fixture.socketPath);
+   longLineClosesSession(fixture.socketPath, false);
+   longLineClosesSession(fixture.socketPath, true);
+   longLineErrorComesLast(fixture.socketPath);
+
+   server.stop();
+   loop.join();
+#endif
+   return check::result();
+}
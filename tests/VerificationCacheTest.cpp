@@ -0,0 +1,50 @@
+// VerificationCacheTest.cpp
+
+#include "../VerificationCache.h"
+#include "Check.h"
+
+#include <chrono>
+
+namespace
+{
+   // Зміна поля пароля робить запам'ятований токен недійсним.
+   void changedPasswordMisses()
+   {
+      VerificationCache cache;
+      cache.remember("token", "hash-1");
+
+      CHECK(cache.contains("token", "hash-1"));
+      CHECK(!cache.contains("token", "hash-2"));
+      CHECK(!cache.contains("other", "hash-1"));
+   }
+
+   // Найдавніше використаний токен витісняється першим.
+   void leastRecentlyUsedIsEvicted()
+   {
+      VerificationCache cache(2);
+      cache.remember("a", "x");
+      cache.remember("b", "x");
+      CHECK(cache.contains("a", "x"));
+
+      cache.remember("c", "x");
+      CHECK(cache.size() == 2);
+      CHECK(cache.contains("a", "x"));
+      CHECK(!cache.contains("b", "x"));
+      CHECK(cache.contains("c", "x"));
+   }
+
+   void expiredTokenMisses()
+   {
+      VerificationCache cache(4, std::chrono::seconds(0));
+      cache.remember("a", "x");
+      CHECK(!cache.contains("a", "x"));
+   }
+}
+
+int main()
+{
+   changedPasswordMisses();
+   leastRecentlyUsedIsEvicted();
+   expiredTokenMisses();
+   return check::result();
+}
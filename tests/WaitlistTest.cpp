@@ -0,0 +1,91 @@
+// WaitlistTest.cpp
+
+#include "../Waitlist.h"
+#include "Check.h"
+
+#include <string>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+   // Більший пріоритет обслуговується раніше, рівні — за надходженням.
+   void priorityThenArrival()
+   {
+      Waitlist waitlist(check::freshDirectory("waitlist-test-order") + "log");
+      CHECK(waitlist.load().ok());
+
+      CHECK(waitlist.join("bob", 1, 1, 0).ok());
+      CHECK(waitlist.join("eve", 1, 1, 5).ok());
+      CHECK(waitlist.join("dan", 1, 1, 0).ok());
+      CHECK(!waitlist.join("bob", 1, 2, 9).ok());
+
+      CHECK(waitlist.front(1)->username == "eve");
+      CHECK(waitlist.position("bob", 1) == 2);
+      CHECK(waitlist.position("dan", 1) == 3);
+      CHECK(waitlist.position("ann", 1) == 0);
+   }
+
+   // Черги відновлюються з журналу в тому ж порядку.
+   void queueSurvivesRestart()
+   {
+      const std::string path =
+         check::freshDirectory("waitlist-test-restart") + "log";
+
+      {
+         Waitlist waitlist(path);
+         CHECK(waitlist.load().ok());
+         CHECK(waitlist.join("bob", 1, 1, 0).ok());
+         CHECK(waitlist.join("eve", 1, 2, 0).ok());
+         CHECK(waitlist.join("dan", 1, 1, 0).ok());
+         CHECK(waitlist.leave("bob", 1).ok());
+      }
+
+      Waitlist waitlist(path);
+      CHECK(waitlist.load().value() == 2);
+      CHECK(waitlist.front(1)->username == "eve");
+      CHECK(waitlist.front(1)->seats == 2);
+      CHECK(waitlist.position("dan", 1) == 2);
+      CHECK(!waitlist.leave("bob", 1).ok());
+   }
+
+#ifndef _WIN32
+   // Якщо журнал не прийняв запис, заявка не зникає з пам'яті.
+   void failedLeaveKeepsEntry()
+   {
+      const std::string path =
+         check::freshDirectory("waitlist-test-leave") + "log";
+
+      Waitlist waitlist(path);
+      CHECK(waitlist.load().ok());
+      CHECK(waitlist.join("bob", 1, 1, 0).ok());
+
+      std::signal(SIGXFSZ, SIG_IGN);
+      rlimit previous{};
+      ::getrlimit(RLIMIT_FSIZE, &previous);
+      rlimit limited = previous;
+      limited.rlim_cur = 0;
+      ::setrlimit(RLIMIT_FSIZE, &limited);
+
+      const Result<void> left = waitlist.leave("bob", 1);
+
+      ::setrlimit(RLIMIT_FSIZE, &previous);
+
+      CHECK(!left.ok() && left.error().code == ErrorCode::IoError);
+      CHECK(waitlist.position("bob", 1) == 1);
+   }
+#endif
+}
+
+int main()
+{
+   priorityThenArrival();
+   queueSurvivesRestart();
+#ifndef _WIN32
+   failedLeaveKeepsEntry();
+#endif
+   return check::result();
+}